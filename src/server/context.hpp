@@ -20,6 +20,7 @@
 // STL.
 #include <vector>
 #include <string>
+#include <memory>
 
 // SFML system/windowing library.
 #include <SFML/Graphics/CircleShape.hpp>
@@ -37,6 +38,7 @@
 // Application.
 #include "cmd.hpp"
 #include "window.hpp"
+#include "data/snapshot.hpp"
 
 
 // #############################################################################
@@ -69,6 +71,12 @@ namespace cat {
             //sf::Clock clock;              //<! The main application clock.
             cat::window _window;            //<! The main application window.
 
+            //! Monitored sensor occupancy, filled by the data path.
+            std::unique_ptr<cat::hitmap> _hitmap;
+
+            //! Offscreen monitoring images exporter (none if not running).
+            std::unique_ptr<cat::snapshot> _snapshot;
+
             //! SFML network server.
             sf::TcpListener server;         //<! Application server.
 
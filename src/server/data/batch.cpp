@@ -0,0 +1,275 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel batch data object                      --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"batch.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "batch.hpp"
+#include "caf.hpp"
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::batch::batch(const std::size_t& capacity, const int& sensor) :
+    _sensor(sensor),
+    _analog(false)
+{
+    /*! Ctor. Reserves room for \c capacity pixels from the \c sensor. */
+    reserve(capacity);
+}
+
+//______________________________________________________________________________
+cat::batch::batch(const cat::batch& b) :
+    _sensor(b._sensor),
+    _analog(b._analog),
+    _col(b._col),
+    _row(b._row),
+    _tsp(b._tsp),
+    _chg(b._chg)
+{
+    /*! Copy ctor. */
+}
+
+//______________________________________________________________________________
+cat::batch::~batch()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::ostream& operator<<(std::ostream& os, const cat::batch& b)
+{
+    // Build {sensor: size px, [tsp first, tsp last]} like string.
+    os << "{" << b.sensor() << ": " << b.size() << " px";
+    if (!b.empty()) {
+        os << ", ["
+           << cat::caf::fcol(C_PX_TSP) << b.tsp()[0] << cat::caf::rst()
+           << ", "
+           << cat::caf::fcol(C_PX_TSP) << b.tsp()[b.size() - 1] << cat::caf::rst()
+           << "]";
+    }
+    os << "}";
+
+    // Return.
+    return os;
+}
+
+//______________________________________________________________________________
+cat::batch& cat::batch::operator=(const cat::batch& b)
+{
+    /*! Copy operator. */
+    _sensor = b._sensor;
+    _analog = b._analog;
+    _col = b._col;
+    _row = b._row;
+    _tsp = b._tsp;
+    _chg = b._chg;
+
+    // Return.
+    return *this;
+}
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::size_t cat::batch::size() const
+{
+    /*! Returns the number of pixels. */
+    return _col.size();
+}
+
+//______________________________________________________________________________
+bool cat::batch::empty() const
+{
+    /*! Returns true if there are no pixels. */
+    return _col.empty();
+}
+
+//______________________________________________________________________________
+void cat::batch::clear()
+{
+    /*! Removes all the pixels. The storage is kept, so a batch can be reused
+        over and over without reallocating.
+    */
+    _col.clear();
+    _row.clear();
+    _tsp.clear();
+    _chg.clear();
+}
+
+//______________________________________________________________________________
+void cat::batch::reserve(const std::size_t& n)
+{
+    /*! Reserves storage for \c n pixels. */
+    _col.reserve(n);
+    _row.reserve(n);
+    _tsp.reserve(n);
+    if (_analog) _chg.reserve(n);
+}
+
+//______________________________________________________________________________
+void cat::batch::resize(const std::size_t& n)
+{
+    /*! Resizes all the columns to \c n pixels, typically before filling them
+        directly through the columns arrays.
+    */
+    _col.resize(n);
+    _row.resize(n);
+    _tsp.resize(n);
+    if (_analog) _chg.resize(n, 1.0f);
+}
+
+//______________________________________________________________________________
+int cat::batch::sensor() const
+{
+    /*! Returns the originating sensor. */
+    return _sensor;
+}
+
+//______________________________________________________________________________
+void cat::batch::sensor(const int& s)
+{
+    /*! Sets the originating sensor. */
+    _sensor = s;
+}
+
+//______________________________________________________________________________
+bool cat::batch::analog() const
+{
+    /*! Returns true if the pixels carry a charge. */
+    return _analog;
+}
+
+//______________________________________________________________________________
+void cat::batch::analog(const bool& a)
+{
+    /*! Adds the charge column, with all the pixels at unit charge, or drops it
+        when \c a is false.
+    */
+    _analog = a;
+    if (a) _chg.resize(_col.size(), 1.0f);
+    else std::vector<float>().swap(_chg);
+}
+
+//______________________________________________________________________________
+int* cat::batch::col()
+{
+    /*! Returns the columns array. */
+    return _col.data();
+}
+
+//______________________________________________________________________________
+const int* cat::batch::col() const
+{
+    /*! Returns the columns array. */
+    return _col.data();
+}
+
+//______________________________________________________________________________
+int* cat::batch::row()
+{
+    /*! Returns the rows array. */
+    return _row.data();
+}
+
+//______________________________________________________________________________
+const int* cat::batch::row() const
+{
+    /*! Returns the rows array. */
+    return _row.data();
+}
+
+//______________________________________________________________________________
+long* cat::batch::tsp()
+{
+    /*! Returns the timestamps array. */
+    return _tsp.data();
+}
+
+//______________________________________________________________________________
+const long* cat::batch::tsp() const
+{
+    /*! Returns the timestamps array. */
+    return _tsp.data();
+}
+
+//______________________________________________________________________________
+float* cat::batch::charge()
+{
+    /*! Returns the charges array, void for digital batches. */
+    return _analog ? _chg.data() : nullptr;
+}
+
+//______________________________________________________________________________
+const float* cat::batch::charge() const
+{
+    /*! Returns the charges array, void for digital batches. */
+    return _analog ? _chg.data() : nullptr;
+}
+
+//______________________________________________________________________________
+void cat::batch::add(const int& col, const int& row, const long& tsp)
+{
+    /*! Adds a pixel by its values (unit charge, for analog batches). */
+    _col.push_back(col);
+    _row.push_back(row);
+    _tsp.push_back(tsp);
+    if (_analog) _chg.push_back(1.0f);
+}
+
+//______________________________________________________________________________
+void cat::batch::add(const int& col, const int& row, const long& tsp, const float& charge)
+{
+    /*! Adds a charged pixel by its values. The charge is dropped if the batch
+        is digital.
+    */
+    _col.push_back(col);
+    _row.push_back(row);
+    _tsp.push_back(tsp);
+    if (_analog) _chg.push_back(charge);
+}
+
+//______________________________________________________________________________
+void cat::batch::add(const cat::pixel& px)
+{
+    /*! Adds a pixel (unit charge, for analog batches). */
+    add(px.col(), px.row(), px.tsp());
+}
+
+//______________________________________________________________________________
+cat::pixel cat::batch::pixel(const std::size_t& i) const
+{
+    /*! Returns the \c i pixel as a 'pixel' object, without its charge (see
+        'charge'). No range check.
+    */
+    cat::pixel px(_col[i], _row[i]);
+    px.tsp(_tsp[i]);
+    return px;
+}
@@ -0,0 +1,109 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel batch data object                      --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"batch.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'batch' object is a collection of pixels coming from the same sensor,
+// stored column-wise (structure of arrays): one contiguous array for the
+// columns, one for the rows and one for the timestamps. This is the layout
+// bulk stages (decoding, sorting, filtering, clustering) work on, as plain
+// arrays are what loops can be vectorized over. Single 'pixel' objects can
+// still be added or retrieved, for convenience.
+// Batches from analog sensors carry a fourth array with the pixels charge
+// (or raw ToT, before the calibration); digital batches do not allocate it.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef batch_HPP
+#define batch_HPP
+
+// Application units.
+#include "pixel.hpp"
+
+// Standard library
+#include <vector>
+#include <cstddef>
+#include <iostream>
+
+
+//______________________________________________________________________________
+namespace cat { class batch; }
+class cat::batch
+{
+
+public:
+
+	// Special members.
+	batch(const std::size_t& = 0, const int& = 0);	//!< Ctor (capacity, sensor).
+	batch(const batch&);			//!< CCtor.
+	~batch();						//!< Dtor.
+
+	// Operators.
+	batch& operator=(const batch&);
+
+	// Size.
+	std::size_t size() const;		//!< Number of pixels.
+	bool empty() const;				//!< No pixels at all.
+	void clear();					//!< Remove all pixels, keep the storage.
+	void reserve(const std::size_t&);	//!< Reserve storage for pixels.
+	void resize(const std::size_t&);	//!< Resize all the columns.
+
+	// Source.
+	int sensor() const;				//!< Retrieve the originating sensor.
+	void sensor(const int&);		//!< Set the originating sensor.
+	bool analog() const;			//!< Check if the pixels carry a charge.
+	void analog(const bool&);		//!< Add (or drop) the charge column.
+
+	// Columns (direct access for bulk processing).
+	int* col();						//!< Columns array.
+	const int* col() const;			//!< Columns array.
+	int* row();						//!< Rows array.
+	const int* row() const;			//!< Rows array.
+	long* tsp();					//!< Timestamps array.
+	const long* tsp() const;		//!< Timestamps array.
+	float* charge();				//!< Charges array (analog only).
+	const float* charge() const;	//!< Charges array (analog only).
+
+	// Single pixels.
+	void add(const int&, const int&, const long&);	//!< Add a pixel by values.
+	void add(const int&, const int&, const long&, const float&);	//!< Add a charged pixel.
+	void add(const cat::pixel&);	//!< Add a pixel.
+	cat::pixel pixel(const std::size_t&) const;		//!< Retrieve a pixel.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Source sensor.
+	int _sensor;
+	bool _analog;
+
+	// Pixel columns.
+	std::vector<int> _col;		// Pixel matrix x coordinates.
+	std::vector<int> _row;		// Pixel matrix y coordinates.
+	std::vector<long> _tsp;		// Pixel timestamps.
+	std::vector<float> _chg;	// Pixel charges (analog only).
+};
+
+//______________________________________________________________________________
+// Operators overload
+std::ostream& operator<<(std::ostream&, const cat::batch&);
+
+// Overloading check
+#endif
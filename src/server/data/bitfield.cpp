@@ -0,0 +1,152 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Bit-field readout decoder                    --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"bitfield.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "bitfield.hpp"
+
+// Standard library
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::bitfield::bitfield(const field& col, const field& row, const field& tsp) :
+    cat::decoder(),
+    _col(col),
+    _row(row),
+    _tsp(tsp),
+    _roll(static_cast<int>(tsp.bits))
+{
+    /*! Ctor. \c col, \c row and \c tsp give the position of the three fields
+        within the raw word. Columns and rows must fit an int, timestamps a
+        long, and no field can exceed a 64 bit word.
+    */
+    if (col.bits == 0 || col.bits > 31 || row.bits == 0 || row.bits > 31) {
+        throw std::runtime_error{ "bitfield: invalid col/row field width" };
+    }
+    if (tsp.bits == 0 || tsp.bits > 62) {
+        throw std::runtime_error{ "bitfield: invalid tsp field width" };
+    }
+    check(64);
+}
+
+//______________________________________________________________________________
+cat::bitfield::~bitfield()
+{
+    /*! Dtor. Nothing really to do. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::bitfield::check(const unsigned& width) const
+{
+    /* Throws if any field does not fit a \c width bits word. A field must
+       also be narrower than the word, as its mask is built by shifting a W(1)
+       by the field width.
+    */
+    for (const field* f : { &_col, &_row, &_tsp }) {
+        if (f->shift + f->bits > width || f->bits >= width) {
+            throw std::runtime_error{ "bitfield: fields do not fit the word size" };
+        }
+    }
+}
+
+//______________________________________________________________________________
+template <typename W>
+std::size_t cat::bitfield::unpack(const W* words, const std::size_t& n, cat::batch& b)
+{
+    /* Decodes \c n words of type W into the tail of the batch. The first pass
+       is plain shift/mask with loop-invariant masks and no branches, so that
+       it gets vectorized; the timestamps unwrapping is done afterwards.
+    */
+    const std::size_t base = b.size();
+    b.resize(base + n);
+
+    // Fields constants, hoisted out of the loop.
+    const unsigned cs = _col.shift, rs = _row.shift, ts = _tsp.shift;
+    const W cm = (W(1) << _col.bits) - 1;
+    const W rm = (W(1) << _row.bits) - 1;
+    const W tm = (W(1) << _tsp.bits) - 1;
+
+    // Columns pointers, past the pixels already in the batch.
+    int* col = b.col() + base;
+    int* row = b.row() + base;
+    long* tsp = b.tsp() + base;
+
+    // Shift/mask pass.
+    for (std::size_t i = 0; i < n; i++) {
+        const W w = words[i];
+        col[i] = static_cast<int>((w >> cs) & cm);
+        row[i] = static_cast<int>((w >> rs) & rm);
+        tsp[i] = static_cast<long>((w >> ts) & tm);
+    }
+
+    // Rollover pass.
+    _roll.unwrap(tsp, n);
+    return n;
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::size_t cat::bitfield::decode(const uint32_t* words, const std::size_t& n, cat::batch& b)
+{
+    /*! Decodes \c n 32 bit words, appending the pixels to \c b. Returns the
+        number of pixels appended, i.e. \c n.
+    */
+    check(32);
+    return unpack(words, n, b);
+}
+
+//______________________________________________________________________________
+std::size_t cat::bitfield::decode(const uint64_t* words, const std::size_t& n, cat::batch& b)
+{
+    /*! Decodes \c n 64 bit words, appending the pixels to \c b. Returns the
+        number of pixels appended, i.e. \c n.
+    */
+    return unpack(words, n, b);
+}
+
+//______________________________________________________________________________
+void cat::bitfield::reset()
+{
+    /*! Resets the rollover tracking, to be called when the raw stream restarts
+        (e.g. new run, or readout reset).
+    */
+    _roll.reset();
+}
+
+//______________________________________________________________________________
+long cat::bitfield::epoch() const
+{
+    /*! Returns the offset currently added to the raw timestamps. */
+    return _roll.epoch();
+}
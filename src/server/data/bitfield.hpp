@@ -0,0 +1,84 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Bit-field readout decoder                    --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"bitfield.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'bitfield' object is the reference 'decoder': every raw word carries a
+// single pixel, with column, row and timestamp packed as bit fields at fixed
+// positions. Decoding runs in two passes over the buffer: a branch-free
+// shift/mask pass writing straight into the batch columns, which the compiler
+// vectorizes, then a light sequential pass unwrapping the timestamp rollover
+// (the timestamp field is just a few bits wide, and wraps around often).
+// Pixels slightly late across a rollover are recognized and placed before
+// it, as long as they are less than half a rollover period late.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef bitfield_HPP
+#define bitfield_HPP
+
+// Application units.
+#include "decoder.hpp"
+#include "rollover.hpp"
+
+
+//______________________________________________________________________________
+namespace cat { class bitfield; }
+class cat::bitfield : public cat::decoder
+{
+
+public:
+
+	// Bit field position within the word.
+	struct field {
+		unsigned shift;		// Lowest bit position.
+		unsigned bits;		// Field width.
+	};
+
+	// Special members.
+	bitfield(const field&, const field&, const field&);	//!< Ctor (col, row, tsp).
+	~bitfield();				//!< Dtor.
+
+	// Overloaded decoder methods.
+	std::size_t decode(const uint32_t*, const std::size_t&, cat::batch&) override;	//!< Decode 32 bit words.
+	std::size_t decode(const uint64_t*, const std::size_t&, cat::batch&) override;	//!< Decode 64 bit words.
+	void reset() override;		//!< Reset the rollover tracking.
+
+	// Methods.
+	long epoch() const;			//!< Retrieve the current rollover offset.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Layout.
+	field _col;					// Column field.
+	field _row;					// Row field.
+	field _tsp;					// Timestamp field.
+
+	// Rollover tracking.
+	cat::rollover _roll;		// Timestamps unwrapping.
+
+	// Support routines.
+	template <typename W> std::size_t unpack(const W*, const std::size_t&, cat::batch&);
+	void check(const unsigned&) const;
+};
+
+// Overloading check
+#endif
@@ -0,0 +1,289 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Event builder                                --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"builder.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "builder.hpp"
+
+// Standard library
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::builder::builder(const int& sensors, const long& window, const std::size_t& depth) :
+    _window(window),
+    _depth(depth),
+    _stream(sensors > 0 ? sensors : 0),
+    _starved(sensors > 0 ? sensors : 0),
+    _late(0),
+    _merged(0)
+{
+    /*! Ctor. \c sensors is the number of streams to merge, \c window the
+        coincidence window (in timestamp units) and \c depth the number of hits
+        each sensor stream can hold to fix local disorder before releasing them
+        to the merge. A zero depth means streams are trusted to be sorted.
+    */
+    if (sensors <= 0) throw std::runtime_error{ "builder: no sensors to merge" };
+
+    // All the streams start with no constraint on time.
+    for (auto& st : _stream) {
+        st.mark = std::numeric_limits<long>::min();
+        st.buffer.reserve(_depth + 1);
+    }
+    _heap.reserve(_stream.size());
+}
+
+//______________________________________________________________________________
+cat::builder::~builder()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+namespace {
+
+    //______________________________________________________________________________
+    bool later(const cat::hit& a, const cat::hit& b)
+    {
+        /* Heap ordering for the reorder buffers: the earliest on top. */
+        return a.t() > b.t();
+    }
+}
+
+//______________________________________________________________________________
+void cat::builder::release(stream& st, const int& idx)
+{
+    /* Moves the earliest buffered hit of the stream into its sorted queue,
+       raising the stream mark accordingly: from now on, any hit earlier than
+       the released one is late. If the stream had nothing ready, its new head
+       enters the merge heap.
+    */
+    std::pop_heap(st.buffer.begin(), st.buffer.end(), later);
+    st.mark = st.buffer.back().t();
+    st.sorted.push_back(st.buffer.back());
+    st.buffer.pop_back();
+
+    // Stream no more starved, queue its head.
+    if (st.sorted.size() == 1) {
+        _heap.push_back(head(st.mark, idx));
+        std::push_heap(_heap.begin(), _heap.end(), std::greater<head>());
+        _starved--;
+    }
+}
+
+//______________________________________________________________________________
+long cat::builder::safe() const
+{
+    /* Returns the time up to which the merge can proceed: a stream with no
+       hits ready may still deliver hits as early as its mark, so the merge
+       cannot go past the lowest mark among the starved streams.
+    */
+    long limit = std::numeric_limits<long>::max();
+    if (_starved == 0) return limit;
+    for (const auto& st : _stream) {
+        if (st.sorted.empty()) limit = std::min(limit, st.mark);
+    }
+    return limit;
+}
+
+//______________________________________________________________________________
+void cat::builder::merge(const bool& all)
+{
+    /* Advances the k-way merge as far as the time order is guaranteed (or up
+       to the end, if \c all is set), packing the merged hits into events.
+    */
+    long limit = all ? std::numeric_limits<long>::max() : safe();
+
+    // Pop heads while they are safely in order.
+    while (!_heap.empty() && _heap.front().first <= limit) {
+
+        // Pick the earliest head.
+        std::pop_heap(_heap.begin(), _heap.end(), std::greater<head>());
+        const int idx = _heap.back().second;
+        _heap.pop_back();
+        stream& st = _stream[idx];
+
+        // Requeue the stream, or account it as starved.
+        if (st.sorted.size() > 1) {
+            _heap.push_back(head(st.sorted[1].t(), idx));
+            std::push_heap(_heap.begin(), _heap.end(), std::greater<head>());
+        } else {
+            _starved++;
+            if (!all) limit = std::min(limit, st.mark);
+        }
+
+        // Out of the window, start a new event.
+        if (!_open.empty() && st.sorted.front().t() - _open.front().hit.t() > _window) close();
+        _open.push_back(item{ idx, st.sorted.front() });
+        st.sorted.pop_front();
+        _merged++;
+    }
+
+    // Close the open event as soon as nothing else can enter its window.
+    if (!_open.empty()) {
+        long next = _heap.empty() ? limit : std::min(limit, _heap.front().first);
+        if (next > _open.front().hit.t() + _window) close();
+    }
+}
+
+//______________________________________________________________________________
+void cat::builder::close()
+{
+    /* Moves the event being built to the ready ones. */
+    _ready.push_back(std::move(_open));
+    _open.clear();
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::builder::sensors() const
+{
+    /*! Returns the number of merged streams. */
+    return static_cast<int>(_stream.size());
+}
+
+//______________________________________________________________________________
+long cat::builder::window() const
+{
+    /*! Returns the coincidence window. */
+    return _window;
+}
+
+//______________________________________________________________________________
+void cat::builder::window(const long& window)
+{
+    /*! Sets the coincidence window. It applies from the next merged hit on. */
+    _window = window;
+}
+
+//______________________________________________________________________________
+std::size_t cat::builder::depth() const
+{
+    /*! Returns the per-sensor reorder buffer depth. */
+    return _depth;
+}
+
+//______________________________________________________________________________
+void cat::builder::push(const int& idx, const cat::hit& h)
+{
+    /*! Feeds the hit \c h from the sensor \c idx. The hit enters the sensor
+        reorder buffer, and the earliest buffered hit is released to the merge
+        once the buffer is full. Hits earlier than anything already released
+        from the same sensor cannot be placed in order anymore: they are
+        counted as late and dropped.
+    */
+    if (idx < 0 || idx >= sensors()) throw std::runtime_error{ "builder: sensor index out of range" };
+    stream& st = _stream[idx];
+
+    // Too late to be sorted.
+    if (h.t() < st.mark) {
+        _late++;
+        return;
+    }
+
+    // Buffer, release when full.
+    st.buffer.push_back(h);
+    std::push_heap(st.buffer.begin(), st.buffer.end(), later);
+    if (st.buffer.size() > _depth) {
+        release(st, idx);
+        merge();
+    }
+}
+
+//______________________________________________________________________________
+void cat::builder::mark(const int& idx, const long& t)
+{
+    /*! Declares that the sensor \c idx will produce no more hits earlier than
+        \c t. Buffered hits up to \c t are released, and the merge can move
+        past a sensor which is silent. Should be called periodically for any
+        sensor, with its readout time, to keep the latency bounded.
+    */
+    if (idx < 0 || idx >= sensors()) throw std::runtime_error{ "builder: sensor index out of range" };
+    stream& st = _stream[idx];
+
+    // Release whatever cannot be overtaken anymore.
+    while (!st.buffer.empty() && st.buffer.front().t() <= t) release(st, idx);
+    if (t > st.mark) st.mark = t;
+    merge();
+}
+
+//______________________________________________________________________________
+void cat::builder::flush()
+{
+    /*! Releases all the buffered hits and closes the last event, typically at
+        the end of a run. Stream marks are kept, so that hits older than the
+        flushed ones are still reported as late.
+    */
+    for (int i = 0; i < sensors(); i++) {
+        while (!_stream[i].buffer.empty()) release(_stream[i], i);
+    }
+    merge(true);
+    if (!_open.empty()) close();
+}
+
+//______________________________________________________________________________
+bool cat::builder::pop(event& ev)
+{
+    /*! Moves the next complete event into \c ev. Returns false if there are no
+        complete events available.
+    */
+    if (_ready.empty()) return false;
+    ev = std::move(_ready.front());
+    _ready.pop_front();
+    return true;
+}
+
+//______________________________________________________________________________
+std::size_t cat::builder::ready() const
+{
+    /*! Returns how many complete events are waiting to be popped. */
+    return _ready.size();
+}
+
+//______________________________________________________________________________
+long cat::builder::late() const
+{
+    /*! Returns how many hits were dropped because arrived out of order by more
+        than the reorder buffer depth.
+    */
+    return _late;
+}
+
+//______________________________________________________________________________
+long cat::builder::merged() const
+{
+    /*! Returns how many hits entered events so far. */
+    return _merged;
+}
@@ -0,0 +1,131 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Event builder                                --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"builder.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'builder' object merges the hit streams coming from several sensors into
+// a single, time-ordered stream, and groups the merged hits into 'events'.
+// Every sensor stream is expected to be *almost* time sorted: a small, bounded
+// reorder buffer per sensor takes care of local disorder, while hits arriving
+// later than the buffer can absorb are counted and discarded.
+// The per-sensor sorted streams are then k-way merged through a heap of the
+// streams heads, and consecutive hits falling within the coincidence window
+// (measured from the first hit of the event) are packed into the same event.
+// Nothing is buffered beyond what is needed to guarantee the time order: a
+// sensor producing no hits should signal its progress by 'mark', otherwise
+// the merge will wait for it.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef builder_HPP
+#define builder_HPP
+
+// Application units.
+#include "hit.hpp"
+
+// Standard library
+#include <vector>
+#include <deque>
+#include <utility>
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class builder; }
+class cat::builder
+{
+
+public:
+
+	// Single event item: the hit plus the index of its originating sensor.
+	struct item {
+		int sensor;
+		cat::hit hit;
+	};
+
+	// An event is a time-ordered collection of items.
+	typedef std::vector<item> event;
+
+	// Special members.
+	builder(const int&, const long&, const std::size_t& = 64);	//!< Ctor.
+	~builder();					//!< Dtor.
+
+	// No copy allowed, the builder is a stream processing stage.
+	builder(const builder&) = delete;
+	builder& operator=(const builder&) = delete;
+
+	// Properties.
+	int sensors() const;		//!< Retrieve the number of merged streams.
+	long window() const;		//!< Retrieve the coincidence window [tsp].
+	void window(const long&);	//!< Set the coincidence window [tsp].
+	std::size_t depth() const;	//!< Retrieve the reorder buffer depth [hits].
+
+	// Stream input.
+	void push(const int&, const cat::hit&);	//!< Feed a hit from a sensor.
+	void mark(const int&, const long&);		//!< Declare no hits before time.
+	void flush();							//!< Release everything (end of run).
+
+	// Events output.
+	bool pop(event&);			//!< Retrieve the next complete event.
+	std::size_t ready() const;	//!< Number of complete events available.
+
+	// Statistics.
+	long late() const;			//!< Hits discarded because arrived too late.
+	long merged() const;		//!< Hits merged into events so far.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Single sensor stream.
+	struct stream {
+		std::vector<cat::hit> buffer;	// Reorder buffer (min-heap on time).
+		std::deque<cat::hit> sorted;	// Time sorted hits, ready to merge.
+		long mark;						// No further hit can come before this.
+	};
+
+	// Merge heap entry: (time, sensor) of a stream head.
+	typedef std::pair<long, int> head;
+
+	// Support routines.
+	void release(stream&, const int&);		// Move the earliest hit to 'sorted'.
+	void merge(const bool& = false);		// Advance the k-way merge.
+	void close();							// Close the event being built.
+	long safe() const;						// Time up to which merging is safe.
+
+	// Configuration.
+	long _window;					// Coincidence window.
+	std::size_t _depth;				// Per-sensor reorder buffer depth.
+
+	// Streams and merge heap.
+	std::vector<stream> _stream;	// Per-sensor streams.
+	std::vector<head> _heap;		// Heap of streams heads (min on time).
+	int _starved;					// Streams with nothing ready to merge.
+
+	// Events.
+	event _open;					// The event being built.
+	std::deque<event> _ready;		// Completed events.
+
+	// Statistics.
+	long _late;						// Late hits count.
+	long _merged;					// Merged hits count.
+};
+
+// Overloading check
+#endif
@@ -14,7 +14,7 @@
 
 
 // Application units
-#include "../include/caf.hpp"
+#include "caf.hpp"
 
 
 
@@ -0,0 +1,427 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Software framebuffer                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"canvas.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "canvas.hpp"
+
+// Standard library
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+namespace {
+
+    // Deflate length and distance codes: base values and extra bits.
+    const uint16_t LBASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    const uint8_t LEXT[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    const uint16_t DBASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                 8193, 12289, 16385, 24577 };
+    const uint8_t DEXT[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                               7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // Deflate bit stream, least significant bit first.
+    struct bits {
+        std::vector<uint8_t>& out;
+        uint32_t acc = 0;
+        int n = 0;
+
+        //______________________________________________________________________________
+        void put(uint32_t v, int len)
+        {
+            /* Appends the \c len low bits of \c v. */
+            acc |= v << n;
+            n += len;
+            while (n >= 8) {
+                out.push_back(static_cast<uint8_t>(acc));
+                acc >>= 8;
+                n -= 8;
+            }
+        }
+
+        //______________________________________________________________________________
+        void huff(const uint32_t& code, const int& len)
+        {
+            /* Appends a Huffman code, which goes most significant bit first. */
+            uint32_t r = 0;
+            for (int i = 0; i < len; i++) r |= ((code >> i) & 1) << (len - 1 - i);
+            put(r, len);
+        }
+
+        //______________________________________________________________________________
+        void flush()
+        {
+            /* Pads the last byte. */
+            if (n > 0) out.push_back(static_cast<uint8_t>(acc));
+            acc = 0;
+            n = 0;
+        }
+    };
+
+    //______________________________________________________________________________
+    void literal(bits& b, const int& v)
+    {
+        /* Writes a literal/length symbol with the fixed Huffman codes. */
+        if (v < 144) b.huff(0x30 + v, 8);
+        else if (v < 256) b.huff(0x190 + v - 144, 9);
+        else if (v < 280) b.huff(v - 256, 7);
+        else b.huff(0xC0 + v - 280, 8);
+    }
+
+    //______________________________________________________________________________
+    void match(bits& b, const int& len, const int& dist)
+    {
+        /* Writes a (length, distance) back reference. */
+        int l = 28;
+        while (LBASE[l] > len) l--;
+        literal(b, 257 + l);
+        b.put(len - LBASE[l], LEXT[l]);
+        int d = 29;
+        while (DBASE[d] > dist) d--;
+        b.huff(d, 5);
+        b.put(dist - DBASE[d], DEXT[d]);
+    }
+
+    //______________________________________________________________________________
+    void deflate(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+    {
+        /* Compresses \c in as a zlib stream: a single fixed Huffman block,
+           greedy matches found through a hash of the next 3 bytes which keeps
+           just the last position seen.
+        */
+        out.push_back(0x78);
+        out.push_back(0x01);
+        bits b{ out };
+        b.put(1, 1);
+        b.put(1, 2);
+
+        const int n = static_cast<int>(in.size());
+        std::vector<int> head(1 << 15, -1);
+        auto hash = [&](const int& i) { return ((in[i] << 10) ^ (in[i + 1] << 5) ^ in[i + 2]) & 0x7FFF; };
+        int i = 0;
+        while (i < n) {
+            int len = 0, dist = 0;
+            if (i + 3 <= n) {
+                const int h = hash(i);
+                const int c = head[h];
+                head[h] = i;
+                if (c >= 0 && i - c <= 32768) {
+                    const int max = std::min(258, n - i);
+                    while (len < max && in[c + len] == in[i + len]) len++;
+                    dist = i - c;
+                }
+            }
+            if (len >= 3) {
+                match(b, len, dist);
+                for (int k = i + 1; k < i + len && k + 3 <= n; k++) head[hash(k)] = k;
+                i += len;
+            } else {
+                literal(b, in[i]);
+                i++;
+            }
+        }
+        literal(b, 256);
+        b.flush();
+
+        // Adler-32 of the raw data.
+        uint32_t s1 = 1, s2 = 0;
+        for (const uint8_t& c : in) {
+            s1 = (s1 + c) % 65521;
+            s2 = (s2 + s1) % 65521;
+        }
+        const uint32_t adler = (s2 << 16) | s1;
+        for (int k = 3; k >= 0; k--) out.push_back(static_cast<uint8_t>(adler >> (8 * k)));
+    }
+
+    //______________________________________________________________________________
+    uint32_t crc(const uint8_t* p, const std::size_t& n, uint32_t c = 0xFFFFFFFF)
+    {
+        /* Updates the CRC-32 \c c (PNG polynomial) with \c n bytes. The
+           table is built once, thread safely, as canvases may be saved by
+           concurrent exporters.
+        */
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t k = 0; k < 256; k++) {
+                uint32_t v = k;
+                for (int j = 0; j < 8; j++) v = v & 1 ? 0xEDB88320 ^ (v >> 1) : v >> 1;
+                t[k] = v;
+            }
+            return t;
+        }();
+        for (std::size_t k = 0; k < n; k++) c = table[(c ^ p[k]) & 0xFF] ^ (c >> 8);
+        return c;
+    }
+
+    //______________________________________________________________________________
+    void chunk(std::ofstream& f, const char* type, const std::vector<uint8_t>& data)
+    {
+        /* Writes a PNG chunk: length, type, data and CRC. */
+        uint8_t word[4];
+        auto be = [&](const uint32_t& v) {
+            for (int k = 0; k < 4; k++) word[k] = static_cast<uint8_t>(v >> (24 - 8 * k));
+            f.write(reinterpret_cast<const char*>(word), 4);
+        };
+        be(static_cast<uint32_t>(data.size()));
+        f.write(type, 4);
+        f.write(reinterpret_cast<const char*>(data.data()), data.size());
+        uint32_t c = crc(reinterpret_cast<const uint8_t*>(type), 4);
+        be(crc(data.data(), data.size(), c) ^ 0xFFFFFFFF);
+    }
+}
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::canvas::canvas(const int& width, const int& height, const uint32_t& color) :
+    _width(width),
+    _height(height)
+{
+    /*! Ctor. \c width x \c height pixels, filled with \c color. */
+    if (width <= 0 || height <= 0) throw std::runtime_error{ "canvas: invalid dimensions" };
+    _px.resize(static_cast<std::size_t>(width) * height * 4);
+    clear(color);
+}
+
+//______________________________________________________________________________
+cat::canvas::~canvas()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::canvas::width() const
+{
+    /*! Returns the width [pixels]. */
+    return _width;
+}
+
+//______________________________________________________________________________
+int cat::canvas::height() const
+{
+    /*! Returns the height [pixels]. */
+    return _height;
+}
+
+//______________________________________________________________________________
+const uint8_t* cat::canvas::pixels() const
+{
+    /*! Returns the pixels, 4 bytes (R, G, B, A) each, the top row first. */
+    return _px.data();
+}
+
+//______________________________________________________________________________
+uint32_t cat::canvas::pixel(const int& x, const int& y) const
+{
+    /*! Returns the color of the pixel (\c x, \c y), 0 if out of the canvas. */
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+    const uint8_t* p = &_px[(static_cast<std::size_t>(y) * _width + x) * 4];
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+//______________________________________________________________________________
+void cat::canvas::clear(const uint32_t& color)
+{
+    /*! Fills the whole canvas with \c color (no blending). */
+    for (std::size_t i = 0; i < _px.size(); i += 4) {
+        for (int c = 0; c < 4; c++) _px[i + c] = static_cast<uint8_t>(color >> (24 - 8 * c));
+    }
+}
+
+//______________________________________________________________________________
+void cat::canvas::dot(const int& x, const int& y, const uint32_t& color)
+{
+    /*! Draws the pixel (\c x, \c y), blending \c color by its alpha. Pixels
+        out of the canvas are ignored.
+    */
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+    uint8_t* p = &_px[(static_cast<std::size_t>(y) * _width + x) * 4];
+    const uint32_t a = color & 0xFF;
+    if (a == 0xFF) {
+        for (int c = 0; c < 4; c++) p[c] = static_cast<uint8_t>(color >> (24 - 8 * c));
+        return;
+    }
+    for (int c = 0; c < 3; c++) {
+        const uint32_t s = (color >> (24 - 8 * c)) & 0xFF;
+        p[c] = static_cast<uint8_t>((s * a + p[c] * (255 - a) + 127) / 255);
+    }
+    p[3] = static_cast<uint8_t>(a + (p[3] * (255 - a) + 127) / 255);
+}
+
+//______________________________________________________________________________
+void cat::canvas::line(int x0, int y0, const int& x1, const int& y1, const uint32_t& color)
+{
+    /*! Draws the line from (\c x0, \c y0) to (\c x1, \c y1), both ends
+        included (Bresenham).
+    */
+    const int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    const int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        dot(x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        const int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+//______________________________________________________________________________
+void cat::canvas::rect(const int& x, const int& y, const int& w, const int& h, const uint32_t& color)
+{
+    /*! Fills the \c w x \c h rectangle whose top left corner is (\c x, \c y). */
+    const int x0 = std::max(x, 0), x1 = std::min(x + w, _width);
+    const int y0 = std::max(y, 0), y1 = std::min(y + h, _height);
+    for (int j = y0; j < y1; j++) {
+        for (int i = x0; i < x1; i++) dot(i, j, color);
+    }
+}
+
+//______________________________________________________________________________
+void cat::canvas::disc(const int& x, const int& y, const int& r, const uint32_t& color)
+{
+    /*! Fills the disc of radius \c r centered in (\c x, \c y). */
+    for (int j = -r; j <= r; j++) {
+        const int s = static_cast<int>(std::sqrt(static_cast<double>(r * r - j * j)) + 0.5);
+        rect(x - s, y + j, 2 * s + 1, 1, color);
+    }
+}
+
+//______________________________________________________________________________
+void cat::canvas::map(const std::vector<float>& v, const int& cols, const int& rows, float lo, float hi)
+{
+    /*! Draws the \c cols x \c rows map of values \c v (row major, as in a
+        'hitmap' snapshot) over the whole canvas, the first row at the bottom.
+        Values are mapped from [\c lo, \c hi] to the palette; if \c hi is not
+        above \c lo, the range goes from zero to the largest value.
+    */
+    if (cols <= 0 || rows <= 0 || v.size() < static_cast<std::size_t>(cols) * rows) return;
+    if (hi <= lo) {
+        lo = 0;
+        hi = *std::max_element(v.begin(), v.end());
+        if (hi <= lo) hi = lo + 1;
+    }
+    const float scale = 1.0f / (hi - lo);
+    for (int y = 0; y < _height; y++) {
+        const int row = rows - 1 - static_cast<int>(static_cast<int64_t>(y) * rows / _height);
+        for (int x = 0; x < _width; x++) {
+            const int col = static_cast<int>(static_cast<int64_t>(x) * cols / _width);
+            dot(x, y, palette((v[static_cast<std::size_t>(row) * cols + col] - lo) * scale));
+        }
+    }
+}
+
+//______________________________________________________________________________
+bool cat::canvas::png(const std::string& file) const
+{
+    /*! Saves the canvas as the RGBA PNG \c file. Each row is filtered with
+        whichever of the none, sub and up filters gives the smallest sum of
+        (signed) residuals, the usual heuristic. Returns false on failure.
+    */
+    const std::size_t stride = static_cast<std::size_t>(_width) * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * _height);
+    std::vector<uint8_t> best(stride), test(stride);
+    for (int y = 0; y < _height; y++) {
+        const uint8_t* row = &_px[y * stride];
+        const uint8_t* up = y ? row - stride : nullptr;
+        uint8_t type = 0;
+        uint64_t min = UINT64_MAX;
+        for (uint8_t t = 0; t < 3; t++) {
+            if (t == 2 && !up) break;
+            uint64_t sum = 0;
+            for (std::size_t i = 0; i < stride; i++) {
+                const uint8_t pred = t == 1 ? (i >= 4 ? row[i - 4] : 0) : (t == 2 ? up[i] : 0);
+                test[i] = static_cast<uint8_t>(row[i] - pred);
+                sum += test[i] < 128 ? test[i] : 256 - test[i];
+            }
+            if (sum < min) {
+                min = sum;
+                type = t;
+                best.swap(test);
+            }
+        }
+        raw.push_back(type);
+        raw.insert(raw.end(), best.begin(), best.end());
+    }
+
+    // Header and data.
+    std::vector<uint8_t> ihdr(13, 0);
+    for (int k = 0; k < 4; k++) {
+        ihdr[k] = static_cast<uint8_t>(_width >> (24 - 8 * k));
+        ihdr[4 + k] = static_cast<uint8_t>(_height >> (24 - 8 * k));
+    }
+    ihdr[8] = 8;
+    ihdr[9] = 6;
+    std::vector<uint8_t> idat;
+    deflate(raw, idat);
+
+    // Write.
+    std::ofstream f(file, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    const uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    f.write(reinterpret_cast<const char*>(sig), 8);
+    chunk(f, "IHDR", ihdr);
+    chunk(f, "IDAT", idat);
+    chunk(f, "IEND", std::vector<uint8_t>());
+
+    // A failed flush shows only at the close.
+    f.close();
+    return !f.fail();
+}
+
+//______________________________________________________________________________
+uint32_t cat::canvas::palette(const float& t)
+{
+    /*! Returns the color of \c t along a perceptually ordered palette (dark
+        blue to yellow), \c t being clamped to [0, 1].
+    */
+    static const float stop[5][3] = { { 68, 1, 84 }, { 59, 82, 139 }, { 33, 145, 140 },
+                                      { 94, 201, 98 }, { 253, 231, 37 } };
+    const float s = (t > 0 ? (t < 1 ? t : 1) : 0) * 4;
+    const int i = std::min(static_cast<int>(s), 3);
+    const float f = s - i;
+    uint32_t color = 0xFF;
+    for (int c = 0; c < 3; c++) {
+        const float v = stop[i][c] + (stop[i + 1][c] - stop[i][c]) * f;
+        color |= static_cast<uint32_t>(v + 0.5f) << (24 - 8 * c);
+    }
+    return color;
+}
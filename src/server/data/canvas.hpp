@@ -0,0 +1,84 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Software framebuffer                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"canvas.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'canvas' object is an offscreen RGBA framebuffer living in plain
+// memory, drawn by the CPU: no window, display or GPU is needed, so it works
+// on headless nodes and in tests alike. It offers the few primitives the
+// monitoring images need (points, lines, filled rectangles and discs, alpha
+// blended) plus the rendering of a whole map of values (i.e. a 'hitmap'
+// snapshot) through a color palette, and saves itself as a PNG file.
+// Colors are 0xRRGGBBAA words. The PNG encoder is self contained (fixed
+// Huffman deflate with a single entry hash match finder), which compresses
+// the large uniform areas of the maps well at a small cost.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef canvas_HPP
+#define canvas_HPP
+
+// Standard library
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+//______________________________________________________________________________
+namespace cat { class canvas; }
+class cat::canvas
+{
+
+public:
+
+	// Special members.
+	canvas(const int&, const int&, const uint32_t& = 0x000000FF);	//!< Ctor.
+	~canvas();					//!< Dtor.
+
+	// Properties.
+	int width() const;			//!< Retrieve the width [pixels].
+	int height() const;			//!< Retrieve the height [pixels].
+	const uint8_t* pixels() const;	//!< Retrieve the RGBA rows, top first.
+	uint32_t pixel(const int&, const int&) const;	//!< Retrieve a pixel color.
+
+	// Drawing.
+	void clear(const uint32_t&);	//!< Fill everything with a color.
+	void dot(const int&, const int&, const uint32_t&);	//!< Draw a pixel.
+	void line(int, int, const int&, const int&, const uint32_t&);	//!< Draw a line.
+	void rect(const int&, const int&, const int&, const int&, const uint32_t&);	//!< Fill a rectangle.
+	void disc(const int&, const int&, const int&, const uint32_t&);	//!< Fill a disc.
+	void map(const std::vector<float>&, const int&, const int&, float = 0, float = 0);	//!< Draw a map of values.
+
+	// Output.
+	bool png(const std::string&) const;	//!< Save as a PNG file.
+
+	// Palette.
+	static uint32_t palette(const float&);	//!< Map [0, 1] to a color.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	int _width;						// Width [pixels].
+	int _height;					// Height [pixels].
+	std::vector<uint8_t> _px;		// RGBA bytes, rows top first.
+};
+
+// Overloading check
+#endif
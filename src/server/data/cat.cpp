@@ -14,10 +14,10 @@
 
 
 // Application units
-#include "../include/cat.h"
-#include "../include/caf.hpp"
+#include "cat.h"
+#include "caf.hpp"
 
-#include "../include/pixel.hpp"
+#include "pixel.hpp"
 
 // Standard library
 #include <stdexcept>
@@ -21,7 +21,7 @@
 
 // Application units.
 #include "../include/cmd.hpp"
-#include "../include/log.hpp"
+#include "log.hpp"
 
 
 // Main functions.
@@ -14,8 +14,8 @@
 
 
 // Application units
-#include "../include/cluster.hpp"
-#include "../include/caf.hpp"
+#include "cluster.hpp"
+#include "caf.hpp"
 
 
 // Use standard namespace:
@@ -32,7 +32,8 @@ cat::cluster::cluster() :
     _col(0), _row(0), _tsp(0),
     _mult(0), _mass(0),
     _left(0), _right(0), _bottom(0), _top(0),
-    _width(0), _height(0)
+    _width(0), _height(0),
+    _charge(0)
 {
     /* Default ctor. */
 }
@@ -45,7 +46,8 @@ cat::cluster::cluster(const cat::pixel& px) :
     _col((float)px.col() + 0.5f), _row((float)px.row() + 0.5f),  _tsp(px.tsp()),
     _mult(1), _mass(1), 
     _left(px.col()), _right(px.col()), _bottom(px.row()), _top(px.row()),
-    _width(1), _height(1)
+    _width(1), _height(1),
+    _charge(1)
 {
     /*! Single pixel ctor. */
     _pixel.push_back(px);
@@ -55,10 +57,13 @@ cat::cluster::cluster(const cat::pixel& px) :
 //______________________________________________________________________________
 cat::cluster::cluster(const cluster& cl) : 
     data(cl), 
+    _pixel(cl._pixel),
+    _chg(cl._chg),
     _col(cl._col), _row(cl._row), _tsp(cl._tsp),
     _mult(cl._mult), _mass(cl._mass),
     _left(cl._left), _right(cl._right), _bottom(cl._bottom), _top(cl._top),
-    _width(cl._width), _height(cl._height)
+    _width(cl._width), _height(cl._height),
+    _charge(cl._charge)
 {
     /*! Copy ctor. */
 }
@@ -76,6 +81,72 @@ cat::cluster::~cluster()
 // *****************************************************************************
 
 
+//______________________________________________________________________________
+template <typename T>
+void cat::cluster::metrics()
+{
+    /* Computes all the cluster metrics in a single pass over the pixels. The
+       T traits select at compile time whether to weigh the position by the
+       pixels charge.
+    */
+    double col = 0;
+    double row = 0;
+    double q = 0;
+    _mult = (int)_pixel.size();
+    _mass = _mult;
+    _tsp = _pixel[0].tsp();
+    _left = _pixel[0].col();
+    _right = _pixel[0].col();
+    _bottom = _pixel[0].row();
+    _top = _pixel[0].row();
+
+    // Loop over all the cluster pixels.
+    for (std::size_t i = 0; i < _pixel.size(); i++) {
+        const cat::pixel& px = _pixel[i];
+
+        // Position and charge.
+        if constexpr (T::charged) {
+            const double w = _chg[i];
+            col += w * px.col();
+            row += w * px.row();
+            q += w;
+        } else {
+            col += px.col();
+            row += px.row();
+        }
+
+        // Timestamp.
+        if (px.tsp() < _tsp) _tsp = px.tsp();
+
+        // Bounding box.
+        if (px.col() < _left) _left = px.col();
+        if (px.col() > _right) _right = px.col();
+        if (px.row() < _bottom) _bottom = px.row();
+        if (px.row() > _top) _top = px.row();
+    }
+
+    // Digital pixels have unit charge. A non positive total charge cannot
+    // weigh the position: the plain centroid is used instead.
+    if constexpr (!T::charged) q = _mult;
+    if (q <= 0) {
+        metrics<cat::digital>();
+        _charge = (float)q;
+        return;
+    }
+    _charge = (float)q;
+
+    // Derives cluster x,y position, in matrix floating coordinates.
+    // Here it a single pixel of matrix coordinates (x, y) is considered to
+    // have (x + 0.5, y + 0.5) matrix coordinates.
+    _col = (float)(col / q) + 0.5f;
+    _row = (float)(row / q) + 0.5f;
+
+    // Width and height.
+    _width = _right - _left + 1;
+    _height = _top - _bottom + 1;
+}
+
+
 // *****************************************************************************
 // **                           Operators overload                            **
 // *****************************************************************************
@@ -88,6 +159,8 @@ cat::cluster& cat::cluster::operator=(const cat::cluster& cl)
     data::operator=(cl);
 
     // Object data copy.
+    _pixel = cl._pixel;
+    _chg = cl._chg;
     _col = cl._col;
     _row = cl._row;
     _tsp = cl._tsp;
@@ -103,6 +176,8 @@ cat::cluster& cat::cluster::operator=(const cat::cluster& cl)
     _width = cl._width;
     _height = cl._height;
 
+    _charge = cl._charge;
+
 
     // Return.
     return *this;
@@ -135,51 +210,12 @@ std::ostream& operator<<(std::ostream& os, const cat::cluster& cl)
 //______________________________________________________________________________
 void cat::cluster::update()
 {
-    /* Update the cluster properties and metrics. */
+    /* Update the cluster properties and metrics. The charge weighted loop is
+       used only if any pixel carries a charge.
+    */
     if (_pixel.empty()) return;
-
-    // Calculate the cluster position, width and height.
-    _col = 0;
-    _row = 0;
-    _mass = 0;
-    _mult = (int)_pixel.size();
-    
-    _tsp = _pixel[0].tsp();
-    
-    _width = 0;
-    _height = 0;
-    _left = _pixel[0].col();
-    _right = _pixel[0].col();
-    _bottom = _pixel[0].row();
-    _top = _pixel[0].row();
-
-    // Loop over all the cluster pixels.
-    for (auto& px : _pixel) {
-        
-        // Position.
-        _col += px.col();
-        _row += px.row();
-        _mass++;
-
-        // Timestamp.
-        if (px.tsp() < _tsp) _tsp = px.tsp() < _tsp;
-        
-        // Bounding box.
-        if (px.col() < _left) _left = px.col();
-        if (px.col() > _right) _right = px.col();
-        if (px.row() < _bottom) _bottom = px.row();
-        if (px.row() > _top) _top = px.row();
-    }
-
-    // Derives cluster x,y position, in matrix floating coordinates.
-    // Here it a single pixel of matrix coordinates (x, y) is considered to
-    // have (x + 0.5, y + 0.5) matrix coordinates.
-    _col = (float)(_col / _mass) + 0.5f;
-    _row = (float)(_row / _mass) + 0.5f;
-
-    // Width and height.
-    _width = _right - _left + 1;
-    _height = _top - _bottom + 1;
+    if (!_chg.empty()) metrics<cat::analog>();
+    else metrics<cat::digital>();
 
     // Confirm update.
     data::_updated = true;
@@ -189,8 +225,9 @@ void cat::cluster::update()
 //______________________________________________________________________________
 void cat::cluster::add(const pixel& px)
 {
-    /* Add a pixel to the cluster. */
+    /* Add a pixel to the cluster (unit charge). */
     _pixel.push_back(cat::pixel(px));
+    if (!_chg.empty()) _chg.push_back(1.0f);
 
     // Now the cluster has changed.
     if (data::_autoUpdate) {
@@ -201,6 +238,43 @@ void cat::cluster::add(const pixel& px)
 }
 
 
+//______________________________________________________________________________
+void cat::cluster::add(const pixel& px, const float& q)
+{
+    /* Add a pixel of charge \c q to the cluster. The charge column is made
+       at the first charged pixel, the pixels already there at unit charge.
+    */
+    if (_chg.size() < _pixel.size()) _chg.assign(_pixel.size(), 1.0f);
+    _pixel.push_back(cat::pixel(px));
+    _chg.push_back(q);
+
+    // Now the cluster has changed.
+    if (data::_autoUpdate) {
+        update();
+    } else {
+        data::_updated = false;
+    }
+}
+
+
+//______________________________________________________________________________
+const std::vector<cat::pixel>& cat::cluster::pixels() const
+{
+    /* Returns the cluster pixels. */
+    return _pixel;
+}
+
+
+//______________________________________________________________________________
+const std::vector<float>& cat::cluster::charges() const
+{
+    /* Returns the pixels charge, in the 'pixels' order; empty if all the
+       pixels are digital (unit charge).
+    */
+    return _chg;
+}
+
+
 //______________________________________________________________________________
 float cat::cluster::col() const
 {
@@ -217,7 +291,7 @@ float cat::cluster::row() const
 }
 
 //______________________________________________________________________________
-int cat::cluster::tsp() const
+long cat::cluster::tsp() const
 {
     /* Returns cluster timestamp. */
     return _tsp;
@@ -237,6 +311,13 @@ int cat::cluster::mass() const
     return _mass;
 }
 
+//______________________________________________________________________________
+float cat::cluster::charge() const
+{
+    /* Returns cluster total charge (multiplicity, for digital pixels). */
+    return _charge;
+}
+
 //______________________________________________________________________________
 int cat::cluster::left() const
 {
@@ -22,6 +22,9 @@
 // to optimize the cluster building phase.
 // In case, the 'selfUpdate' method, also inherited from the 'data' object, 
 // may be used to make the 'cluster' updating at each 'pixel' operation.
+// Pixels carrying a charge (analog sensors) make the cluster position a
+// charge weighted centroid, and add up to the cluster charge; as long as all
+// the pixels are digital, the plain (unweighted) metrics loop is used.
 //==============================================================================
 
 
@@ -32,7 +35,7 @@
 #define cluster_HPP
 
 // Application units.
-#include "../include/pixel.hpp"
+#include "pixel.hpp"
 
 // Standard library
 #include <string>
@@ -60,23 +63,27 @@ public:
 	//friend std::ostream& operator<<(std::ostream&, cat::pixel&);
 		
 	// Overloaded base class methods.
-	inline void update();		//!< Update the cluster properties and metrics.		
+	void update();				//!< Update the cluster properties and metrics.		
 
 	// Cluster pixels.
 	void add(const pixel&);		//!< Add a pixel to the cluster.
+	void add(const pixel&, const float&);	//!< Add a charged pixel to the cluster.
+	const std::vector<cat::pixel>& pixels() const;	//!< Retrieve the cluster pixels.
+	const std::vector<float>& charges() const;	//!< Retrieve the pixels charge (analog only).
 	
 	// Cluster properties.
-	inline float col() const;	//!< Retrieve x coordinate.
-	inline float row() const;	//!< Retrieve y coordinate.
-	inline int tsp() const;		//!< Retrieve timestamp.
-	inline int mult() const;	//!< Retrieve multiplicity [px].
-	inline int mass() const;	//!< Retrieve mass [px*s].
-	inline int width() const;	//!< Retrieve width [px].
-	inline int height() const;	//!< Retrieve height [px].
-	inline int left() const;	//!< Retrieve multiplicity [px].
-	inline int right() const;	//!< Retrieve width [px].
-	inline int bottom() const;	//!< Retrieve height [px].
-	inline int top() const;		//!< Retrieve height [px].
+	float col() const;		//!< Retrieve x coordinate.
+	float row() const;		//!< Retrieve y coordinate.
+	long tsp() const;			//!< Retrieve timestamp.
+	int mult() const;		//!< Retrieve multiplicity [px].
+	int mass() const;		//!< Retrieve mass [px*s].
+	float charge() const;		//!< Retrieve total charge.
+	int width() const;		//!< Retrieve width [px].
+	int height() const;		//!< Retrieve height [px].
+	int left() const;		//!< Retrieve multiplicity [px].
+	int right() const;		//!< Retrieve width [px].
+	int bottom() const;		//!< Retrieve height [px].
+	int top() const;			//!< Retrieve height [px].
 
 
 protected:
@@ -87,11 +94,12 @@ private:
 
 	// Pixels.
 	std::vector<cat::pixel> _pixel;
+	std::vector<float> _chg;	// Pixels charge, empty while all are digital.
 	
 	// Cluster coordinates.
 	float _col;		// x coordinate.
 	float _row;		// y coordinate.
-	int _tsp;		// timestamp.
+	long _tsp;		// timestamp.
 
 	// CLuster bounding box.
 	int _left;		// Leftmost pixel x coordinate.
@@ -104,6 +112,10 @@ private:
 	int _mass;		// Mass (equal to multiplicity for digital pixels).
 	int _width;		// Width in pixels.
 	int _height;	// Height in pixels.
+	float _charge;	// Total charge (equal to multiplicity for digital pixels).
+
+	// Support routines.
+	template <typename T> void metrics();
 };
 
 //______________________________________________________________________________
@@ -0,0 +1,366 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel clustering                             --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"clusterer.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "clusterer.hpp"
+
+// Standard library
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                                 Kernels                                 **
+// *****************************************************************************
+
+//______________________________________________________________________________
+class cat::clusterer::engine
+{
+public:
+    virtual ~engine() {}
+    virtual bool fixed() const = 0;
+    virtual std::size_t run(const cat::batch&, const long&, std::vector<cat::cluster>&) = 0;
+    virtual std::size_t frame(const cat::batch&, std::vector<cat::cluster>&) = 0;
+};
+
+//______________________________________________________________________________
+template <typename G>
+class cat::clusterer::kernel : public cat::clusterer::engine
+{
+public:
+
+    //__________________________________________________________________________
+    kernel(const G& g) : _g(g), _gen(0) {}
+
+    //__________________________________________________________________________
+    bool fixed() const override
+    {
+        /* Whether the geometry is a compile-time one. */
+        return !std::is_same_v<G, cat::geometry<0, 0>>;
+    }
+
+    //__________________________________________________________________________
+    std::size_t run(const cat::batch& b, const long& window, std::vector<cat::cluster>& out) override
+    {
+        /* Data-driven labeling: every pixel is merged with the pixels last
+           seen on itself and its 8 neighbours, if within \c window in time.
+           The grid entries belong to the batch only when their stamp matches
+           the current generation, so the grid is never cleared.
+        */
+        const std::size_t n = b.size();
+        if (!n) return 0;
+        if (_stamp.empty()) {
+            _stamp.assign(_g.size(), 0);
+            _slot.resize(_g.size());
+        }
+        if (++_gen == 0) {
+            std::fill(_stamp.begin(), _stamp.end(), 0);
+            _gen = 1;
+        }
+        const int* col = b.col();
+        const int* row = b.row();
+        const long* tsp = b.tsp();
+        _parent.resize(n);
+
+        for (std::size_t i = 0; i < n; i++) {
+            const int c = col[i];
+            const int r = row[i];
+            if (!_g.inside(c, r)) {
+                _parent[i] = SKIP;
+                continue;
+            }
+            _parent[i] = static_cast<uint32_t>(i);
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if (!_g.inside(c + dc, r + dr)) continue;
+                    const std::size_t k = _g.index(c + dc, r + dr);
+                    if (_stamp[k] != _gen) continue;
+                    const uint32_t j = _slot[k];
+                    const long dt = tsp[i] - tsp[j];
+                    if (dt <= window && -dt <= window) unite(static_cast<uint32_t>(i), j);
+                }
+            }
+            const std::size_t k = _g.index(c, r);
+            _stamp[k] = _gen;
+            _slot[k] = static_cast<uint32_t>(i);
+        }
+
+        // Gather the pixels by root (with their charge, if analog).
+        const float* chg = b.charge();
+        const std::size_t first = out.size();
+        _label.assign(n, SKIP);
+        for (std::size_t i = 0; i < n; i++) {
+            if (_parent[i] == SKIP) continue;
+            const uint32_t root = find(static_cast<uint32_t>(i));
+            if (_label[root] == SKIP) {
+                _label[root] = static_cast<uint32_t>(out.size() - first);
+                out.emplace_back();
+                out.back().setAuto(false);
+            }
+            if (chg) out[first + _label[root]].add(b.pixel(i), chg[i]);
+            else out[first + _label[root]].add(b.pixel(i));
+        }
+        for (std::size_t i = first; i < out.size(); i++) out[i].update();
+        return out.size() - first;
+    }
+
+    //__________________________________________________________________________
+    std::size_t frame(const cat::batch& b, std::vector<cat::cluster>& out) override
+    {
+        /* Frame labeling on the bit-plane: set the pixels, extract the runs
+           of every touched row, merge the touching runs of adjacent rows.
+        */
+        const std::size_t n = b.size();
+        if (!n) return 0;
+        const int W = _g.words();
+        if (_plane.empty()) _plane.assign(static_cast<std::size_t>(W) * _g.rows(), 0);
+        const int* col = b.col();
+        const int* row = b.row();
+        const long* tsp = b.tsp();
+
+        // Fill the plane, tracking the rows span and the frame time.
+        int r0 = _g.rows(), r1 = -1;
+        long t = tsp[0];
+        for (std::size_t i = 0; i < n; i++) {
+            const int c = col[i];
+            const int r = row[i];
+            if (!_g.inside(c, r)) continue;
+            _plane[static_cast<std::size_t>(r) * W + (c >> 6)] |= uint64_t(1) << (c & 63);
+            r0 = std::min(r0, r);
+            r1 = std::max(r1, r);
+            t = std::min(t, tsp[i]);
+        }
+        if (r1 < r0) return 0;
+
+        // Runs, a word at a time, and their merging with the previous row.
+        _runs.clear();
+        std::size_t prev = 0, prevEnd = 0;
+        for (int r = r0; r <= r1; r++) {
+            const uint64_t* line = &_plane[static_cast<std::size_t>(r) * W];
+            const std::size_t start = _runs.size();
+            bool open = false;
+            int c0 = 0;
+            for (int w = 0; w < W; w++) {
+                const uint64_t bits = line[w];
+                if (!bits) continue;
+                const uint64_t carry = w > 0 ? line[w - 1] >> 63 : 0;
+                const uint64_t next = w + 1 < W ? line[w + 1] & 1 : 0;
+                uint64_t s = bits & ~((bits << 1) | carry);
+                uint64_t e = bits & ~((bits >> 1) | (next << 63));
+                while (e) {
+                    if (!open) {
+                        c0 = (w << 6) + std::countr_zero(s);
+                        s &= s - 1;
+                    }
+                    const int c1 = (w << 6) + std::countr_zero(e);
+                    e &= e - 1;
+                    _runs.push_back({ r, c0, c1 });
+                    open = false;
+                }
+                if (s) {
+                    c0 = (w << 6) + std::countr_zero(s);
+                    open = true;
+                }
+            }
+            const std::size_t end = _runs.size();
+            _parent.resize(end);
+            for (std::size_t i = start; i < end; i++) _parent[i] = static_cast<uint32_t>(i);
+
+            // Two-pointer sweep over the runs of the row above (if adjacent).
+            if (start > 0 && _runs[prev].row == r - 1) {
+                std::size_t i = prev, j = start;
+                while (i < prevEnd && j < end) {
+                    if (_runs[i].c0 <= _runs[j].c1 + 1 && _runs[j].c0 <= _runs[i].c1 + 1)
+                        unite(static_cast<uint32_t>(j), static_cast<uint32_t>(i));
+                    if (_runs[i].c1 <= _runs[j].c1) i++;
+                    else j++;
+                }
+            }
+            if (end > start) {
+                prev = start;
+                prevEnd = end;
+            }
+        }
+
+        // Emit the clusters, and clear the touched rows.
+        const std::size_t first = out.size();
+        _label.assign(_runs.size(), SKIP);
+        for (std::size_t i = 0; i < _runs.size(); i++) {
+            const uint32_t root = find(static_cast<uint32_t>(i));
+            if (_label[root] == SKIP) {
+                _label[root] = static_cast<uint32_t>(out.size() - first);
+                out.emplace_back();
+                out.back().setAuto(false);
+            }
+            cat::cluster& cl = out[first + _label[root]];
+            for (int c = _runs[i].c0; c <= _runs[i].c1; c++) {
+                cat::pixel px(c, _runs[i].row);
+                px.tsp(t);
+                cl.add(px);
+            }
+        }
+        for (std::size_t i = first; i < out.size(); i++) out[i].update();
+        std::memset(&_plane[static_cast<std::size_t>(r0) * W], 0,
+                    sizeof(uint64_t) * W * (r1 - r0 + 1));
+        return out.size() - first;
+    }
+
+private:
+
+    // Pixel run in a frame row.
+    struct span { int row; int c0; int c1; };
+
+    static constexpr uint32_t SKIP = 0xFFFFFFFF;
+
+    // Geometry.
+    G _g;
+
+    // Data-driven grid.
+    std::vector<uint32_t> _stamp;   // Generation of the last write.
+    std::vector<uint32_t> _slot;    // Last batch pixel seen.
+    uint32_t _gen;                  // Current generation.
+
+    // Frame bit-plane.
+    std::vector<uint64_t> _plane;
+    std::vector<span> _runs;
+
+    // Union-find.
+    std::vector<uint32_t> _parent;
+    std::vector<uint32_t> _label;
+
+    //__________________________________________________________________________
+    uint32_t find(uint32_t i)
+    {
+        /* Root of \c i, halving the path. */
+        while (_parent[i] != i) {
+            _parent[i] = _parent[_parent[i]];
+            i = _parent[i];
+        }
+        return i;
+    }
+
+    //__________________________________________________________________________
+    void unite(const uint32_t& a, const uint32_t& b)
+    {
+        /* Joins the sets of \c a and \c b, the lower index being the root. */
+        const uint32_t ra = find(a);
+        const uint32_t rb = find(b);
+        if (ra < rb) _parent[rb] = ra;
+        else if (rb < ra) _parent[ra] = rb;
+    }
+};
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::clusterer::clusterer(const int& cols, const int& rows, const long& window) :
+    _cols(cols),
+    _rows(rows),
+    _window(window)
+{
+    /*! Ctor. Sets up the kernels for a \c cols x \c rows sensor, the fixed
+        geometry ones if matching. \c window is the largest time distance
+        between touching pixels of the same cluster (data-driven path).
+    */
+    if (cols <= 0 || rows <= 0) throw std::runtime_error{ "clusterer: invalid geometry" };
+    if (window < 0) throw std::runtime_error{ "clusterer: negative time window" };
+    _engine.reset(cat::dispatch(cols, rows, [](auto g) -> engine* {
+        return new kernel<decltype(g)>(g);
+    }));
+}
+
+//______________________________________________________________________________
+cat::clusterer::~clusterer()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::clusterer::cols() const
+{
+    /*! Returns the number of columns. */
+    return _cols;
+}
+
+//______________________________________________________________________________
+int cat::clusterer::rows() const
+{
+    /*! Returns the number of rows. */
+    return _rows;
+}
+
+//______________________________________________________________________________
+bool cat::clusterer::fixed() const
+{
+    /*! Returns true if the kernels run a fixed (compile-time) geometry. */
+    return _engine->fixed();
+}
+
+//______________________________________________________________________________
+long cat::clusterer::window() const
+{
+    /*! Returns the time window of the data-driven path. */
+    return _window;
+}
+
+//______________________________________________________________________________
+void cat::clusterer::window(const long& w)
+{
+    /*! Sets the time window of the data-driven path. */
+    if (w < 0) throw std::runtime_error{ "clusterer: negative time window" };
+    _window = w;
+}
+
+//______________________________________________________________________________
+std::size_t cat::clusterer::run(const cat::batch& b, std::vector<cat::cluster>& out)
+{
+    /*! Clusters the time ordered pixels of \c b, appending the clusters to
+        \c out. Returns the number of clusters found. Pixels out of the sensor
+        are dropped.
+    */
+    return _engine->run(b, _window, out);
+}
+
+//______________________________________________________________________________
+std::size_t cat::clusterer::frame(const cat::batch& b, std::vector<cat::cluster>& out)
+{
+    /*! Clusters the frame \c b (timestamps are ignored but the earliest),
+        appending the clusters to \c out. Returns the number of clusters found.
+    */
+    return _engine->frame(b, out);
+}
@@ -0,0 +1,95 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel clustering                             --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"clusterer.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'clusterer' object groups the pixels of a 'batch' into 'cluster's of
+// 8-connected pixels. The labeling kernels are templates over the sensor
+// 'geometry', and the clusterer picks at construction the instantiation
+// matching the sensor (see 'dispatch'), so the fixed geometries get shift
+// index math and constant bounds. Two paths:
+//	- 'run', for data-driven sensors: the pixels (time ordered) are merged by
+//	  union-find with their neighbours last seen within the time 'window',
+//	  looked up in a stamped pixel grid which needs no clearing per batch;
+//	- 'frame', for frame-based sensors: the whole batch is a frame, set as a
+//	  bit-plane of 64 column words per row. Runs of adjacent pixels are
+//	  extracted a word at a time (start/end bit masks), and the runs of
+//	  consecutive rows are merged by union-find. The frame pixels are digital
+//	  and share the earliest batch timestamp.
+// A clusterer keeps its scratch memory between batches, so use one per thread.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef clusterer_HPP
+#define clusterer_HPP
+
+// Application units.
+#include "batch.hpp"
+#include "cluster.hpp"
+#include "geometry.hpp"
+
+// Standard library
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class clusterer; }
+class cat::clusterer
+{
+
+public:
+
+	// Special members.
+	clusterer(const int&, const int&, const long& = 0);	//!< Ctor.
+	~clusterer();					//!< Dtor.
+
+	// No copy allowed, the kernel scratch is private.
+	clusterer(const clusterer&) = delete;
+	clusterer& operator=(const clusterer&) = delete;
+
+	// Properties.
+	int cols() const;				//!< Retrieve the number of columns.
+	int rows() const;				//!< Retrieve the number of rows.
+	bool fixed() const;				//!< Whether the geometry is a fixed one.
+	long window() const;			//!< Retrieve the time window.
+	void window(const long&);		//!< Set the time window.
+
+	// Clustering (clusters are appended).
+	std::size_t run(const cat::batch&, std::vector<cat::cluster>&);		//!< Cluster a data-driven batch.
+	std::size_t frame(const cat::batch&, std::vector<cat::cluster>&);	//!< Cluster a frame.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Kernels.
+	class engine;
+	template <typename G> class kernel;
+	std::unique_ptr<engine> _engine;
+
+	// Settings.
+	int _cols;						// Columns count.
+	int _rows;						// Rows count.
+	long _window;					// Time window for the data-driven path.
+};
+
+// Overloading check
+#endif
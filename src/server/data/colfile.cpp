@@ -0,0 +1,497 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Columnar data file                           --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"colfile.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "colfile.hpp"
+
+// Standard library
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+// Platform
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+namespace {
+
+    // File format constants.
+    const char MAGIC[4] = { 'C', 'A', 'T', 'C' };
+    const uint32_t VERSION = 1;
+
+    //______________________________________________________________________________
+    template <typename T> void store(std::ofstream& f, const T& v)
+    {
+        /* Writes a plain value. */
+        f.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    //______________________________________________________________________________
+    template <typename T> T load(const unsigned char* p)
+    {
+        /* Reads a plain value (no alignment assumed). */
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return v;
+    }
+
+    //______________________________________________________________________________
+    void deltaEncode(const std::vector<int64_t>& v, std::vector<unsigned char>& out)
+    {
+        /* Delta + zigzag + LEB128 varint: small differences take one byte. */
+        out.clear();
+        int64_t prev = 0;
+        for (const int64_t& x : v) {
+            const int64_t d = x - prev;
+            prev = x;
+            uint64_t z = (static_cast<uint64_t>(d) << 1) ^ static_cast<uint64_t>(d >> 63);
+            while (z >= 0x80) {
+                out.push_back(static_cast<unsigned char>(z | 0x80));
+                z >>= 7;
+            }
+            out.push_back(static_cast<unsigned char>(z));
+        }
+    }
+
+    //______________________________________________________________________________
+    void deltaDecode(const unsigned char* p, const std::size_t& bytes,
+                     const std::size_t& rows, std::vector<int64_t>& v)
+    {
+        /* Inverse of 'deltaEncode'. */
+        v.resize(rows);
+        const unsigned char* end = p + bytes;
+        int64_t prev = 0;
+        for (std::size_t i = 0; i < rows; i++) {
+            uint64_t z = 0;
+            unsigned s = 0;
+            for (;;) {
+                if (p >= end || s >= 64) throw std::runtime_error{ "colfile: corrupted block" };
+                const unsigned char c = *p++;
+                // The 10th byte holds the 64th bit only.
+                if (s == 63 && c > 1) throw std::runtime_error{ "colfile: corrupted block" };
+                z |= static_cast<uint64_t>(c & 0x7F) << s;
+                if (!(c & 0x80)) break;
+                s += 7;
+            }
+            prev += static_cast<int64_t>((z >> 1) ^ (~(z & 1) + 1));
+            v[i] = prev;
+        }
+    }
+}
+
+//______________________________________________________________________________
+const std::vector<cat::colfile::column>& cat::colfile::columns(const kind& k)
+{
+    /*! Returns the columns stored for the content kind \c k, in file order. */
+    static const std::vector<column> cl = {
+        C_COL, C_ROW, C_TSP, C_MULT, C_MASS, C_WIDTH, C_HEIGHT,
+        C_LEFT, C_RIGHT, C_BOTTOM, C_TOP, C_CHARGE
+    };
+    static const std::vector<column> ht = { C_X, C_Y, C_Z, C_T };
+    return (k == K_CLUSTER) ? cl : ht;
+}
+
+//______________________________________________________________________________
+bool cat::colfile::isFloat(const column& c)
+{
+    /*! Returns true if the column \c c holds floats, false for integers. */
+    return c == C_COL || c == C_ROW || c == C_X || c == C_Y || c == C_Z || c == C_CHARGE;
+}
+
+
+// *****************************************************************************
+// **                            Writer                                       **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::colfile::writer::writer(const std::string& path, const kind& k, const uint32_t& chunk, const bool& compress) :
+    _kind(k),
+    _chunk(chunk ? chunk : 1),
+    _compress(compress),
+    _rows(0),
+    _pending(0)
+{
+    /*! Ctor. Creates the file at \c path for \c k content, grouping rows in
+        chunks of \c chunk rows, and trying to compress the integer blocks if
+        \c compress is true.
+    */
+    _file.open(path, std::ios::binary | std::ios::trunc);
+    if (!_file) throw std::runtime_error{ "colfile: cannot create " + path };
+
+    // Header.
+    const std::vector<column>& cols = columns(_kind);
+    _file.write(MAGIC, 4);
+    store<uint32_t>(_file, VERSION);
+    store<uint32_t>(_file, _kind);
+    store<uint32_t>(_file, static_cast<uint32_t>(cols.size()));
+    store<uint32_t>(_file, _chunk);
+    for (const column& c : cols) store<uint32_t>(_file, c);
+
+    // Columns buffers.
+    _int.resize(cols.size());
+    _flt.resize(cols.size());
+    for (std::size_t i = 0; i < cols.size(); i++) {
+        if (isFloat(cols[i])) _flt[i].reserve(_chunk);
+        else _int[i].reserve(_chunk);
+    }
+}
+
+//______________________________________________________________________________
+cat::colfile::writer::~writer()
+{
+    /*! Dtor. Closes the file, if not closed yet. */
+    try {
+        close();
+    }
+    catch (...) {}
+}
+
+//______________________________________________________________________________
+void cat::colfile::writer::put(const column& c, const int64_t& v)
+{
+    /* Appends an integer value to the pending column \c c. */
+    const std::vector<column>& cols = columns(_kind);
+    _int[std::find(cols.begin(), cols.end(), c) - cols.begin()].push_back(v);
+}
+
+//______________________________________________________________________________
+void cat::colfile::writer::put(const column& c, const float& v)
+{
+    /* Appends a float value to the pending column \c c. */
+    const std::vector<column>& cols = columns(_kind);
+    _flt[std::find(cols.begin(), cols.end(), c) - cols.begin()].push_back(v);
+}
+
+//______________________________________________________________________________
+void cat::colfile::writer::flush()
+{
+    /* Writes the pending chunk, one block per column, and indexes it. */
+    if (!_pending) return;
+    const std::vector<column>& cols = columns(_kind);
+
+    // Time range, from the timestamp column.
+    const std::size_t ti = std::find(cols.begin(), cols.end(),
+                                     _kind == K_CLUSTER ? C_TSP : C_T) - cols.begin();
+    const auto mm = std::minmax_element(_int[ti].begin(), _int[ti].end());
+    _chunks.push_back({ _pending, *mm.first, *mm.second });
+
+    // Blocks.
+    std::vector<unsigned char> packed;
+    for (std::size_t i = 0; i < cols.size(); i++) {
+        block b{ static_cast<uint64_t>(_file.tellp()), 0, Z_RAW };
+        if (isFloat(cols[i])) {
+            b.bytes = _flt[i].size() * sizeof(float);
+            _file.write(reinterpret_cast<const char*>(_flt[i].data()), b.bytes);
+            _flt[i].clear();
+        } else {
+            b.bytes = _int[i].size() * sizeof(int64_t);
+            if (_compress) deltaEncode(_int[i], packed);
+            if (_compress && packed.size() < b.bytes) {
+                b.codec = Z_DELTA;
+                b.bytes = packed.size();
+                _file.write(reinterpret_cast<const char*>(packed.data()), b.bytes);
+            } else {
+                _file.write(reinterpret_cast<const char*>(_int[i].data()), b.bytes);
+            }
+            _int[i].clear();
+        }
+        _blocks.push_back(b);
+    }
+    _pending = 0;
+    if (!_file) throw std::runtime_error{ "colfile: cannot write chunk" };
+}
+
+//______________________________________________________________________________
+void cat::colfile::writer::add(const cat::cluster& cl)
+{
+    /*! Adds the cluster \c cl. Throws if the file is not a cluster file. */
+    if (_kind != K_CLUSTER) throw std::runtime_error{ "colfile: not a cluster file" };
+    put(C_COL, cl.col());
+    put(C_ROW, cl.row());
+    put(C_TSP, static_cast<int64_t>(cl.tsp()));
+    put(C_MULT, static_cast<int64_t>(cl.mult()));
+    put(C_MASS, static_cast<int64_t>(cl.mass()));
+    put(C_WIDTH, static_cast<int64_t>(cl.width()));
+    put(C_HEIGHT, static_cast<int64_t>(cl.height()));
+    put(C_LEFT, static_cast<int64_t>(cl.left()));
+    put(C_RIGHT, static_cast<int64_t>(cl.right()));
+    put(C_BOTTOM, static_cast<int64_t>(cl.bottom()));
+    put(C_TOP, static_cast<int64_t>(cl.top()));
+    put(C_CHARGE, cl.charge());
+    _rows++;
+    if (++_pending == _chunk) flush();
+}
+
+//______________________________________________________________________________
+void cat::colfile::writer::add(const cat::hit& ht)
+{
+    /*! Adds the hit \c ht. Throws if the file is not a hit file. */
+    if (_kind != K_HIT) throw std::runtime_error{ "colfile: not a hit file" };
+    put(C_X, ht.x());
+    put(C_Y, ht.y());
+    put(C_Z, ht.z());
+    put(C_T, static_cast<int64_t>(ht.t()));
+    _rows++;
+    if (++_pending == _chunk) flush();
+}
+
+//______________________________________________________________________________
+void cat::colfile::writer::close()
+{
+    /*! Writes the last chunk and the index, then closes the file. Nothing is
+        added afterwards. Throws if any write failed (e.g. disk full), as the
+        file is then unusable.
+    */
+    if (!_file.is_open()) return;
+    flush();
+
+    // Footer.
+    const uint64_t footer = static_cast<uint64_t>(_file.tellp());
+    const std::size_t nc = columns(_kind).size();
+    for (std::size_t i = 0; i < _chunks.size(); i++) {
+        store<uint32_t>(_file, _chunks[i].rows);
+        store<int64_t>(_file, _chunks[i].tspMin);
+        store<int64_t>(_file, _chunks[i].tspMax);
+        for (std::size_t c = 0; c < nc; c++) {
+            const block& b = _blocks[i * nc + c];
+            store<uint64_t>(_file, b.offset);
+            store<uint64_t>(_file, b.bytes);
+            store<uint32_t>(_file, b.codec);
+        }
+    }
+
+    // Tail.
+    store<uint64_t>(_file, footer);
+    store<uint64_t>(_file, static_cast<uint64_t>(_chunks.size()));
+    _file.write(MAGIC, 4);
+    if (!_file) throw std::runtime_error{ "colfile: cannot write index" };
+    _file.close();
+    if (!_file) throw std::runtime_error{ "colfile: cannot close file" };
+}
+
+//______________________________________________________________________________
+uint64_t cat::colfile::writer::rows() const
+{
+    /*! Returns the number of rows added so far. */
+    return _rows;
+}
+
+
+// *****************************************************************************
+// **                            Reader                                       **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::colfile::reader::reader(const std::string& path) :
+    _data(nullptr),
+    _bytes(0),
+    _mapped(false),
+    _kind(K_CLUSTER),
+    _rows(0)
+{
+    /*! Ctor. Opens the file at \c path and loads its index; the data blocks
+        are read only when requested.
+    */
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error{ "colfile: cannot open " + path };
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        ::close(fd);
+        throw std::runtime_error{ "colfile: cannot stat " + path };
+    }
+    _bytes = static_cast<std::size_t>(st.st_size);
+    if (_bytes) {
+        void* p = ::mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error{ "colfile: cannot map " + path };
+        }
+        ::madvise(p, _bytes, MADV_RANDOM);
+        _data = static_cast<const unsigned char*>(p);
+        _mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error{ "colfile: cannot open " + path };
+    _bytes = static_cast<std::size_t>(file.tellg());
+    _buffer.resize(_bytes);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(_buffer.data()), _bytes);
+    _data = _buffer.data();
+#endif
+
+    // Header and tail sanity.
+    const std::size_t tail = 8 + 8 + 4;
+    if (_bytes < 20 + tail || std::memcmp(_data, MAGIC, 4) ||
+        std::memcmp(_data + _bytes - 4, MAGIC, 4)) {
+        unmap();
+        throw std::runtime_error{ "colfile: not a columnar file " + path };
+    }
+    if (load<uint32_t>(_data + 4) != VERSION) {
+        unmap();
+        throw std::runtime_error{ "colfile: unsupported version in " + path };
+    }
+
+    // Header.
+    _kind = static_cast<kind>(load<uint32_t>(_data + 8));
+    const uint32_t nc = load<uint32_t>(_data + 12);
+    if (20 + 4 * static_cast<uint64_t>(nc) > _bytes - tail) {
+        unmap();
+        throw std::runtime_error{ "colfile: corrupted header in " + path };
+    }
+    for (uint32_t c = 0; c < nc; c++) {
+        _columns.push_back(static_cast<column>(load<uint32_t>(_data + 20 + 4 * c)));
+    }
+
+    // Index.
+    const uint64_t footer = load<uint64_t>(_data + _bytes - tail);
+    const uint64_t count = load<uint64_t>(_data + _bytes - tail + 8);
+    if (footer > _bytes - tail || count * (20 + 20 * static_cast<uint64_t>(nc)) > _bytes - tail - footer) {
+        unmap();
+        throw std::runtime_error{ "colfile: corrupted index in " + path };
+    }
+    const unsigned char* p = _data + footer;
+    for (uint64_t i = 0; i < count; i++) {
+        chunk ch{ load<uint32_t>(p), load<int64_t>(p + 4), load<int64_t>(p + 12) };
+        p += 20;
+        _chunks.push_back(ch);
+        _rows += ch.rows;
+        for (uint32_t c = 0; c < nc; c++) {
+            _blocks.push_back({ load<uint64_t>(p), load<uint64_t>(p + 8), load<uint32_t>(p + 16) });
+            p += 20;
+        }
+    }
+}
+
+//______________________________________________________________________________
+cat::colfile::reader::~reader()
+{
+    /*! Dtor. Releases the mapping. */
+    unmap();
+}
+
+//______________________________________________________________________________
+void cat::colfile::reader::unmap()
+{
+    /* Releases the mapping, or the fallback storage. */
+#if !defined(_WIN32)
+    if (_mapped) ::munmap(const_cast<unsigned char*>(_data), _bytes);
+#endif
+    _buffer.clear();
+    _mapped = false;
+    _data = nullptr;
+}
+
+//______________________________________________________________________________
+const cat::colfile::block& cat::colfile::reader::find(const std::size_t& ch, const column& c) const
+{
+    /* Returns the block of column \c c in chunk \c ch. */
+    if (ch >= _chunks.size()) throw std::runtime_error{ "colfile: chunk out of range" };
+    const auto it = std::find(_columns.begin(), _columns.end(), c);
+    if (it == _columns.end()) throw std::runtime_error{ "colfile: column not stored" };
+    return _blocks[ch * _columns.size() + (it - _columns.begin())];
+}
+
+//______________________________________________________________________________
+cat::colfile::kind cat::colfile::reader::content() const
+{
+    /*! Returns the file content kind. */
+    return _kind;
+}
+
+//______________________________________________________________________________
+std::size_t cat::colfile::reader::chunks() const
+{
+    /*! Returns the number of chunks. */
+    return _chunks.size();
+}
+
+//______________________________________________________________________________
+uint64_t cat::colfile::reader::rows() const
+{
+    /*! Returns the total number of rows. */
+    return _rows;
+}
+
+//______________________________________________________________________________
+const cat::colfile::chunk& cat::colfile::reader::info(const std::size_t& ch) const
+{
+    /*! Returns the index entry (rows, time range) of chunk \c ch. */
+    return _chunks.at(ch);
+}
+
+//______________________________________________________________________________
+bool cat::colfile::reader::has(const column& c) const
+{
+    /*! Returns true if the column \c c is stored in the file. */
+    return std::find(_columns.begin(), _columns.end(), c) != _columns.end();
+}
+
+//______________________________________________________________________________
+std::vector<std::size_t> cat::colfile::reader::select(const int64_t& t0, const int64_t& t1) const
+{
+    /*! Returns the chunks which may hold rows with timestamp within [t0, t1],
+        from the index only. Rows in the returned chunks still need to be
+        checked against the range.
+    */
+    std::vector<std::size_t> sel;
+    for (std::size_t i = 0; i < _chunks.size(); i++) {
+        if (_chunks[i].tspMax >= t0 && _chunks[i].tspMin <= t1) sel.push_back(i);
+    }
+    return sel;
+}
+
+//______________________________________________________________________________
+void cat::colfile::reader::read(const std::size_t& ch, const column& c, std::vector<int64_t>& v) const
+{
+    /*! Reads the integer column \c c of chunk \c ch into \c v. */
+    if (isFloat(c)) throw std::runtime_error{ "colfile: not an integer column" };
+    const block& b = find(ch, c);
+    const std::size_t rows = _chunks[ch].rows;
+    if (b.offset + b.bytes > _bytes) throw std::runtime_error{ "colfile: corrupted index" };
+    if (b.codec == Z_DELTA) {
+        deltaDecode(_data + b.offset, b.bytes, rows, v);
+    } else {
+        if (b.bytes != rows * sizeof(int64_t)) throw std::runtime_error{ "colfile: corrupted block" };
+        v.resize(rows);
+        std::memcpy(v.data(), _data + b.offset, b.bytes);
+    }
+}
+
+//______________________________________________________________________________
+void cat::colfile::reader::read(const std::size_t& ch, const column& c, std::vector<float>& v) const
+{
+    /*! Reads the float column \c c of chunk \c ch into \c v. */
+    if (!isFloat(c)) throw std::runtime_error{ "colfile: not a float column" };
+    const block& b = find(ch, c);
+    const std::size_t rows = _chunks[ch].rows;
+    if (b.offset + b.bytes > _bytes || b.bytes != rows * sizeof(float)) {
+        throw std::runtime_error{ "colfile: corrupted block" };
+    }
+    v.resize(rows);
+    std::memcpy(v.data(), _data + b.offset, b.bytes);
+}
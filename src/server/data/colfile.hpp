@@ -0,0 +1,201 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Columnar data file                           --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"colfile.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'colfile' is the binary, columnar container for 'cluster' and 'hit'
+// collections, meant for offline analysis over large amounts of data.
+// Rows are grouped in fixed size chunks, and every chunk stores each column
+// (col, row, tsp, mult, ...) as a separate block, so a reader touches just
+// the columns it needs. Integer blocks may be compressed by delta + varint
+// encoding (very effective on time ordered timestamps), picked per block only
+// when it actually saves space.
+// A footer at the end of the file indexes every chunk by its timestamp range
+// and every block by its offset, so a reader can skip whole chunks by time
+// without reading them. The reader maps the file in memory: the pages of
+// skipped chunks and unread columns are never loaded.
+//
+// Layout (host byte order, i.e. little endian on every platform CAT targets;
+// files are not portable to big endian hosts):
+//	header:	"CATC", version, kind, columns, chunk rows, columns ids.
+//	chunks:	blocks, in columns order.
+//	footer:	per chunk rows, tsp min/max, and per block offset/size/codec.
+//	tail:	footer offset, chunks count, "CATC".
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef colfile_HPP
+#define colfile_HPP
+
+// Application units.
+#include "cluster.hpp"
+#include "hit.hpp"
+
+// Standard library
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+
+
+//______________________________________________________________________________
+namespace cat { class colfile; }
+class cat::colfile
+{
+
+public:
+
+	// Content kind.
+	enum kind : uint32_t {
+		K_CLUSTER = 1,
+		K_HIT = 2
+	};
+
+	// Columns.
+	enum column : uint32_t {
+		C_COL = 0, C_ROW, C_TSP, C_MULT, C_MASS, C_WIDTH, C_HEIGHT,
+		C_LEFT, C_RIGHT, C_BOTTOM, C_TOP,
+		C_X, C_Y, C_Z, C_T, C_CHARGE
+	};
+
+	// Blocks encoding.
+	enum codec : uint32_t {
+		Z_RAW = 0,		// Plain values.
+		Z_DELTA = 1		// Delta + zigzag + varint (integer columns only).
+	};
+
+	// Chunk index entry.
+	struct chunk {
+		uint32_t rows;		// Rows in the chunk.
+		int64_t tspMin;		// Smallest timestamp.
+		int64_t tspMax;		// Largest timestamp.
+	};
+
+	// Block index entry.
+	struct block {
+		uint64_t offset;	// Position in the file [bytes].
+		uint64_t bytes;		// Size [bytes].
+		uint32_t codec;		// Encoding.
+	};
+
+	// Columns of a kind, in storage order.
+	static const std::vector<column>& columns(const kind&);
+	static bool isFloat(const column&);
+
+	class writer;
+	class reader;
+};
+
+
+//______________________________________________________________________________
+class cat::colfile::writer
+{
+
+public:
+
+	// Special members.
+	writer(const std::string&, const kind&, const uint32_t& = 65536, const bool& = true);	//!< Ctor.
+	~writer();					//!< Dtor (closes the file).
+
+	// No copy allowed.
+	writer(const writer&) = delete;
+	writer& operator=(const writer&) = delete;
+
+	// Filling.
+	void add(const cat::cluster&);	//!< Add a cluster (cluster files).
+	void add(const cat::hit&);		//!< Add a hit (hit files).
+	void close();					//!< Flush and write the index.
+
+	// Properties.
+	uint64_t rows() const;		//!< Rows written so far.
+
+private:
+
+	// Support routines.
+	void flush();				// Write the pending chunk.
+	void put(const column&, const int64_t&);
+	void put(const column&, const float&);
+
+	// File.
+	std::ofstream _file;
+	kind _kind;
+	uint32_t _chunk;			// Rows per chunk.
+	bool _compress;				// Try delta encoding on integer blocks.
+	uint64_t _rows;				// Total rows.
+
+	// Pending chunk, one buffer per column (only one of the two in use).
+	std::vector<std::vector<int64_t>> _int;
+	std::vector<std::vector<float>> _flt;
+	uint32_t _pending;			// Rows in the pending chunk.
+
+	// Index.
+	std::vector<chunk> _chunks;
+	std::vector<block> _blocks;
+};
+
+
+//______________________________________________________________________________
+class cat::colfile::reader
+{
+
+public:
+
+	// Special members.
+	reader(const std::string&);	//!< Ctor.
+	~reader();					//!< Dtor.
+
+	// No copy allowed, the reader owns the mapping.
+	reader(const reader&) = delete;
+	reader& operator=(const reader&) = delete;
+
+	// Properties.
+	kind content() const;		//!< Retrieve the content kind.
+	std::size_t chunks() const;	//!< Retrieve the number of chunks.
+	uint64_t rows() const;		//!< Retrieve the total number of rows.
+	const chunk& info(const std::size_t&) const;	//!< Retrieve a chunk index entry.
+	bool has(const column&) const;	//!< Check if a column is stored.
+
+	// Selection.
+	std::vector<std::size_t> select(const int64_t&, const int64_t&) const;	//!< Chunks overlapping a time range.
+
+	// Reading.
+	void read(const std::size_t&, const column&, std::vector<int64_t>&) const;	//!< Read an integer column.
+	void read(const std::size_t&, const column&, std::vector<float>&) const;		//!< Read a float column.
+
+private:
+
+	// Support routines.
+	const block& find(const std::size_t&, const column&) const;
+	void unmap();
+
+	// File.
+	const unsigned char* _data;	// Mapped (or loaded) file.
+	std::size_t _bytes;			// File size.
+	std::vector<unsigned char> _buffer;	// Fallback storage, if no mapping.
+	bool _mapped;
+
+	// Header and index.
+	kind _kind;
+	std::vector<column> _columns;
+	std::vector<chunk> _chunks;
+	std::vector<block> _blocks;	// Chunk major.
+	uint64_t _rows;
+};
+
+// Overloading check
+#endif
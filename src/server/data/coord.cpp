@@ -14,8 +14,8 @@
 
 
 // Application units
-#include "../include/coord.hpp"
-#include "../include/caf.hpp"
+#include "coord.hpp"
+#include "caf.hpp"
 
 
 
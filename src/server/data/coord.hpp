@@ -48,12 +48,12 @@ public:
 	//friend std::ostream& operator<<(std::ostream&, cat::pixel&);
 		
 	// Methods.
-	inline float x() const;			//!< Retrieve x coordinate.
-	inline void x(const float&);	//!< Set x coordinate.
-	inline float y() const;			//!< Retrieve y coordinate.
-	inline void y(const float&);	//!< Set y coordinate.
-	inline float z() const;			//!< Retrieve z coordinate.
-	inline void z(const float&);	//!< Set z coordinate.
+	float x() const;				//!< Retrieve x coordinate.
+	void x(const float&);		//!< Set x coordinate.
+	float y() const;				//!< Retrieve y coordinate.
+	void y(const float&);		//!< Set y coordinate.
+	float z() const;				//!< Retrieve z coordinate.
+	void z(const float&);		//!< Set z coordinate.
 
 protected:
 
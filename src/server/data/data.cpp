@@ -14,7 +14,7 @@
 
 
 // Application units
-#include "../include/data.hpp"
+#include "data.hpp"
 
 
 // *****************************************************************************
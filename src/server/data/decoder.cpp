@@ -0,0 +1,146 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Raw readout decoder                          --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"decoder.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "decoder.hpp"
+#include "bitfield.hpp"
+
+// Standard library
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::decoder::decoder()
+{
+    /*! Ctor. */
+}
+
+//______________________________________________________________________________
+cat::decoder::~decoder()
+{
+    /*! Dtor. Nothing really to do. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+namespace {
+
+    //______________________________________________________________________________
+    std::map<uint32_t, cat::decoder::factory>& registry()
+    {
+        /* Returns the formats registry, built (with the built-in formats) at
+           first use, so that registering from static initializers is safe.
+        */
+        static std::map<uint32_t, cat::decoder::factory> reg = {
+            { cat::decoder::F_BITS32, [] {
+                return std::unique_ptr<cat::decoder>(new cat::bitfield({ 0, 10 }, { 10, 9 }, { 19, 13 }));
+            } },
+            { cat::decoder::F_BITS64, [] {
+                return std::unique_ptr<cat::decoder>(new cat::bitfield({ 0, 16 }, { 16, 16 }, { 32, 32 }));
+            } }
+        };
+        return reg;
+    }
+
+    //______________________________________________________________________________
+    std::mutex& registryLock()
+    {
+        /* Guards the registry, formats may be registered from any thread. */
+        static std::mutex lock;
+        return lock;
+    }
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::size_t cat::decoder::decode(const uint32_t*, const std::size_t&, cat::batch&)
+{
+    /*! Decodes 32 bit words, appending the pixels to the batch and returning
+        how many were appended. Formats not based on 32 bit words do not
+        overload it, and calling it is an error.
+    */
+    throw std::runtime_error{ "decoder: format does not support 32 bit words" };
+}
+
+//______________________________________________________________________________
+std::size_t cat::decoder::decode(const uint64_t*, const std::size_t&, cat::batch&)
+{
+    /*! Decodes 64 bit words, appending the pixels to the batch and returning
+        how many were appended. Formats not based on 64 bit words do not
+        overload it, and calling it is an error.
+    */
+    throw std::runtime_error{ "decoder: format does not support 64 bit words" };
+}
+
+//______________________________________________________________________________
+void cat::decoder::reset()
+{
+    /*! Resets any state carried across decode calls. Stateless formats have
+        nothing to do.
+    */
+}
+
+//______________________________________________________________________________
+bool cat::decoder::add(const uint32_t& id, const factory& f)
+{
+    /*! Registers the factory \c f for the format \c id. Returns false, leaving
+        the registry untouched, if the format is already registered.
+    */
+    std::lock_guard<std::mutex> lock(registryLock());
+    return registry().emplace(id, f).second;
+}
+
+//______________________________________________________________________________
+bool cat::decoder::has(const uint32_t& id)
+{
+    /*! Returns true if a decoder is registered for the format \c id. */
+    std::lock_guard<std::mutex> lock(registryLock());
+    return registry().count(id) > 0;
+}
+
+//______________________________________________________________________________
+std::unique_ptr<cat::decoder> cat::decoder::build(const uint32_t& id)
+{
+    /*! Builds a new decoder for the format \c id. Returns a void pointer if the
+        format is not registered.
+    */
+    factory f;
+    {
+        std::lock_guard<std::mutex> lock(registryLock());
+        auto it = registry().find(id);
+        if (it == registry().end()) return nullptr;
+        f = it->second;
+    }
+    return f();
+}
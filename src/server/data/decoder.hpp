@@ -0,0 +1,85 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Raw readout decoder                          --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"decoder.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'decoder' object is the interface turning raw readout words, as they
+// come from the DAQ link or from a file, into pixel 'batch' objects. Every
+// readout format is implemented by a 'decoder' derived class, registered
+// under a numeric format ID: the acquisition side only needs the format ID
+// to build the right decoder through 'build'.
+// A decoder may keep state across calls (e.g. the timestamp rollover
+// tracking), so each raw stream should use its own decoder instance, and
+// 'reset' it when the stream restarts.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef decoder_HPP
+#define decoder_HPP
+
+// Application units.
+#include "batch.hpp"
+
+// Standard library
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <functional>
+
+
+//______________________________________________________________________________
+namespace cat { class decoder; }
+class cat::decoder
+{
+
+public:
+
+	// Built-in formats.
+	enum format : uint32_t {
+		F_NULL = 0,
+		F_BITS32 = 1,		// 32 bit words: col[0:9], row[10:18], tsp[19:31].
+		F_BITS64 = 2		// 64 bit words: col[0:15], row[16:31], tsp[32:63].
+	};
+
+	// Decoder factory, as stored in the registry.
+	typedef std::function<std::unique_ptr<cat::decoder>()> factory;
+
+	// Special members.
+	decoder();					//!< Ctor.
+	virtual ~decoder();			//!< Dtor.
+
+	// Decoding.
+	virtual std::size_t decode(const uint32_t*, const std::size_t&, cat::batch&);	//!< Decode 32 bit words.
+	virtual std::size_t decode(const uint64_t*, const std::size_t&, cat::batch&);	//!< Decode 64 bit words.
+	virtual void reset();		//!< Reset the stream state.
+
+	// Formats registry.
+	static bool add(const uint32_t&, const factory&);			//!< Register a format.
+	static bool has(const uint32_t&);							//!< Check if a format is registered.
+	static std::unique_ptr<cat::decoder> build(const uint32_t&);	//!< Build a decoder by format.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// No private at the moment
+};
+
+// Overloading check
+#endif
@@ -0,0 +1,112 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Sensor geometry                              --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"geometry.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'geometry' template describes a sensor matrix for the pixel kernels
+// (clustering, hitmap filling...): the columns and rows count, the pixel
+// index in a rows major array, and the bounds check. The sensors we use come
+// in a few fixed geometries, which are compile-time instantiations: the
+// index math becomes a shift (power of two columns), and the bounds checks
+// compare against constants. The geometry<0, 0> specialization carries the
+// sizes at runtime, for any other sensor.
+// The 'dispatch' function picks the instantiation matching the runtime sizes
+// and calls a generic functor with it, so a kernel is written once as a
+// template over the geometry, and runs specialized wherever possible.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef geometry_HPP
+#define geometry_HPP
+
+// Standard library
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { template <int C, int R> struct geometry; }
+template <int C, int R> struct cat::geometry
+{
+	static_assert(C > 0 && (C & (C - 1)) == 0, "geometry: columns must be a power of two");
+	static_assert(R > 0, "geometry: rows must be positive");
+
+	// Columns shift.
+	static constexpr int shift() { int s = 0; while ((1 << s) < C) s++; return s; }
+
+	// Properties.
+	static constexpr int cols() { return C; }						//!< Columns count.
+	static constexpr int rows() { return R; }						//!< Rows count.
+	static constexpr int words() { return (C + 63) / 64; }			//!< 64 bit words per row.
+	static constexpr std::size_t size() { return std::size_t(C) * R; }	//!< Pixels count.
+
+	// Pixels.
+	static constexpr std::size_t index(const int& c, const int& r) {	//!< Rows major index.
+		return (std::size_t(r) << shift()) | std::size_t(c);
+	}
+	static constexpr bool inside(const int& c, const int& r) {		//!< Bounds check.
+		return static_cast<unsigned>(c) < unsigned(C) && static_cast<unsigned>(r) < unsigned(R);
+	}
+};
+
+
+//______________________________________________________________________________
+template <> struct cat::geometry<0, 0>
+{
+	// Runtime sizes.
+	int _cols;
+	int _rows;
+
+	// Ctor.
+	geometry(const int& c, const int& r) : _cols(c), _rows(r) {}
+
+	// Properties.
+	int cols() const { return _cols; }								//!< Columns count.
+	int rows() const { return _rows; }								//!< Rows count.
+	int words() const { return (_cols + 63) / 64; }					//!< 64 bit words per row.
+	std::size_t size() const { return std::size_t(_cols) * _rows; }	//!< Pixels count.
+
+	// Pixels.
+	std::size_t index(const int& c, const int& r) const {			//!< Rows major index.
+		return std::size_t(r) * _cols + c;
+	}
+	bool inside(const int& c, const int& r) const {					//!< Bounds check.
+		return static_cast<unsigned>(c) < unsigned(_cols) && static_cast<unsigned>(r) < unsigned(_rows);
+	}
+};
+
+
+//______________________________________________________________________________
+namespace cat {
+
+	// Fixed geometries.
+	typedef geometry<1024, 512> G1024x512;
+	typedef geometry<256, 256> G256x256;
+
+	//__________________________________________________________________________
+	template <typename F> auto dispatch(const int& cols, const int& rows, F&& f)
+	{
+		/*! Calls \c f with the geometry matching \c cols x \c rows: a fixed one
+			if any, the runtime one otherwise.
+		*/
+		if (cols == 1024 && rows == 512) return f(G1024x512());
+		if (cols == 256 && rows == 256) return f(G256x256());
+		return f(geometry<0, 0>(cols, rows));
+	}
+}
+
+// Overloading check
+#endif
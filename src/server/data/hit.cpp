@@ -14,8 +14,8 @@
 
 
 // Application units
-#include "../include/hit.hpp"
-#include "../include/caf.hpp"
+#include "hit.hpp"
+#include "caf.hpp"
 
 
 
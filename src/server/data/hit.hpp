@@ -27,9 +27,9 @@
 #define hit_HPP
 
 // Application units
-#include "../include/data.hpp"
-#include "../include/coord.hpp"
-#include "../include/cluster.hpp"
+#include "data.hpp"
+#include "coord.hpp"
+#include "cluster.hpp"
 
 // Standard library
 #include <iostream>
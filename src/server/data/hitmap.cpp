@@ -0,0 +1,207 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Hitmap accumulator                           --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"hitmap.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "hitmap.hpp"
+#include "geometry.hpp"
+
+// Standard library
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::hitmap::hitmap(const int& cols, const int& rows, const int& shards) :
+    _cols(cols),
+    _rows(rows),
+    _decay(1.0f),
+    _reset(false),
+    _fresh(false),
+    _version(0)
+{
+    /*! Ctor. \c cols and \c rows are the sensor dimensions, \c shards the
+        number of threads which will fill the map concurrently.
+    */
+    if (cols <= 0 || rows <= 0) throw std::runtime_error{ "hitmap: invalid dimensions" };
+    if (shards <= 0) throw std::runtime_error{ "hitmap: at least one shard needed" };
+
+    // Allocate everything upfront, nothing is resized later on.
+    const std::size_t size = static_cast<std::size_t>(cols) * rows;
+    _shard.assign(shards, std::vector<uint32_t>(size, 0));
+    _last.assign(size, 0);
+    _acc.assign(size, 0.0f);
+    _back.assign(size, 0.0f);
+    _front.assign(size, 0.0f);
+}
+
+//______________________________________________________________________________
+cat::hitmap::~hitmap()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+template <typename G>
+void cat::hitmap::count(const G& g, const int& shard, const cat::batch& b)
+{
+    /* Counts the pixels of \c b into the \c shard counters, with the index
+       math and bounds of the geometry \c g. Pixels out of the map are dropped.
+    */
+    uint32_t* s = _shard[shard].data();
+    const int* col = b.col();
+    const int* row = b.row();
+    const std::size_t n = b.size();
+    for (std::size_t i = 0; i < n; i++) {
+        if (!g.inside(col[i], row[i])) continue;
+        std::atomic_ref<uint32_t> c(s[g.index(col[i], row[i])]);
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::hitmap::cols() const
+{
+    /*! Returns the number of columns. */
+    return _cols;
+}
+
+//______________________________________________________________________________
+int cat::hitmap::rows() const
+{
+    /*! Returns the number of rows. */
+    return _rows;
+}
+
+//______________________________________________________________________________
+int cat::hitmap::shards() const
+{
+    /*! Returns the number of fill shards. */
+    return static_cast<int>(_shard.size());
+}
+
+//______________________________________________________________________________
+void cat::hitmap::fill(const int& shard, const cat::pixel& px)
+{
+    /*! Counts the pixel \c px into the \c shard counters. */
+    fill(shard, px.col(), px.row());
+}
+
+//______________________________________________________________________________
+void cat::hitmap::fill(const int& shard, const cat::batch& b)
+{
+    /*! Counts all the pixels of \c b into the \c shard counters. */
+    cat::dispatch(_cols, _rows, [&](auto g) { count(g, shard, b); });
+}
+
+//______________________________________________________________________________
+void cat::hitmap::decay(const float& decay)
+{
+    /*! Sets the factor the accumulated map is multiplied by at every merge,
+        before adding the new counts. 1 integrates forever, 0 shows only the
+        counts since the previous merge, anything in between gives a running
+        exponential window. Must be set from the merging thread.
+    */
+    _decay = decay < 0.0f ? 0.0f : (decay > 1.0f ? 1.0f : decay);
+}
+
+//______________________________________________________________________________
+float cat::hitmap::decay() const
+{
+    /*! Returns the current decay factor. */
+    return _decay;
+}
+
+//______________________________________________________________________________
+void cat::hitmap::reset()
+{
+    /*! Requests the accumulated map to be cleared. The request is served by
+        the next merge, so it can be issued from any thread; counts collected
+        before the merge are discarded as well.
+    */
+    _reset.store(true, std::memory_order_relaxed);
+}
+
+//______________________________________________________________________________
+void cat::hitmap::merge()
+{
+    /*! Sums the shards, accumulates the counts collected since the previous
+        merge and publishes the result as a new snapshot. Shard counters are
+        never cleared (which would race with the filling threads), the new
+        counts are the difference with the sum seen at the previous merge:
+        unsigned arithmetic keeps it right across counter wrap around.
+    */
+    const std::size_t size = _acc.size();
+    const bool reset = _reset.exchange(false, std::memory_order_relaxed);
+
+    // Single pass: sum the shards and accumulate the deltas.
+    for (std::size_t i = 0; i < size; i++) {
+        uint32_t sum = 0;
+        for (auto& shard : _shard) {
+            sum += std::atomic_ref<uint32_t>(shard[i]).load(std::memory_order_relaxed);
+        }
+        const uint32_t delta = sum - _last[i];
+        _last[i] = sum;
+        _acc[i] = reset ? 0.0f : _acc[i] * _decay + static_cast<float>(delta);
+    }
+
+    // Publish: only the buffers swap is done under lock.
+    _back.assign(_acc.begin(), _acc.end());
+    {
+        std::lock_guard<std::mutex> lock(_swap);
+        _back.swap(_front);
+        _fresh = true;
+    }
+    _version.fetch_add(1, std::memory_order_release);
+}
+
+//______________________________________________________________________________
+bool cat::hitmap::snapshot(std::vector<float>& map)
+{
+    /*! Swaps the latest published snapshot into \c map, handing the previous
+        content of \c map back as a spare buffer. No copy is made, the lock is
+        held just for the swap. Returns false (leaving \c map untouched) if no
+        new snapshot was published since the last call.
+    */
+    std::lock_guard<std::mutex> lock(_swap);
+    if (!_fresh) return false;
+    map.swap(_front);
+    _fresh = false;
+    return true;
+}
+
+//______________________________________________________________________________
+unsigned long cat::hitmap::version() const
+{
+    /*! Returns how many snapshots were published so far. */
+    return _version.load(std::memory_order_acquire);
+}
@@ -0,0 +1,129 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Hitmap accumulator                           --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"hitmap.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'hitmap' object accumulates the pixel occupancy of a sensor, a cols x
+// rows map of counters. Filling is meant to happen at full rate from several
+// threads (i.e. the clustering ones), so every thread owns a 'shard', a plain
+// private set of counters it increments without any lock or atomic RMW.
+// On demand (typically at display rate), 'merge' sums the shards into the
+// accumulated map, applying the decay/reset policy, and publishes the result
+// as a snapshot. Snapshots are double buffered: the display side swaps the
+// latest one out through 'snapshot', without ever touching the fill path.
+// MIND: each shard must be filled by a single thread, and 'merge' must be
+// called by a single thread at a time.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef hitmap_HPP
+#define hitmap_HPP
+
+// Application units.
+#include "pixel.hpp"
+#include "batch.hpp"
+
+// Standard library
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+
+//______________________________________________________________________________
+namespace cat { class hitmap; }
+class cat::hitmap
+{
+
+public:
+
+	// Special members.
+	hitmap(const int&, const int&, const int& = 1);	//!< Ctor.
+	~hitmap();						//!< Dtor.
+
+	// No copy allowed, shards are bound to their threads.
+	hitmap(const hitmap&) = delete;
+	hitmap& operator=(const hitmap&) = delete;
+
+	// Properties.
+	int cols() const;				//!< Retrieve the number of columns.
+	int rows() const;				//!< Retrieve the number of rows.
+	int shards() const;				//!< Retrieve the number of fill shards.
+
+	// Fill path (one thread per shard).
+	inline void fill(const int&, const int&, const int&);	//!< Count a hit.
+	void fill(const int&, const cat::pixel&);				//!< Count a pixel.
+	void fill(const int&, const cat::batch&);				//!< Count a batch.
+
+	// Accumulation policy.
+	void decay(const float&);		//!< Set the decay factor applied at each merge.
+	float decay() const;			//!< Retrieve the decay factor.
+	void reset();					//!< Clear the accumulated map at next merge.
+
+	// Display path.
+	void merge();								//!< Merge shards and publish a snapshot.
+	bool snapshot(std::vector<float>&);			//!< Swap out the latest snapshot.
+	unsigned long version() const;				//!< Retrieve the published snapshot version.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Dimensions.
+	int _cols;							// Columns count.
+	int _rows;							// Rows count.
+
+	// Fill shards, each one written by its own thread only.
+	std::vector<std::vector<uint32_t>> _shard;
+
+	// Accumulation.
+	std::vector<uint32_t> _last;		// Shards sum at the previous merge.
+	std::vector<float> _acc;			// Accumulated (decayed) map.
+	float _decay;						// Decay factor (1 = plain integration).
+	std::atomic<bool> _reset;			// Reset requested.
+
+	// Double buffered snapshot.
+	std::vector<float> _back;			// Snapshot being built.
+	std::vector<float> _front;			// Latest published snapshot.
+	bool _fresh;						// Front not yet taken.
+	std::atomic<unsigned long> _version;// Published snapshots count.
+	std::mutex _swap;					// Guards the front/back swap only.
+
+	// Support routines.
+	template <typename G> void count(const G&, const int&, const cat::batch&);
+};
+
+
+// *****************************************************************************
+// **                             Inline members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+inline void cat::hitmap::fill(const int& shard, const int& col, const int& row)
+{
+	/*! Counts a hit on pixel (\c col, \c row) into the \c shard counters. The
+		increment is a plain load/store, which is safe as the shard has a single
+		writer; the relaxed atomic access only keeps 'merge' reads well defined.
+	*/
+	std::atomic_ref<uint32_t> c(_shard[shard][row * _cols + col]);
+	c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// Overloading check
+#endif
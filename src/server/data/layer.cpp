@@ -14,8 +14,8 @@
 
 
 // Application units
-#include "../include/layer.hpp"
-#include "../include/caf.hpp"
+#include "layer.hpp"
+#include "caf.hpp"
 
 
 // *****************************************************************************
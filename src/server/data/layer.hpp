@@ -28,8 +28,8 @@
 #define layer_HPP
 
 // Application units.
-#include "../include/sensor.hpp"
-#include "../include/plane.hpp"
+#include "sensor.hpp"
+#include "plane.hpp"
 
 // Standard library
 #include <vector>
@@ -27,7 +27,7 @@
 #include <sstream>
 
 // Application units.
-#include "../include/caf.hpp"    // Console IO formatting.
+#include "caf.hpp"    // Console IO formatting.
 
 
 
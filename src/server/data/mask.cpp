@@ -0,0 +1,278 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel mask                                   --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"mask.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "mask.hpp"
+#include "caf.hpp"
+
+// Standard library
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::mask::mask(const int& cols, const int& rows) :
+    _cols(cols > 0 ? cols : 0),
+    _rows(rows > 0 ? rows : 0)
+{
+    /*! Ctor. Builds an empty (nothing masked) mask for a \c cols x \c rows
+        sensor.
+    */
+    _bits.assign((static_cast<std::size_t>(_cols) * _rows + 63) / 64, 0);
+}
+
+//______________________________________________________________________________
+cat::mask::mask(const cat::mask& m) :
+    _cols(m._cols),
+    _rows(m._rows),
+    _bits(m._bits)
+{
+    /*! Copy ctor. */
+}
+
+//______________________________________________________________________________
+cat::mask::~mask()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+template <typename T>
+std::size_t cat::mask::compact(cat::batch& b) const
+{
+    /* Compacts the unmasked pixels of \c b to its front. Every pixel is copied
+       down to the write position, which then advances only if the pixel is
+       kept: no branch depends on the data. The charges are moved too only
+       for the analog traits.
+    */
+    const std::size_t n = b.size();
+    int* col = b.col();
+    int* row = b.row();
+    long* tsp = b.tsp();
+    float* chg = b.charge();
+    const uint64_t* bits = _bits.data();
+    const unsigned cols = static_cast<unsigned>(_cols);
+    const unsigned rows = static_cast<unsigned>(_rows);
+
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const int c = col[i];
+        const int r = row[i];
+        const long t = tsp[i];
+        const bool in = static_cast<unsigned>(c) < cols && static_cast<unsigned>(r) < rows;
+        const std::size_t idx = in ? static_cast<std::size_t>(r) * cols + c : 0;
+        const bool keep = in & !((bits[idx >> 6] >> (idx & 63)) & 1);
+        col[k] = c;
+        row[k] = r;
+        tsp[k] = t;
+        if constexpr (T::charged) chg[k] = chg[i];
+        k += keep;
+    }
+    b.resize(k);
+    return n - k;
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::ostream& operator<<(std::ostream& os, const cat::mask& m)
+{
+    // Build {cols x rows: masked} like string.
+    os << "{" << cat::caf::fcol(C_CL_COL) << m.cols() << cat::caf::rst()
+       << " x " << cat::caf::fcol(C_CL_ROW) << m.rows() << cat::caf::rst()
+       << ": " << m.count() << " masked}";
+
+    // Return.
+    return os;
+}
+
+//______________________________________________________________________________
+cat::mask& cat::mask::operator=(const cat::mask& m)
+{
+    /*! Copy operator. */
+    _cols = m._cols;
+    _rows = m._rows;
+    _bits = m._bits;
+
+    // Return.
+    return *this;
+}
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::mask::cols() const
+{
+    /*! Returns the number of columns. */
+    return _cols;
+}
+
+//______________________________________________________________________________
+int cat::mask::rows() const
+{
+    /*! Returns the number of rows. */
+    return _rows;
+}
+
+//______________________________________________________________________________
+std::size_t cat::mask::count() const
+{
+    /*! Returns the number of masked pixels. */
+    std::size_t n = 0;
+    for (const uint64_t& w : _bits) n += std::popcount(w);
+    return n;
+}
+
+//______________________________________________________________________________
+bool cat::mask::test(const int& col, const int& row) const
+{
+    /*! Returns true if the pixel (\c col, \c row) is masked. Pixels outside
+        the sensor are always masked.
+    */
+    if (col < 0 || col >= _cols || row < 0 || row >= _rows) return true;
+    const std::size_t i = static_cast<std::size_t>(row) * _cols + col;
+    return (_bits[i >> 6] >> (i & 63)) & 1;
+}
+
+//______________________________________________________________________________
+void cat::mask::set(const int& col, const int& row, const bool& on)
+{
+    /*! Masks (\c on true) or unmasks the pixel (\c col, \c row). Pixels
+        outside the sensor are ignored.
+    */
+    if (col < 0 || col >= _cols || row < 0 || row >= _rows) return;
+    const std::size_t i = static_cast<std::size_t>(row) * _cols + col;
+    if (on) _bits[i >> 6] |= uint64_t(1) << (i & 63);
+    else _bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+}
+
+//______________________________________________________________________________
+void cat::mask::clear()
+{
+    /*! Unmasks all the pixels. */
+    std::fill(_bits.begin(), _bits.end(), 0);
+}
+
+//______________________________________________________________________________
+std::size_t cat::mask::filter(cat::batch& b) const
+{
+    /*! Removes from \c b the masked pixels, as well as those outside the
+        sensor, keeping the order of the others. Returns the number of pixels
+        removed.
+    */
+    const std::size_t n = b.size();
+    if (_bits.empty()) {
+        b.clear();
+        return n;
+    }
+    return b.analog() ? compact<cat::analog>(b) : compact<cat::digital>(b);
+}
+
+//______________________________________________________________________________
+std::size_t cat::mask::generate(const std::vector<float>& occ, const float& sigma, const int& iterations)
+{
+    /*! Rebuilds the mask from the \c occ occupancy map (rows major, as from
+        'hitmap::snapshot'), masking the pixels above the mean by more than
+        \c sigma standard deviations. Mean and deviation are computed over
+        the pixels not masked yet, repeating up to \c iterations times or
+        until no more pixels get masked. Returns the number of masked pixels.
+    */
+    const std::size_t n = static_cast<std::size_t>(_cols) * _rows;
+    if (occ.size() != n) throw std::runtime_error{ "mask: occupancy map size mismatch" };
+    clear();
+
+    for (int it = 0; it < iterations; it++) {
+
+        // Moments over the unmasked pixels.
+        double sum = 0, sum2 = 0;
+        std::size_t cnt = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            if ((_bits[i >> 6] >> (i & 63)) & 1) continue;
+            sum += occ[i];
+            sum2 += static_cast<double>(occ[i]) * occ[i];
+            cnt++;
+        }
+        if (!cnt) break;
+        const double mean = sum / cnt;
+        const double sd = std::sqrt(std::max(0.0, sum2 / cnt - mean * mean));
+        const double cut = mean + sigma * sd;
+
+        // Mask the outliers.
+        std::size_t added = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            if (occ[i] > cut && !((_bits[i >> 6] >> (i & 63)) & 1)) {
+                _bits[i >> 6] |= uint64_t(1) << (i & 63);
+                added++;
+            }
+        }
+        if (!added) break;
+    }
+
+    // Done.
+    return count();
+}
+
+//______________________________________________________________________________
+void cat::mask::save(const std::string& path) const
+{
+    /*! Saves the mask to the file \c path. */
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) throw std::runtime_error{ "mask: cannot create " + path };
+    f.write("CATM", 4);
+    f.write(reinterpret_cast<const char*>(&_cols), sizeof(_cols));
+    f.write(reinterpret_cast<const char*>(&_rows), sizeof(_rows));
+    f.write(reinterpret_cast<const char*>(_bits.data()), _bits.size() * sizeof(uint64_t));
+    if (!f) throw std::runtime_error{ "mask: cannot write " + path };
+}
+
+//______________________________________________________________________________
+cat::mask cat::mask::load(const std::string& path)
+{
+    /*! Loads a mask from the file \c path, as written by 'save'. */
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error{ "mask: cannot open " + path };
+    char magic[4];
+    int cols = 0, rows = 0;
+    f.read(magic, 4);
+    f.read(reinterpret_cast<char*>(&cols), sizeof(cols));
+    f.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+    if (!f || std::memcmp(magic, "CATM", 4) || cols < 0 || rows < 0) {
+        throw std::runtime_error{ "mask: not a mask file " + path };
+    }
+    cat::mask m(cols, rows);
+    f.read(reinterpret_cast<char*>(m._bits.data()), m._bits.size() * sizeof(uint64_t));
+    if (!f) throw std::runtime_error{ "mask: truncated file " + path };
+    return m;
+}
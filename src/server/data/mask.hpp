@@ -0,0 +1,101 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel mask                                   --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"mask.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'mask' object flags the hot/noisy pixels of a sensor, one bit per pixel
+// packed in 64 bit words (rows major, as the 'hitmap'). It is applied to the
+// pixel batches at the very front of the pipeline by 'filter', which
+// compacts the batch in place without branches, so its speed does not
+// depend on how many (or which) pixels are masked.
+// A mask can be generated from the hitmap occupancy by 'generate': pixels
+// exceeding the mean occupancy by more than a given number of sigmas are
+// masked, iterating a few times as the hot pixels themselves inflate the
+// mean and sigma. Masks are saved and loaded as small binary files.
+// A mask is immutable once in use: a 'sensor' holds it through a shared
+// pointer, and replacing it while running is just swapping the pointer.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef mask_HPP
+#define mask_HPP
+
+// Application units.
+#include "batch.hpp"
+
+// Standard library
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class mask; }
+class cat::mask
+{
+
+public:
+
+	// Special members.
+	mask(const int&, const int&);	//!< Ctor.
+	mask(const mask&);				//!< CCtor.
+	~mask();						//!< Dtor.
+
+	// Operators.
+	mask& operator=(const mask&);
+
+	// Properties.
+	int cols() const;				//!< Retrieve the number of columns.
+	int rows() const;				//!< Retrieve the number of rows.
+	std::size_t count() const;		//!< Retrieve the number of masked pixels.
+
+	// Single pixels.
+	bool test(const int&, const int&) const;	//!< Check if a pixel is masked.
+	void set(const int&, const int&, const bool& = true);	//!< Mask (or unmask) a pixel.
+	void clear();					//!< Unmask all.
+
+	// Filtering.
+	std::size_t filter(cat::batch&) const;	//!< Drop the masked pixels.
+
+	// Generation.
+	std::size_t generate(const std::vector<float>&, const float&, const int& = 4);	//!< Mask by occupancy.
+
+	// Persistency.
+	void save(const std::string&) const;	//!< Save to file.
+	static cat::mask load(const std::string&);	//!< Load from file.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	int _cols;						// Columns count.
+	int _rows;						// Rows count.
+	std::vector<uint64_t> _bits;	// Packed mask, rows major.
+
+	// Support routines.
+	template <typename T> std::size_t compact(cat::batch&) const;
+};
+
+//______________________________________________________________________________
+// Operators overload
+std::ostream& operator<<(std::ostream&, const cat::mask&);
+
+// Overloading check
+#endif
@@ -0,0 +1,315 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Acquisition pipeline                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"pipeline.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "pipeline.hpp"
+
+// Standard library
+#include <chrono>
+#include <stdexcept>
+
+
+namespace {
+
+    //______________________________________________________________________________
+    uint64_t elapsed(const std::chrono::steady_clock::time_point& t0)
+    {
+        /* Nanoseconds since \c t0. */
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+    }
+}
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::pipeline::pipeline(const std::size_t& frames) :
+    _pool(frames ? frames : 1),
+    _stop(false),
+    _running(0)
+{
+    /*! Ctor. \c frames is the number of frames in flight, i.e. how far the
+        source can run ahead of the last stage.
+    */
+    for (std::size_t i = 0; i < (frames ? frames : 1); i++) {
+        _frames.emplace_back(new frame());
+        _pool.push(_frames.back().get());
+    }
+
+    // The source node.
+    _node.emplace_back(new node());
+    _node[0]->name = "source";
+    _node[0]->workers = 1;
+}
+
+//______________________________________________________________________________
+cat::pipeline::~pipeline()
+{
+    /*! Dtor. Stops and joins all the threads. */
+    stop();
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::pipeline::idle(int& spin)
+{
+    /* Waits a little, yielding first and then sleeping, so that an idle stage
+       does not burn a core while a busy one reacts quickly.
+    */
+    if (++spin < 16) std::this_thread::yield();
+    else std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+//______________________________________________________________________________
+void cat::pipeline::forward(node& n, const std::size_t& i, frame* f)
+{
+    /* Pushes the frame \c f processed by stage \c i downstream, waiting while
+       the next queue is full (backpressure). The last stage gives the frame
+       back to the pool.
+    */
+    if (i + 1 == _node.size()) {
+        _pool.push(f);
+        return;
+    }
+
+    // Wait for room, accounting the stall.
+    cat::ring<frame*>& out = *_node[i + 1]->in;
+    if (out.push(f)) return;
+    const auto t0 = std::chrono::steady_clock::now();
+    int spin = 0;
+    while (!out.push(f)) {
+        if (_stop) {
+            _pool.push(f);
+            break;
+        }
+        idle(spin);
+    }
+    n.stalled += elapsed(t0);
+}
+
+//______________________________________________________________________________
+void cat::pipeline::produce()
+{
+    /* Source thread: takes free frames from the pool, has the source fill
+       them and sends them down the pipeline, until the source is over.
+    */
+    node& n = *_node[0];
+    uint64_t id = 0;
+    while (!_stop) {
+
+        // A free frame, waiting if all are in flight.
+        frame* f;
+        if (!_pool.pop(f)) {
+            const auto t0 = std::chrono::steady_clock::now();
+            int spin = 0;
+            while (!_stop && !_pool.pop(f)) idle(spin);
+            n.stalled += elapsed(t0);
+            if (_stop) break;
+        }
+
+        // Fill it.
+        f->id = id++;
+        f->pixels.clear();
+        f->clusters.clear();
+        f->hits.clear();
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool more = n.fn(*f);
+        n.busy += elapsed(t0);
+        if (!more) {
+            _pool.push(f);
+            break;
+        }
+        n.frames++;
+        n.pixels += f->pixels.size();
+        forward(n, 0, f);
+    }
+
+    // Done.
+    n.alive--;
+    _running--;
+}
+
+//______________________________________________________________________________
+void cat::pipeline::work(const std::size_t& i)
+{
+    /* Stage \c i worker thread: processes frames from the input queue until
+       the upstream stage is over and the queue drained.
+    */
+    node& n = *_node[i];
+    const node& up = *_node[i - 1];
+    int spin = 0;
+    while (!_stop) {
+
+        // Next frame. Upstream pushes all happen before it is flagged over,
+        // so one more try after seeing it over catches the last ones.
+        frame* f;
+        if (!n.in->pop(f)) {
+            if (up.alive == 0) {
+                if (!n.in->pop(f)) break;
+            } else {
+                idle(spin);
+                continue;
+            }
+        }
+        spin = 0;
+
+        // Process.
+        const std::size_t px = f->pixels.size();
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool keep = n.fn(*f);
+        n.busy += elapsed(t0);
+        n.frames++;
+        n.pixels += px;
+        if (keep) forward(n, i, f);
+        else _pool.push(f);
+    }
+
+    // Done.
+    n.alive--;
+    _running--;
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::pipeline::input(const std::string& name, const source& s)
+{
+    /*! Sets the pipeline source, named \c name: it is called with a cleared
+        frame to fill, and returns false when there is no more data.
+    */
+    if (running()) throw std::runtime_error{ "pipeline: cannot change a running pipeline" };
+    _node[0]->name = name;
+    _node[0]->fn = s;
+}
+
+//______________________________________________________________________________
+std::size_t cat::pipeline::stage(const std::string& name, const task& t, const int& workers, const std::size_t& capacity)
+{
+    /*! Appends the stage \c name running the task \c t on \c workers threads,
+        fed by a queue of \c capacity frames. Returns the stage index.
+    */
+    if (running()) throw std::runtime_error{ "pipeline: cannot change a running pipeline" };
+    _node.emplace_back(new node());
+    node& n = *_node.back();
+    n.name = name;
+    n.fn = t;
+    n.workers = workers > 0 ? workers : 1;
+    n.in.reset(new cat::ring<frame*>(capacity));
+    return _node.size() - 1;
+}
+
+//______________________________________________________________________________
+void cat::pipeline::start()
+{
+    /*! Starts the source and all the stages workers. A pipeline stopped, or
+        over, can be started again: all the frames go back to the pool, and
+        the counters restart from zero.
+    */
+    if (!_node[0]->fn) throw std::runtime_error{ "pipeline: no source" };
+    if (running()) return;
+    wait();
+
+    // Recollect all the frames, whatever they were left.
+    frame* f;
+    while (_pool.pop(f)) {}
+    for (std::size_t i = 1; i < _node.size(); i++) while (_node[i]->in->pop(f)) {}
+    for (auto& fr : _frames) _pool.push(fr.get());
+
+    // Reset the counters.
+    _stop = false;
+    for (auto& n : _node) {
+        n->alive = n->workers;
+        n->frames = 0;
+        n->pixels = 0;
+        n->busy = 0;
+        n->stalled = 0;
+    }
+
+    // Launch.
+    for (auto& n : _node) _running += n->workers;
+    _thread.emplace_back(&cat::pipeline::produce, this);
+    for (std::size_t i = 1; i < _node.size(); i++) {
+        for (int w = 0; w < _node[i]->workers; w++) _thread.emplace_back(&cat::pipeline::work, this, i);
+    }
+}
+
+//______________________________________________________________________________
+void cat::pipeline::stop()
+{
+    /*! Stops all the threads as soon as their current frame is done, dropping
+        the frames still queued, and waits for them.
+    */
+    _stop = true;
+    wait();
+}
+
+//______________________________________________________________________________
+void cat::pipeline::wait()
+{
+    /*! Waits until all the threads are over: the source exhausted and all the
+        stages drained (or the pipeline stopped).
+    */
+    for (auto& t : _thread) if (t.joinable()) t.join();
+    _thread.clear();
+}
+
+//______________________________________________________________________________
+bool cat::pipeline::running() const
+{
+    /*! Returns true while any of the threads is still working. */
+    return _running > 0;
+}
+
+//______________________________________________________________________________
+std::size_t cat::pipeline::stages() const
+{
+    /*! Returns the number of stages, the source included. */
+    return _node.size();
+}
+
+//______________________________________________________________________________
+cat::pipeline::stats cat::pipeline::stat(const std::size_t& i) const
+{
+    /*! Returns the counters of stage \c i (0 is the source). For the source,
+        the depth is the number of free frames in the pool: always zero means
+        the source is throttled by the stages downstream.
+    */
+    const node& n = *_node.at(i);
+    stats s;
+    s.name = n.name;
+    s.frames = n.frames;
+    s.pixels = n.pixels;
+    s.busy = static_cast<double>(n.busy) * 1e-9;
+    s.stalled = static_cast<double>(n.stalled) * 1e-9;
+    s.depth = n.in ? n.in->size() : _pool.size();
+    s.capacity = n.in ? n.in->capacity() : _frames.size();
+    return s;
+}
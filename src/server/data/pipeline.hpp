@@ -0,0 +1,148 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Acquisition pipeline                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"pipeline.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'pipeline' object runs the acquisition chain (decode, clustering, hits
+// building, histograms filling, publishing...) as a sequence of stages, each
+// one served by its own worker threads, joined by bounded lock-free 'ring'
+// queues. What flows along the pipeline is a 'frame': a pixel 'batch' plus
+// the clusters and hits derived from it, each stage filling what it needs.
+// Frames come from a fixed pool, and go back to it after the last stage: a
+// slow stage fills its input queue, which stalls the stage before it and so
+// on back to the source, which stops reading (backpressure), and nothing is
+// ever allocated in the steady state.
+// Every stage counts the frames and pixels processed, the time spent working
+// and the time spent stalled on a full output queue; together with the
+// queues depths, this tells which stage is the bottleneck.
+// A stage with more than one worker processes frames concurrently, hence it
+// does not preserve their order.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef pipeline_HPP
+#define pipeline_HPP
+
+// Application units.
+#include "batch.hpp"
+#include "cluster.hpp"
+#include "hit.hpp"
+#include "ring.hpp"
+
+// Standard library
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+
+//______________________________________________________________________________
+namespace cat { class pipeline; }
+class cat::pipeline
+{
+
+public:
+
+	// Unit of work flowing along the pipeline.
+	struct frame {
+		uint64_t id;						// Sequence number (from the source).
+		cat::batch pixels;					// Pixels.
+		std::vector<cat::cluster> clusters;	// Clusters from the pixels.
+		std::vector<cat::hit> hits;			// Hits from the clusters.
+	};
+
+	// Source: fills a frame, returns false when there is nothing more.
+	typedef std::function<bool(frame&)> source;
+
+	// Stage task: processes a frame, returns false to drop it.
+	typedef std::function<bool(frame&)> task;
+
+	// Stage counters.
+	struct stats {
+		std::string name;		// Stage name.
+		uint64_t frames;		// Frames processed.
+		uint64_t pixels;		// Pixels processed.
+		double busy;			// Time spent in the task [s].
+		double stalled;			// Time spent waiting on the output [s].
+		std::size_t depth;		// Frames in the input queue.
+		std::size_t capacity;	// Input queue capacity.
+	};
+
+	// Special members.
+	pipeline(const std::size_t& = 64);	//!< Ctor.
+	~pipeline();				//!< Dtor.
+
+	// No copy allowed.
+	pipeline(const pipeline&) = delete;
+	pipeline& operator=(const pipeline&) = delete;
+
+	// Setup (before 'start').
+	void input(const std::string&, const source&);		//!< Set the source.
+	std::size_t stage(const std::string&, const task&, const int& = 1, const std::size_t& = 16);	//!< Append a stage.
+
+	// Running.
+	void start();				//!< Start all the threads.
+	void stop();				//!< Stop as soon as possible.
+	void wait();				//!< Wait for the source end and the drain.
+	bool running() const;		//!< True while any thread is working.
+
+	// Monitoring.
+	std::size_t stages() const;	//!< Number of stages, source included.
+	stats stat(const std::size_t&) const;	//!< Counters of a stage (0 = source).
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Single stage (the source is stage 0).
+	struct node {
+		std::string name;
+		task fn;
+		int workers;
+		std::unique_ptr<cat::ring<frame*>> in;	// Input queue (void for the source).
+		std::atomic<int> alive;					// Workers still running.
+		std::atomic<uint64_t> frames;
+		std::atomic<uint64_t> pixels;
+		std::atomic<uint64_t> busy;				// [ns]
+		std::atomic<uint64_t> stalled;			// [ns]
+	};
+
+	// Support routines.
+	void produce();						// Source thread.
+	void work(const std::size_t&);		// Stage worker thread.
+	void forward(node&, const std::size_t&, frame*);	// Push downstream, waiting.
+	void idle(int&);					// Progressive backoff.
+
+	// Frames.
+	std::vector<std::unique_ptr<frame>> _frames;	// Owned frames.
+	cat::ring<frame*> _pool;			// Free frames.
+
+	// Stages and threads.
+	std::vector<std::unique_ptr<node>> _node;
+	std::vector<std::thread> _thread;
+	std::atomic<bool> _stop;
+	std::atomic<int> _running;			// Threads still running.
+};
+
+// Overloading check
+#endif
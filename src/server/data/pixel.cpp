@@ -14,8 +14,8 @@
 
 
 // Application units
-#include "../include/pixel.hpp"
-#include "../include/caf.hpp"
+#include "pixel.hpp"
+#include "caf.hpp"
 
 
 // *****************************************************************************
@@ -17,6 +17,11 @@
 // The 'pixel' object represents a sensor pixel, with its logical coordinates
 // (col, row) and timestamp (tsp). It provides basic object capabilities, 
 // including copy construction, assignment and ostream operators overload.
+// The charge of the pixels from analog (or ToT) sensors is not kept here,
+// but in the charge columns of the 'batch' and of the 'cluster', so that
+// digital pixels pay nothing for it. The 'digital' and 'analog' traits
+// select at compile time whether the charge is used at all, keeping the
+// digital loops untouched.
 //==============================================================================
 
 
@@ -27,13 +32,21 @@
 #define pixel_HPP
 
 // Application units
-#include "../include/data.hpp"
+#include "data.hpp"
 
 
 // Standard library
 #include <iostream>
 
 
+//______________________________________________________________________________
+namespace cat { 
+
+	// Pixel traits.
+	struct digital { static constexpr bool charged = false; };
+	struct analog { static constexpr bool charged = true; };
+}
+
 //______________________________________________________________________________
 namespace cat { class pixel; }
 class cat::pixel : public cat::data
@@ -54,12 +67,12 @@ public:
 	//friend std::ostream& operator<<(std::ostream&, cat::pixel&);
 		
 	// Methods.
-	inline int col() const;			//!< Retrieve x coordinate.
-	inline void col(const int&);	//!< Set x coordinate.
-	inline int row() const;			//!< Retrieve y coordinate.
-	inline void row(const int&);	//!< Set y coordinate.
-	inline long tsp() const;		//!< Retrieve time.
-	inline void tsp(const long&);	//!< Set time.
+	int col() const;				//!< Retrieve x coordinate.
+	void col(const int&);		//!< Set x coordinate.
+	int row() const;				//!< Retrieve y coordinate.
+	void row(const int&);		//!< Set y coordinate.
+	long tsp() const;			//!< Retrieve time.
+	void tsp(const long&);		//!< Set time.
 
 protected:
 
@@ -14,8 +14,8 @@
 
 
 // Application units
-#include "../include/plane.hpp"
-#include "../include/caf.hpp"
+#include "plane.hpp"
+#include "caf.hpp"
 
 
 
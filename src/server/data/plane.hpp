@@ -27,7 +27,7 @@
 #define plane_HPP
 
 // Application units
-#include "../include/coord.hpp"
+#include "coord.hpp"
 
 // Standard library
 #include <iostream>
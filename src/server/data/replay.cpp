@@ -0,0 +1,287 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Raw data replay source                       --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"replay.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "replay.hpp"
+
+// Standard library
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+// Platform
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::replay::replay(const std::string& path, const uint32_t& format, const std::size_t& word) :
+    _data(nullptr),
+    _bytes(0),
+    _word(word),
+    _pos(0),
+    _mapped(false),
+    _speed(0),
+    _tick(25),
+    _paced(false),
+    _tsp0(0),
+    _stop(false)
+{
+    /*! Ctor. Opens the file at \c path, containing raw words of \c word bytes
+        (4 or 8) in the \c format, as registered in the 'decoder'.
+    */
+    if (word != 4 && word != 8) {
+        throw std::runtime_error{ "replay: word size must be 4 or 8 bytes" };
+    }
+    _decoder = cat::decoder::build(format);
+    if (!_decoder) {
+        throw std::runtime_error{ "replay: unknown format " + std::to_string(format) };
+    }
+    map(path);
+}
+
+//______________________________________________________________________________
+cat::replay::~replay()
+{
+    /*! Dtor. Releases the file mapping. */
+    unmap();
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::replay::map(const std::string& path)
+{
+    /* Maps the file in memory, advising the kernel the access will be
+       sequential so that it reads ahead aggressively and drops the pages
+       behind. Where mapping is not available, the file is loaded instead.
+    */
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error{ "replay: cannot open " + path };
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        ::close(fd);
+        throw std::runtime_error{ "replay: cannot stat " + path };
+    }
+    _bytes = static_cast<std::size_t>(st.st_size);
+
+    // Empty files cannot be mapped, and there is nothing to replay anyway.
+    if (_bytes) {
+        void* p = ::mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error{ "replay: cannot map " + path };
+        }
+        ::madvise(p, _bytes, MADV_SEQUENTIAL);
+        _data = static_cast<const unsigned char*>(p);
+        _mapped = true;
+    }
+
+    // The mapping outlives the descriptor.
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error{ "replay: cannot open " + path };
+    _bytes = static_cast<std::size_t>(file.tellg());
+    _buffer.resize(_bytes);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(_buffer.data()), _bytes);
+    _data = _buffer.data();
+#endif
+}
+
+//______________________________________________________________________________
+void cat::replay::unmap()
+{
+    /* Releases the mapping, or the fallback storage. */
+#if !defined(_WIN32)
+    if (_mapped) ::munmap(const_cast<unsigned char*>(_data), _bytes);
+#endif
+    _buffer.clear();
+    _data = nullptr;
+    _mapped = false;
+}
+
+//______________________________________________________________________________
+void cat::replay::pace(const long& tsp)
+{
+    /* Waits until the wall time corresponding to \c tsp, relative to the first
+       timestamp replayed, scaled by the speed. Returns at once at max speed.
+    */
+    if (_speed <= 0) return;
+
+    // The first batch sets the reference.
+    if (!_paced) {
+        _tsp0 = tsp;
+        _clk0 = std::chrono::steady_clock::now();
+        _paced = true;
+        return;
+    }
+
+    // Wait (timestamps going backward do not wait at all).
+    const double ns = static_cast<double>(tsp - _tsp0) * _tick / _speed;
+    if (ns > 0) {
+        std::this_thread::sleep_until(_clk0 + std::chrono::nanoseconds(static_cast<long long>(ns)));
+    }
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::size_t cat::replay::words() const
+{
+    /*! Returns the file size in words. Trailing bytes not making a whole word
+        are ignored.
+    */
+    return _bytes / _word;
+}
+
+//______________________________________________________________________________
+std::size_t cat::replay::pos() const
+{
+    /*! Returns the current position in words. */
+    return _pos;
+}
+
+//______________________________________________________________________________
+bool cat::replay::done() const
+{
+    /*! Returns true if the whole file has been replayed. */
+    return _pos >= words();
+}
+
+//______________________________________________________________________________
+void cat::replay::rewind()
+{
+    /*! Restarts the replay from the beginning of the file, resetting both the
+        decoder state and the pacing reference, and clearing a 'stop' request.
+    */
+    _pos = 0;
+    _paced = false;
+    _stop = false;
+    _decoder->reset();
+}
+
+//______________________________________________________________________________
+double cat::replay::speed() const
+{
+    /*! Returns the speed multiplier, 0 meaning as fast as possible. */
+    return _speed;
+}
+
+//______________________________________________________________________________
+void cat::replay::speed(const double& s)
+{
+    /*! Sets the speed multiplier: 1 replays in real time, 2 twice as fast and
+        so on; 0 (or negative) replays as fast as possible. The pacing
+        restarts from the next batch.
+    */
+    _speed = s;
+    _paced = false;
+}
+
+//______________________________________________________________________________
+double cat::replay::tick() const
+{
+    /*! Returns the timestamp unit in ns. */
+    return _tick;
+}
+
+//______________________________________________________________________________
+void cat::replay::tick(const double& t)
+{
+    /*! Sets the timestamp unit in ns (default 25 ns, the 40 MHz clock). */
+    _tick = t;
+    _paced = false;
+}
+
+//______________________________________________________________________________
+std::size_t cat::replay::next(cat::batch& b, const std::size_t& n)
+{
+    /*! Decodes up to \c n words into \c b (cleared first), waiting as needed
+        by the pacing before returning. Returns the number of words consumed,
+        zero only once the file is over: a chunk may well decode to no pixel,
+        so \c b can be empty while the replay goes on.
+    */
+    if (n == 0) throw std::runtime_error{ "replay: next needs a chunk of at least one word" };
+    b.clear();
+    if (done()) return 0;
+
+    // Decode straight from the mapping.
+    const std::size_t count = std::min(n, words() - _pos);
+    const unsigned char* p = _data + _pos * _word;
+    if (_word == 4) {
+        _decoder->decode(reinterpret_cast<const uint32_t*>(p), count, b);
+    } else {
+        _decoder->decode(reinterpret_cast<const uint64_t*>(p), count, b);
+    }
+    _pos += count;
+
+    // Pace on the batch last timestamp, so it is delivered once complete.
+    if (!b.empty()) pace(b.tsp()[b.size() - 1]);
+    return count;
+}
+
+//______________________________________________________________________________
+std::size_t cat::replay::run(const sink& s, const std::size_t& n)
+{
+    /*! Replays the file from the current position to the end, decoding \c n
+        words at a time and pushing every batch to \c s. The same batch storage
+        is reused throughout. Returns the number of pixels replayed; 'stop'
+        (from another thread, or from the sink) ends it early. A stop issued
+        before the call holds, and 'run' returns at once, until 'rewind'.
+    */
+    if (n == 0) throw std::runtime_error{ "replay: run needs a chunk of at least one word" };
+    cat::batch b(n);
+    std::size_t total = 0;
+    while (!_stop && next(b, n)) {
+        if (!b.empty()) {
+            s(b);
+            total += b.size();
+        }
+    }
+    return total;
+}
+
+//______________________________________________________________________________
+void cat::replay::stop()
+{
+    /*! Stops a running 'run' after the current batch. The request stays
+        until 'rewind', so it is not lost if 'run' has not started yet.
+    */
+    _stop = true;
+}
@@ -0,0 +1,117 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Raw data replay source                       --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"replay.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'replay' object feeds a recorded run through the same path as the live
+// data: the file, a plain dump of raw readout words, is memory mapped (with
+// sequential read-ahead advice) and decoded chunk by chunk into pixel
+// 'batch' objects by the 'decoder' registered for its format: any format
+// registered in the 'decoder' can be replayed.
+// Batches are either pulled one at a time through 'next', or pushed to a sink
+// by 'run'. The pacing follows the embedded timestamps: at speed 1 the
+// batches come out in real time, at speed N N times faster, while a speed of
+// zero (the default) means as fast as possible.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef replay_HPP
+#define replay_HPP
+
+// Application units.
+#include "batch.hpp"
+#include "decoder.hpp"
+
+// Standard library
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <functional>
+
+
+//______________________________________________________________________________
+namespace cat { class replay; }
+class cat::replay
+{
+
+public:
+
+	// Batches sink, as used by 'run'.
+	typedef std::function<void(const cat::batch&)> sink;
+
+	// Special members.
+	replay(const std::string&, const uint32_t&, const std::size_t& = 4);	//!< Ctor.
+	~replay();					//!< Dtor.
+
+	// No copy allowed, the replay owns the mapping.
+	replay(const replay&) = delete;
+	replay& operator=(const replay&) = delete;
+
+	// Source.
+	std::size_t words() const;	//!< Retrieve the file size [words].
+	std::size_t pos() const;	//!< Retrieve the current position [words].
+	bool done() const;			//!< True when the whole file was replayed.
+	void rewind();				//!< Restart from the beginning (clears a stop).
+
+	// Pacing.
+	double speed() const;		//!< Retrieve the speed multiplier (0 = max).
+	void speed(const double&);	//!< Set the speed multiplier (0 = max).
+	double tick() const;		//!< Retrieve the timestamp unit [ns].
+	void tick(const double&);	//!< Set the timestamp unit [ns].
+
+	// Replay.
+	std::size_t next(cat::batch&, const std::size_t& = 4096);	//!< Decode the next chunk (words consumed).
+	std::size_t run(const sink&, const std::size_t& = 4096);	//!< Replay to a sink.
+	void stop();				//!< Stop a running 'run' (any thread).
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// File data.
+	const unsigned char* _data;	// Mapped (or loaded) file.
+	std::size_t _bytes;			// File size [bytes].
+	std::size_t _word;			// Word size [bytes].
+	std::size_t _pos;			// Current position [words].
+	std::vector<unsigned char> _buffer;	// Fallback storage, if no mapping.
+	bool _mapped;				// True if _data is a mapping.
+
+	// Decoding.
+	std::unique_ptr<cat::decoder> _decoder;
+
+	// Pacing.
+	double _speed;				// Speed multiplier (0 = max).
+	double _tick;				// Timestamp unit [ns].
+	bool _paced;				// Pacing reference set.
+	long _tsp0;					// Reference timestamp.
+	std::chrono::steady_clock::time_point _clk0;	// Reference wall time.
+	std::atomic<bool> _stop;	// Stop request.
+
+	// Support routines.
+	void map(const std::string&);
+	void unmap();
+	void pace(const long&);
+};
+
+// Overloading check
+#endif
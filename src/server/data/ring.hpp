@@ -0,0 +1,161 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Bounded lock-free queue                      --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"ring.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'ring' object is a bounded, lock-free, multi producer multi consumer
+// queue: a power of two array of cells, each carrying a sequence number
+// telling producers and consumers whether the cell is free or full for
+// their turn. Push and pop never block: they just fail when the queue is
+// full or empty, leaving the waiting policy (spin, yield, sleep) to the
+// caller, which is how the backpressure is implemented upstream.
+// Being a template, it is all here in the header.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef ring_HPP
+#define ring_HPP
+
+// Standard library
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+
+//______________________________________________________________________________
+namespace cat { template <typename T> class ring; }
+template <typename T> class cat::ring
+{
+
+public:
+
+	// Special members.
+	ring(const std::size_t&);	//!< Ctor.
+	~ring() {}					//!< Dtor.
+
+	// No copy allowed.
+	ring(const ring&) = delete;
+	ring& operator=(const ring&) = delete;
+
+	// Queue.
+	bool push(const T&);		//!< Enqueue, false if full.
+	bool pop(T&);				//!< Dequeue, false if empty.
+	std::size_t size() const;	//!< Approximate number of items.
+	std::size_t capacity() const;	//!< Maximum number of items.
+
+private:
+
+	// Single cell.
+	struct cell {
+		std::atomic<std::size_t> seq;
+		T data;
+	};
+
+	std::unique_ptr<cell[]> _cell;		// Cells.
+	std::size_t _mask;					// Capacity - 1.
+	alignas(64) std::atomic<std::size_t> _tail;	// Next push position.
+	alignas(64) std::atomic<std::size_t> _head;	// Next pop position.
+};
+
+
+//______________________________________________________________________________
+template <typename T>
+cat::ring<T>::ring(const std::size_t& capacity) :
+	_tail(0),
+	_head(0)
+{
+	/*! Ctor. The capacity is rounded up to the next power of two (min 2). */
+	std::size_t n = 2;
+	while (n < capacity) n <<= 1;
+	_mask = n - 1;
+	_cell.reset(new cell[n]);
+	for (std::size_t i = 0; i < n; i++) _cell[i].seq.store(i, std::memory_order_relaxed);
+}
+
+//______________________________________________________________________________
+template <typename T>
+bool cat::ring<T>::push(const T& v)
+{
+	/*! Enqueues \c v. Returns false, without waiting, if the queue is full. */
+	cell* c;
+	std::size_t pos = _tail.load(std::memory_order_relaxed);
+	for (;;) {
+		c = &_cell[pos & _mask];
+		const std::size_t seq = c->seq.load(std::memory_order_acquire);
+		const std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+		if (dif == 0) {
+			if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		} else if (dif < 0) {
+			return false;
+		} else {
+			pos = _tail.load(std::memory_order_relaxed);
+		}
+	}
+	c->data = v;
+	c->seq.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+//______________________________________________________________________________
+template <typename T>
+bool cat::ring<T>::pop(T& v)
+{
+	/*! Dequeues into \c v. Returns false, without waiting, if the queue is
+		empty.
+	*/
+	cell* c;
+	std::size_t pos = _head.load(std::memory_order_relaxed);
+	for (;;) {
+		c = &_cell[pos & _mask];
+		const std::size_t seq = c->seq.load(std::memory_order_acquire);
+		const std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+		if (dif == 0) {
+			if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		} else if (dif < 0) {
+			return false;
+		} else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+	v = c->data;
+	c->seq.store(pos + _mask + 1, std::memory_order_release);
+	return true;
+}
+
+//______________________________________________________________________________
+template <typename T>
+std::size_t cat::ring<T>::size() const
+{
+	/*! Returns the number of queued items. It is a snapshot, exact only when
+		the queue is not being used concurrently.
+	*/
+	const std::size_t t = _tail.load(std::memory_order_relaxed);
+	const std::size_t h = _head.load(std::memory_order_relaxed);
+	return (t > h) ? t - h : 0;
+}
+
+//______________________________________________________________________________
+template <typename T>
+std::size_t cat::ring<T>::capacity() const
+{
+	/*! Returns the maximum number of items. */
+	return _mask + 1;
+}
+
+// Overloading check
+#endif
@@ -0,0 +1,109 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Timestamp rollover unwrapping                --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"rollover.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "rollover.hpp"
+
+// Standard library
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::rollover::rollover(const int& bits) :
+    _bits(bits),
+    _started(false),
+    _last(0),
+    _epoch(0)
+{
+    /*! Ctor. \c bits is the width of the hardware timestamps; 0 means they
+        do not roll over, and 'unwrap' does nothing.
+    */
+    if (bits < 0 || bits > 62) throw std::runtime_error{ "rollover: invalid timestamp width" };
+}
+
+//______________________________________________________________________________
+cat::rollover::~rollover()
+{
+    /*! Dtor. Nothing to do. */
+}
+
+
+// *****************************************************************************
+// **                            Public members                               **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::rollover::bits() const
+{
+    /*! Returns the hardware timestamps width, 0 if not rolling over. */
+    return _bits;
+}
+
+//______________________________________________________________________________
+long cat::rollover::epoch() const
+{
+    /*! Returns the offset currently added to the raw timestamps. */
+    return _epoch;
+}
+
+//______________________________________________________________________________
+void cat::rollover::reset()
+{
+    /*! Resets the tracking, when the pixel stream restarts. */
+    _started = false;
+    _last = 0;
+    _epoch = 0;
+}
+
+//______________________________________________________________________________
+void cat::rollover::unwrap(long* tsp, const std::size_t& n)
+{
+    /*! Replaces the \c n raw timestamps at \c tsp with monotonic ones. A raw
+        value falling back by more than half the period is a rollover, and
+        moves the epoch on; one jumping ahead by more than half the period is
+        a pixel late across the last rollover, and gets the previous epoch.
+    */
+    if (!_bits || !n) return;
+    const long period = 1L << _bits;
+    const long half = period / 2;
+    const long mask = period - 1;
+
+    // Keep the state in locals for the loop.
+    long last = _started ? _last : (tsp[0] & mask);
+    long epoch = _epoch;
+    _started = true;
+    for (std::size_t i = 0; i < n; i++) {
+        const long t = tsp[i] & mask;
+        if (last - t > half) {
+            epoch += period;
+            last = t;
+            tsp[i] = t + epoch;
+        } else if (t - last > half) {
+            tsp[i] = t + epoch - period;
+        } else {
+            last = t;
+            tsp[i] = t + epoch;
+        }
+    }
+
+    // Store the state back.
+    _last = last;
+    _epoch = epoch;
+}
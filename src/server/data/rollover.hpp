@@ -0,0 +1,68 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Timestamp rollover unwrapping                --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"rollover.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'rollover' object turns the wrapping hardware timestamps (a field just
+// a few bits wide, rolling over every 2^bits counts) into monotonic ones, by
+// adding a running epoch which advances at every rollover. Pixels late
+// across a rollover, by less than half a period, keep the previous epoch.
+// It is shared by the 'bitfield' decoder and the 'sorter', and keeps a
+// state, so one object serves one pixel stream.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef rollover_HPP
+#define rollover_HPP
+
+// Standard library
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class rollover; }
+class cat::rollover
+{
+
+public:
+
+	// Special members.
+	rollover(const int& = 0);	//!< Ctor, with the timestamp width.
+	~rollover();				//!< Dtor.
+
+	// Properties.
+	int bits() const;			//!< Retrieve the hardware timestamp width.
+	long epoch() const;			//!< Retrieve the current rollover offset.
+	void reset();				//!< Reset the tracking.
+
+	// Unwrapping.
+	void unwrap(long*, const std::size_t&);	//!< Unwrap a timestamps run.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	int _bits;					// Hardware timestamp width (0 = no rollover).
+	bool _started;				// Any timestamp seen yet.
+	long _last;					// Last raw timestamp in the current epoch.
+	long _epoch;				// Offset added to the raw timestamps.
+};
+
+// Overloading check
+#endif
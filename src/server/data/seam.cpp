@@ -0,0 +1,256 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Cross-sensor cluster merging                 --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"seam.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "seam.hpp"
+
+// Standard library
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::seam::seam(const cat::layer& lr, const int& gap, const long& window) :
+    _gap(gap),
+    _window(window)
+{
+    /*! Ctor. Builds the edge index of the \c lr sensors. \c gap is the number
+        of dead pixels between adjacent chips, \c window the largest time
+        distance between the pieces of a cluster.
+    */
+    if (gap < 0) throw std::runtime_error{ "seam: negative gap" };
+    if (window < 0) throw std::runtime_error{ "seam: negative time window" };
+    const std::vector<cat::sensor>& sr = lr.sensors();
+    if (sr.empty()) throw std::runtime_error{ "seam: layer without sensors" };
+    const float cp = sr.front().colPitch();
+    const float rp = sr.front().rowPitch();
+    if (cp <= 0 || rp <= 0) throw std::runtime_error{ "seam: invalid sensor pitch" };
+
+    // Sensors on the layer pixel grid.
+    for (const cat::sensor& s : sr) {
+        if (std::fabs(s.colPitch() - cp) > 1e-3f * cp || std::fabs(s.rowPitch() - rp) > 1e-3f * rp)
+            throw std::runtime_error{ "seam: the layer sensors must share the same pitch" };
+        _cols.push_back(s.cols());
+        _rows.push_back(s.rows());
+        _col.push_back(static_cast<int>(std::lround(s.pos().x() / cp)));
+        _row.push_back(static_cast<int>(std::lround(s.pos().y() / rp)));
+    }
+
+    // Facing edges: a neighbour within the gap on one axis, overlapping on
+    // the other (diagonal neighbours face both the corner edges).
+    const int n = static_cast<int>(sr.size());
+    const int d = 1 + gap;
+    _edges.assign(n, 0);
+    for (int i = 0; i < n; i++) {
+        const int r0 = _col[i] + _cols[i] - 1;
+        const int t0 = _row[i] + _rows[i] - 1;
+        for (int j = 0; j < n; j++) {
+            if (i == j) continue;
+            const int r1 = _col[j] + _cols[j] - 1;
+            const int t1 = _row[j] + _rows[j] - 1;
+            const bool rows = _row[j] <= t0 + d && _row[i] <= t1 + d;
+            const bool cols = _col[j] <= r0 + d && _col[i] <= r1 + d;
+            if (rows && _col[j] - r0 >= 1 && _col[j] - r0 <= d) _edges[i] |= S_RIGHT;
+            if (rows && _col[i] - r1 >= 1 && _col[i] - r1 <= d) _edges[i] |= S_LEFT;
+            if (cols && _row[j] - t0 >= 1 && _row[j] - t0 <= d) _edges[i] |= S_TOP;
+            if (cols && _row[i] - t1 >= 1 && _row[i] - t1 <= d) _edges[i] |= S_BOTTOM;
+        }
+    }
+}
+
+//______________________________________________________________________________
+cat::seam::~seam()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+uint32_t cat::seam::find(uint32_t i)
+{
+    /* Root of \c i, halving the path. */
+    while (_parent[i] != i) {
+        _parent[i] = _parent[_parent[i]];
+        i = _parent[i];
+    }
+    return i;
+}
+
+//______________________________________________________________________________
+bool cat::seam::touch(const std::vector<std::vector<cat::cluster>>& cl,
+                      const entry& a, const entry& b) const
+{
+    /* True if a pixel of \c a is adjacent (within the gap) to one of \c b,
+       in layer coordinates.
+    */
+    const int d = 1 + _gap;
+    const int dc = _col[a.sensor] - _col[b.sensor];
+    const int dr = _row[a.sensor] - _row[b.sensor];
+    for (const cat::pixel& p : cl[a.sensor][a.index].pixels()) {
+        for (const cat::pixel& q : cl[b.sensor][b.index].pixels()) {
+            const int c = p.col() - q.col() + dc;
+            const int r = p.row() - q.row() + dr;
+            if (c <= d && -c <= d && r <= d && -r <= d) return true;
+        }
+    }
+    return false;
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::seam::sensors() const
+{
+    /*! Returns the number of sensors in the layer. */
+    return static_cast<int>(_edges.size());
+}
+
+//______________________________________________________________________________
+int cat::seam::edges(const int& s) const
+{
+    /*! Returns the edges of sensor \c s facing another sensor, as a 'side'
+        mask.
+    */
+    return _edges.at(s);
+}
+
+//______________________________________________________________________________
+int cat::seam::col(const int& s) const
+{
+    /*! Returns the column of the layer pixel grid of the sensor \c s first
+        column.
+    */
+    return _col.at(s);
+}
+
+//______________________________________________________________________________
+int cat::seam::row(const int& s) const
+{
+    /*! Returns the row of the layer pixel grid of the sensor \c s first row. */
+    return _row.at(s);
+}
+
+//______________________________________________________________________________
+std::size_t cat::seam::merge(const std::vector<std::vector<cat::cluster>>& cl,
+                             std::vector<cat::cluster>& out)
+{
+    /*! Merges the clusters of \c cl (the updated clusters of every sensor,
+        in the layer order) split across the sensor edges. The merged
+        clusters, in layer pixel coordinates, are appended to \c out, and the
+        pieces they are made of are listed by 'pieces' (the caller drops
+        them from the per-sensor results). Returns the number of merged
+        clusters.
+    */
+    if (cl.size() != _edges.size()) throw std::runtime_error{ "seam: clusters do not match the layer sensors" };
+    _entry.clear();
+    _pieces.clear();
+
+    // Edge candidates.
+    for (std::size_t s = 0; s < cl.size(); s++) {
+        const int e = _edges[s];
+        if (!e) continue;
+        const int lastCol = _cols[s] - 1;
+        const int lastRow = _rows[s] - 1;
+        for (std::size_t k = 0; k < cl[s].size(); k++) {
+            const cat::cluster& c = cl[s][k];
+            if (((e & S_LEFT) && c.left() <= 0) || ((e & S_RIGHT) && c.right() >= lastCol) ||
+                ((e & S_BOTTOM) && c.bottom() <= 0) || ((e & S_TOP) && c.top() >= lastRow)) {
+                _entry.push_back({ static_cast<int>(s), k,
+                                   c.left() + _col[s], c.right() + _col[s],
+                                   c.bottom() + _row[s], c.top() + _row[s], c.tsp() });
+            }
+        }
+    }
+    const std::size_t n = _entry.size();
+    if (n < 2) return 0;
+
+    // Sweep along the columns, joining the touching pieces of different sensors.
+    std::sort(_entry.begin(), _entry.end(), [](const entry& a, const entry& b) { return a.left < b.left; });
+    _parent.resize(n);
+    for (std::size_t i = 0; i < n; i++) _parent[i] = static_cast<uint32_t>(i);
+    const int d = 1 + _gap;
+    bool any = false;
+    for (std::size_t i = 0; i < n; i++) {
+        const entry& a = _entry[i];
+        for (std::size_t j = i + 1; j < n && _entry[j].left <= a.right + d; j++) {
+            const entry& b = _entry[j];
+            if (a.sensor == b.sensor) continue;
+            if (b.bottom > a.top + d || a.bottom > b.top + d) continue;
+            if (a.tsp - b.tsp > _window || b.tsp - a.tsp > _window) continue;
+            if (!touch(cl, a, b)) continue;
+            const uint32_t ra = find(static_cast<uint32_t>(i));
+            const uint32_t rb = find(static_cast<uint32_t>(j));
+            if (ra != rb) _parent[std::max(ra, rb)] = std::min(ra, rb);
+            any = true;
+        }
+    }
+    if (!any) return 0;
+
+    // Group sizes, then the merged clusters of the groups with several pieces.
+    _label.assign(n, 0);
+    for (std::size_t i = 0; i < n; i++) _label[find(static_cast<uint32_t>(i))]++;
+    const std::size_t first = out.size();
+    for (std::size_t i = 0; i < n; i++) {
+        const uint32_t root = find(static_cast<uint32_t>(i));
+        if (_label[root] < 2) continue;
+        if (root == i) {
+            out.emplace_back();
+            out.back().setAuto(false);
+            _label[root] = static_cast<uint32_t>(out.size() - 1) | 0x80000000u;
+        }
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        const uint32_t root = find(static_cast<uint32_t>(i));
+        if (!(_label[root] & 0x80000000u)) continue;
+        const entry& e = _entry[i];
+        cat::cluster& m = out[_label[root] & 0x7FFFFFFFu];
+        const cat::cluster& c = cl[e.sensor][e.index];
+        for (std::size_t k = 0; k < c.pixels().size(); k++) {
+            cat::pixel p(c.pixels()[k]);
+            p.col(p.col() + _col[e.sensor]);
+            p.row(p.row() + _row[e.sensor]);
+            if (c.charges().empty()) m.add(p);
+            else m.add(p, c.charges()[k]);
+        }
+        _pieces.push_back({ e.sensor, e.index });
+    }
+    for (std::size_t i = first; i < out.size(); i++) out[i].update();
+    return out.size() - first;
+}
+
+//______________________________________________________________________________
+const std::vector<cat::seam::piece>& cat::seam::pieces() const
+{
+    /*! Returns the sensor clusters merged by the last 'merge' call. */
+    return _pieces;
+}
@@ -0,0 +1,113 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Cross-sensor cluster merging                 --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"seam.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'seam' object merges the clusters split across the edges of the tiled
+// sensors of a 'layer' (multi-chip modules). Clustering runs per sensor, so
+// a particle crossing a sensor edge leaves one piece on each side.
+// At construction, the layer tiling is turned into an edge index: every
+// sensor gets the set of its edges (left/right/bottom/top) facing another
+// sensor, and its offset on the layer pixel grid (sensor position over the
+// pitch, all the sensors sharing the same pitch).
+// 'merge' then looks only at the clusters touching a facing edge (through
+// their left/right/bottom/top against the sensor cols/rows), moves them to
+// layer coordinates, and joins the pieces of different sensors with
+// adjacent pixels (up to 'gap' dead pixels between the chips) and close
+// timestamps. The interior clusters are never rescanned.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef seam_HPP
+#define seam_HPP
+
+// Application units.
+#include "layer.hpp"
+#include "cluster.hpp"
+
+// Standard library
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class seam; }
+class cat::seam
+{
+
+public:
+
+	// Sensor edges.
+	enum side { S_LEFT = 1, S_RIGHT = 2, S_BOTTOM = 4, S_TOP = 8 };
+
+	// A cluster of a sensor.
+	struct piece {
+		int sensor;				// Sensor index in the layer.
+		std::size_t index;		// Cluster index in the sensor clusters.
+	};
+
+	// Special members.
+	seam(const cat::layer&, const int& = 0, const long& = 0);	//!< Ctor.
+	~seam();					//!< Dtor.
+
+	// Edge index.
+	int sensors() const;		//!< Retrieve the number of sensors.
+	int edges(const int&) const;//!< Retrieve the facing edges of a sensor.
+	int col(const int&) const;	//!< Retrieve a sensor column offset in the layer.
+	int row(const int&) const;	//!< Retrieve a sensor row offset in the layer.
+
+	// Merging.
+	std::size_t merge(const std::vector<std::vector<cat::cluster>>&, std::vector<cat::cluster>&);	//!< Merge the split clusters.
+	const std::vector<piece>& pieces() const;	//!< Retrieve the pieces merged by the last call.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Edge candidate, in layer coordinates.
+	struct entry {
+		int sensor;
+		std::size_t index;
+		int left, right, bottom, top;
+		long tsp;
+	};
+
+	// Layer tiling.
+	std::vector<int> _cols;			// Sensors columns.
+	std::vector<int> _rows;			// Sensors rows.
+	std::vector<int> _col;			// Sensors column offsets.
+	std::vector<int> _row;			// Sensors row offsets.
+	std::vector<int> _edges;		// Sensors facing edges.
+	int _gap;						// Dead pixels allowed between chips.
+	long _window;					// Time window.
+
+	// Merge scratch.
+	std::vector<entry> _entry;
+	std::vector<uint32_t> _parent;
+	std::vector<uint32_t> _label;
+	std::vector<piece> _pieces;
+
+	// Support routines.
+	uint32_t find(uint32_t);
+	bool touch(const std::vector<std::vector<cat::cluster>>&, const entry&, const entry&) const;
+};
+
+// Overloading check
+#endif
@@ -14,8 +14,11 @@
 
 
 // Application units
-#include "../include/sensor.hpp"
-#include "../include/caf.hpp"
+#include "sensor.hpp"
+#include "caf.hpp"
+
+// Standard library
+#include <stdexcept>
 
 
 // Use standard namespace:
@@ -45,7 +48,9 @@ cat::sensor::sensor(const sensor& sr) :
     data(sr), 
     _cols(sr._cols), _rows(sr._rows),
     _colPitch(sr._colPitch), _rowPitch(sr._rowPitch),
-    _pos(sr._pos)
+    _pos(sr._pos),
+    _cluster(sr._cluster),
+    _mask(sr._mask.load())
 {
     /*! Copy ctor. */
 }
@@ -85,6 +90,9 @@ cat::sensor& cat::sensor::operator=(const cat::sensor& sr)
     // Clusters collection.
     _cluster = sr._cluster;
 
+    // Mask (shared, masks are never modified once in use).
+    _mask = sr._mask.load();
+
     // Return.
     return *this;
 }
@@ -178,4 +186,35 @@ long cat::sensor::clCount() const
 {
     /* Retrieve how many cluster into a sensor. */
     return (long) _cluster.size();
-}
\ No newline at end of file
+}
+
+
+// _____________________________________________________________________________
+std::shared_ptr<const cat::mask> cat::sensor::mask() const
+{
+    /* Retrieve the sensor pixel mask, void if the sensor is not masked. */
+    return _mask.load();
+}
+
+// _____________________________________________________________________________
+void cat::sensor::mask(const std::shared_ptr<const cat::mask>& m)
+{
+    /* Set the sensor pixel mask (void to remove it). It can be done while the
+       pipeline is running: filters already in progress complete with the
+       previous mask, which is released afterwards.
+    */
+    if (m && (m->cols() != _cols || m->rows() != _rows)) {
+        throw std::runtime_error{ "sensor: mask size mismatch" };
+    }
+    _mask.store(m);
+}
+
+// _____________________________________________________________________________
+std::size_t cat::sensor::filter(cat::batch& b) const
+{
+    /* Remove from the batch the pixels masked in the sensor. Returns how many
+       pixels were removed.
+    */
+    const std::shared_ptr<const cat::mask> m = _mask.load();
+    return m ? m->filter(b) : 0;
+}
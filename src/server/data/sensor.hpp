@@ -28,11 +28,15 @@
 #define sensor_HPP
 
 // Application units.
-#include "../include/cluster.hpp"
-#include "../include/coord.hpp"
+#include "cluster.hpp"
+#include "coord.hpp"
+#include "mask.hpp"
+#include "batch.hpp"
 
 // Standard library
 #include <vector>
+#include <memory>
+#include <atomic>
 
 
 
@@ -53,19 +57,24 @@ public:
 
 	
 	// Sensors properties.
-	inline int cols() const;		//!< Retrieve the number of columns.
-	inline int rows() const;		//!< Retrieve the number of rows.
-	inline float colPitch() const;	//!< Retrieve the pixel column pitch [arb].
-	inline float rowPitch() const;	//!< Retrieve the pixel row pitch [arb].
+	int cols() const;			//!< Retrieve the number of columns.
+	int rows() const;			//!< Retrieve the number of rows.
+	float colPitch() const;		//!< Retrieve the pixel column pitch [arb].
+	float rowPitch() const;		//!< Retrieve the pixel row pitch [arb].
 
 	// Position (within a plane)
-	inline coord pos() const;		//!< Retrieve sensor position in a plane.
+	coord pos() const;			//!< Retrieve sensor position in a plane.
 	void pos(const coord&);			//!< Set sensor position in a plane.
 
 	// Clusters.
 	void clAdd(const cat::cluster&);//!< Add a cluster to the sensor.
 	long clCount() const;			//!< Returns how many clusters in the sensor.	
 
+	// Pixel mask.
+	std::shared_ptr<const cat::mask> mask() const;			//!< Retrieve the pixel mask (may be void).
+	void mask(const std::shared_ptr<const cat::mask>&);		//!< Set or replace the pixel mask.
+	std::size_t filter(cat::batch&) const;					//!< Drop the masked pixels from a batch.
+
 protected:
 
 	// No protected at the moment
@@ -85,6 +94,9 @@ private:
 	
 	// Cluster collection.
 	std::vector<cluster> _cluster;
+
+	// Pixel mask, swapped atomically so it can be replaced while running.
+	std::atomic<std::shared_ptr<const cat::mask>> _mask;
 };
 
 //______________________________________________________________________________
@@ -0,0 +1,320 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Cluster shape engine                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"shape.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "shape.hpp"
+
+// Standard library
+#include <set>
+#include <map>
+#include <utility>
+#include <algorithm>
+
+
+namespace {
+
+    // Pattern as a list of (col, row) cells.
+    typedef std::vector<std::pair<int, int>> cells;
+
+    //______________________________________________________________________________
+    uint32_t encode(cells cs)
+    {
+        /* Packs the cells, moved to touch the left and bottom edges, into a
+           key. Returns 0 if they do not fit the box.
+        */
+        int c0 = cs[0].first, r0 = cs[0].second;
+        for (const auto& c : cs) {
+            c0 = std::min(c0, c.first);
+            r0 = std::min(r0, c.second);
+        }
+        uint32_t key = 0;
+        for (const auto& c : cs) {
+            const int col = c.first - c0, row = c.second - r0;
+            if (col >= cat::shape::SIDE || row >= cat::shape::SIDE) return 0;
+            key |= uint32_t(1) << (row * cat::shape::SIDE + col);
+        }
+        return key;
+    }
+
+    //______________________________________________________________________________
+    cells decode(const uint32_t& key)
+    {
+        /* Unpacks a key into its cells. */
+        cells cs;
+        for (int i = 0; i < cat::shape::SIDE * cat::shape::SIDE; i++) {
+            if ((key >> i) & 1) cs.emplace_back(i % cat::shape::SIDE, i / cat::shape::SIDE);
+        }
+        return cs;
+    }
+
+    //______________________________________________________________________________
+    uint32_t transform(const uint32_t& key, const int& t)
+    {
+        /* Applies one of the 8 square symmetries (t = 0 identity) to a key. */
+        cells cs = decode(key);
+        for (auto& c : cs) {
+            const int x = c.first, y = c.second;
+            switch (t) {
+            case 1: c = { -x, y }; break;
+            case 2: c = { x, -y }; break;
+            case 3: c = { -x, -y }; break;
+            case 4: c = { y, x }; break;
+            case 5: c = { -y, x }; break;
+            case 6: c = { y, -x }; break;
+            case 7: c = { -y, -x }; break;
+            default: break;
+            }
+        }
+        return encode(cs);
+    }
+
+    //______________________________________________________________________________
+    uint32_t hash(const uint32_t& key)
+    {
+        /* Scrambles the key bits for the table index. */
+        uint32_t h = key * 0x9E3779B1u;
+        return h ^ (h >> 16);
+    }
+}
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::shape::shape(const int& maxMult) :
+    _maxMult(std::clamp(maxMult, 1, SIDE * SIDE)),
+    _classes(0),
+    _count(0),
+    _mask(0)
+{
+    /*! Ctor. Builds the table of all the connected patterns fitting the box
+        with up to \c maxMult pixels. The number of patterns grows fast with
+        the multiplicity: 6 (the default) gives a few thousands of them, 8
+        tens of thousands.
+    */
+    build();
+}
+
+//______________________________________________________________________________
+cat::shape::~shape()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::shape::entry* cat::shape::slot(const uint32_t& key)
+{
+    /* Returns the slot holding \c key, or the empty one where it would go. */
+    uint32_t i = hash(key) & _mask;
+    while (_table[i].key && _table[i].key != key) i = (i + 1) & _mask;
+    return &_table[i];
+}
+
+//______________________________________________________________________________
+void cat::shape::build()
+{
+    /* Enumerates the patterns growing them one pixel at a time, from the
+       single pixel on, then fills the table.
+    */
+    std::vector<std::set<uint32_t>> levels(1, std::set<uint32_t>{ 1 });
+    for (int m = 1; m < _maxMult; m++) {
+        std::set<uint32_t> next;
+        for (const uint32_t& key : levels.back()) {
+            const cells cs = decode(key);
+            for (const auto& c : cs) {
+                for (int dr = -1; dr <= 1; dr++) {
+                    for (int dc = -1; dc <= 1; dc++) {
+                        const std::pair<int, int> n(c.first + dc, c.second + dr);
+                        if (std::find(cs.begin(), cs.end(), n) != cs.end()) continue;
+                        cells ns = cs;
+                        ns.push_back(n);
+                        const uint32_t k = encode(ns);
+                        if (k) next.insert(k);
+                    }
+                }
+            }
+        }
+        if (next.empty()) break;
+        levels.push_back(std::move(next));
+    }
+
+    // Table with a load factor below 1/2.
+    for (const auto& l : levels) _count += l.size();
+    std::size_t size = 16;
+    while (size < 2 * _count) size <<= 1;
+    _table.assign(size, entry{ 0, 0, 0, 0, 0, 0 });
+    _mask = static_cast<uint32_t>(size - 1);
+
+    // Entries, classes numbered by multiplicity first.
+    std::map<uint32_t, int> ids;
+    for (std::size_t m = 0; m < levels.size(); m++) {
+        for (const uint32_t& key : levels[m]) {
+
+            // Class pattern: the smallest key among the symmetric ones.
+            uint32_t canon = key;
+            int orient = 0;
+            for (int t = 1; t < 8; t++) {
+                const uint32_t k = transform(key, t);
+                if (k < canon) {
+                    canon = k;
+                    orient = t;
+                }
+            }
+            auto id = ids.emplace(canon, _classes);
+            if (id.second) _classes++;
+
+            // Centroid, with pixel centers at +0.5.
+            const cells cs = decode(key);
+            float dc = 0, dr = 0;
+            for (const auto& c : cs) {
+                dc += c.first;
+                dr += c.second;
+            }
+            const float n = static_cast<float>(cs.size());
+            *slot(key) = entry{ key, id.first->second, orient, static_cast<int>(cs.size()),
+                                dc / n + 0.5f, dr / n + 0.5f };
+        }
+    }
+    _maxMult = static_cast<int>(levels.size());
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::shape::maxMult() const
+{
+    /*! Returns the largest multiplicity of the tabled patterns. */
+    return _maxMult;
+}
+
+//______________________________________________________________________________
+std::size_t cat::shape::patterns() const
+{
+    /*! Returns the number of tabled patterns. */
+    return _count;
+}
+
+//______________________________________________________________________________
+int cat::shape::classes() const
+{
+    /*! Returns the number of classes (patterns up to symmetries). */
+    return _classes;
+}
+
+//______________________________________________________________________________
+uint32_t cat::shape::pack(const cat::cluster& cl)
+{
+    /*! Packs the pixels of \c cl, relative to its left/bottom corner, into a
+        pattern key. Returns 0 if the cluster does not fit the box.
+    */
+    int left, bottom;
+    return pack(cl, left, bottom);
+}
+
+//______________________________________________________________________________
+uint32_t cat::shape::pack(const cat::cluster& cl, int& left, int& bottom)
+{
+    /*! As 'pack', also setting \c left and \c bottom to the cluster corner. */
+    const std::vector<cat::pixel>& px = cl.pixels();
+    if (px.empty() || px.size() > SIDE * SIDE) return 0;
+    left = px[0].col();
+    bottom = px[0].row();
+    for (const cat::pixel& p : px) {
+        left = std::min(left, p.col());
+        bottom = std::min(bottom, p.row());
+    }
+    uint32_t key = 0;
+    for (const cat::pixel& p : px) {
+        const unsigned c = static_cast<unsigned>(p.col() - left);
+        const unsigned r = static_cast<unsigned>(p.row() - bottom);
+        if (c >= SIDE || r >= SIDE) return 0;
+        key |= uint32_t(1) << (r * SIDE + c);
+    }
+    return key;
+}
+
+//______________________________________________________________________________
+const cat::shape::entry* cat::shape::find(const uint32_t& key) const
+{
+    /*! Returns the entry of the pattern \c key, or a void pointer if not in
+        the table.
+    */
+    if (!key) return nullptr;
+    uint32_t i = hash(key) & _mask;
+    while (_table[i].key) {
+        if (_table[i].key == key) return &_table[i];
+        i = (i + 1) & _mask;
+    }
+    return nullptr;
+}
+
+//______________________________________________________________________________
+const cat::shape::entry* cat::shape::find(const cat::cluster& cl) const
+{
+    /*! Returns the entry of the cluster \c cl pattern, or a void pointer if
+        the cluster is too large or its pattern is not in the table.
+    */
+    if (cl.pixels().size() > static_cast<std::size_t>(_maxMult)) return nullptr;
+    return find(pack(cl));
+}
+
+//______________________________________________________________________________
+int cat::shape::classify(const cat::cluster& cl, float& col, float& row) const
+{
+    /*! Sets \c col and \c row to the corrected position of \c cl and returns
+        its class ID. Clusters not in the table get their centroid and -1.
+    */
+    int left = 0, bottom = 0;
+    const entry* e = nullptr;
+    if (cl.pixels().size() <= static_cast<std::size_t>(_maxMult)) e = find(pack(cl, left, bottom));
+    if (!e) {
+        col = cl.col();
+        row = cl.row();
+        return -1;
+    }
+    col = static_cast<float>(left) + e->dcol;
+    row = static_cast<float>(bottom) + e->drow;
+    return e->id;
+}
+
+//______________________________________________________________________________
+bool cat::shape::correct(const uint32_t& key, const float& dcol, const float& drow)
+{
+    /*! Sets the position correction of the pattern \c key, i.e. the position
+        relative to the cluster left/bottom corner [px]. Returns false if the
+        pattern is not in the table.
+    */
+    if (!find(key)) return false;
+    entry* e = slot(key);
+    e->dcol = dcol;
+    e->drow = drow;
+    return true;
+}
@@ -0,0 +1,105 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Cluster shape engine                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"shape.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'shape' object classifies the small clusters by their pixels pattern.
+// A cluster fitting a 5x5 box is packed into a 25 bit key (bit r*5+c set for
+// the pixel at column c, row r from its left/bottom corner, taken from the
+// pixels so that it holds for clusters not updated yet), which is looked
+// up in an open addressing table built once at construction time, holding
+// all the connected (8 neighbours) patterns up to a given multiplicity.
+// Every entry carries:
+//	- the class ID, shared by the patterns equal under rotations and mirrors;
+//	- the orientation, i.e. which of the 8 transforms gives the class pattern;
+//	- the position correction, the cluster position relative to its corner.
+// The corrections start as the plain centroid, and can be replaced by the
+// calibrated ones through 'correct'. Clusters too large, or with patterns
+// not in the table, fall back to the general path (the cluster centroid).
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef shape_HPP
+#define shape_HPP
+
+// Application units.
+#include "cluster.hpp"
+
+// Standard library
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class shape; }
+class cat::shape
+{
+
+public:
+
+	// Table entry.
+	struct entry {
+		uint32_t key;		// Pattern (0 = empty slot).
+		int id;				// Class ID.
+		int orient;			// Orientation (0-7).
+		int mult;			// Pixels count.
+		float dcol;			// Column position from the left edge [px].
+		float drow;			// Row position from the bottom edge [px].
+	};
+
+	// Box side.
+	static const int SIDE = 5;
+
+	// Special members.
+	shape(const int& = 6);		//!< Ctor.
+	~shape();					//!< Dtor.
+
+	// Properties.
+	int maxMult() const;		//!< Retrieve the largest multiplicity in the table.
+	std::size_t patterns() const;	//!< Retrieve the number of patterns.
+	int classes() const;		//!< Retrieve the number of classes.
+
+	// Lookup.
+	static uint32_t pack(const cat::cluster&);	//!< Pack a cluster into a key (0 if too large).
+	static uint32_t pack(const cat::cluster&, int&, int&);	//!< Pack, retrieving the corner too.
+	const entry* find(const uint32_t&) const;	//!< Retrieve the entry of a key.
+	const entry* find(const cat::cluster&) const;	//!< Retrieve the entry of a cluster.
+	int classify(const cat::cluster&, float&, float&) const;	//!< Class and corrected position.
+
+	// Calibration.
+	bool correct(const uint32_t&, const float&, const float&);	//!< Set a position correction.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Support routines.
+	entry* slot(const uint32_t&);
+	void build();
+
+	int _maxMult;				// Largest multiplicity in the table.
+	int _classes;				// Number of classes.
+	std::size_t _count;			// Number of patterns.
+	std::vector<entry> _table;	// Open addressing table.
+	uint32_t _mask;				// Table size - 1.
+};
+
+// Overloading check
+#endif
@@ -0,0 +1,240 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Periodic image snapshots                     --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"snapshot.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "snapshot.hpp"
+
+// Standard library
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::snapshot::snapshot(const std::string& dir, const double& period) :
+    _dir(dir),
+    _period(0),
+    _history(false),
+    _stop(false),
+    _shots(0),
+    _failures(0)
+{
+    /*! Ctor. Images go into the \c dir directory, one shot every \c period
+        seconds once started.
+    */
+    this->period(period);
+}
+
+//______________________________________________________________________________
+cat::snapshot::~snapshot()
+{
+    /*! Dtor. Stops and joins the exporter thread. */
+    stop();
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::snapshot::loop()
+{
+    /* Exporter thread: shoots every period, on a fixed schedule (a late shot
+       does not delay the next ones, unless a whole period was lost).
+    */
+    auto next = std::chrono::steady_clock::now();
+    while (!_stop) {
+        next += std::chrono::milliseconds(_period.load());
+        {
+            std::unique_lock<std::mutex> lock(_wake);
+            if (_cv.wait_until(lock, next, [this] { return _stop.load(); })) break;
+        }
+        shoot();
+        const auto now = std::chrono::steady_clock::now();
+        if (next < now - std::chrono::milliseconds(_period.load())) next = now;
+    }
+}
+
+//______________________________________________________________________________
+bool cat::snapshot::save(image& im)
+{
+    /* Writes the \c im canvas aside, keeps a numbered copy if asked to, then
+       renames it over the image file. Returns false on any failure.
+    */
+    namespace fs = std::filesystem;
+    const fs::path file = fs::path(_dir) / (im.name + ".png");
+    const fs::path tmp = fs::path(_dir) / (im.name + ".png.tmp");
+    if (!im.cv.png(tmp.string())) return false;
+    std::error_code ec;
+    if (_history) {
+        char num[16];
+        std::snprintf(num, sizeof(num), "_%06llu", static_cast<unsigned long long>(im.count));
+        fs::copy_file(tmp, fs::path(_dir) / (im.name + num + ".png"), fs::copy_options::overwrite_existing, ec);
+        if (ec) return false;
+    }
+    fs::rename(tmp, file, ec);
+    return !ec;
+}
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::snapshot::add(const std::string& name, const int& width, const int& height, const painter& draw)
+{
+    /*! Adds the \c width x \c height image \c name (the file name, without
+        extension), painted by \c draw at every shot.
+    */
+    if (running()) throw std::runtime_error{ "snapshot: images must be added before start" };
+    if (!draw) throw std::runtime_error{ "snapshot: no painter" };
+    _image.push_back(std::unique_ptr<image>(new image{ name, cat::canvas(width, height), draw, 0 }));
+}
+
+//______________________________________________________________________________
+void cat::snapshot::add(const std::string& name, cat::hitmap& hm, const int& width, const int& height)
+{
+    /*! Adds the image \c name of the hitmap \c hm, drawn with the palette
+        autoscaled on its largest value. The size defaults to one image pixel
+        per sensor pixel. A shot is skipped if no new hitmap snapshot was
+        published since the previous one.
+    */
+    const int w = width > 0 ? width : hm.cols();
+    const int h = height > 0 ? height : hm.rows();
+    auto map = std::make_shared<std::vector<float>>();
+    add(name, w, h, [&hm, map](cat::canvas& cv) {
+        if (!hm.snapshot(*map)) return false;
+        cv.map(*map, hm.cols(), hm.rows());
+        return true;
+    });
+}
+
+//______________________________________________________________________________
+std::size_t cat::snapshot::images() const
+{
+    /*! Returns the number of images. */
+    return _image.size();
+}
+
+//______________________________________________________________________________
+double cat::snapshot::period() const
+{
+    /*! Returns the period between two shots [s]. */
+    return _period.load() / 1000.0;
+}
+
+//______________________________________________________________________________
+void cat::snapshot::period(const double& period)
+{
+    /*! Sets the period between two shots [s], 10 ms at least. A running
+        exporter takes it from the next shot on.
+    */
+    _period = std::max<int64_t>(10, static_cast<int64_t>(period * 1000 + 0.5));
+}
+
+//______________________________________________________________________________
+bool cat::snapshot::history() const
+{
+    /*! Returns true if numbered copies of the shots are kept. */
+    return _history;
+}
+
+//______________________________________________________________________________
+void cat::snapshot::history(const bool& keep)
+{
+    /*! Keeps ('<name>_NNNNNN.png') or not a copy of every shot. */
+    _history = keep;
+}
+
+//______________________________________________________________________________
+void cat::snapshot::start()
+{
+    /*! Starts the exporter thread. The first shot comes after one period. */
+    if (running()) return;
+    _stop = false;
+    _thread = std::thread(&cat::snapshot::loop, this);
+}
+
+//______________________________________________________________________________
+void cat::snapshot::stop()
+{
+    /*! Stops the exporter thread, waiting for the current shot to be done. */
+    {
+        std::lock_guard<std::mutex> lock(_wake);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_thread.joinable()) _thread.join();
+}
+
+//______________________________________________________________________________
+bool cat::snapshot::running() const
+{
+    /*! Returns true while the exporter thread runs. */
+    return _thread.joinable() && !_stop;
+}
+
+//______________________________________________________________________________
+std::size_t cat::snapshot::shoot()
+{
+    /*! Paints and saves all the images now, in the calling thread (also while
+        the exporter thread runs, the shots being serialized). A painter
+        throwing counts as a failure. Returns the number of images saved.
+    */
+    std::lock_guard<std::mutex> lock(_shoot);
+    std::error_code ec;
+    std::filesystem::create_directories(_dir, ec);
+    std::size_t saved = 0;
+    for (auto& im : _image) {
+        try {
+            if (!im->draw(im->cv)) continue;
+        } catch (const std::exception&) {
+            _failures++;
+            continue;
+        }
+        if (save(*im)) {
+            im->count++;
+            saved++;
+            _shots++;
+        } else {
+            _failures++;
+        }
+    }
+    return saved;
+}
+
+//______________________________________________________________________________
+uint64_t cat::snapshot::shots() const
+{
+    /*! Returns the number of images saved so far. */
+    return _shots;
+}
+
+//______________________________________________________________________________
+uint64_t cat::snapshot::failures() const
+{
+    /*! Returns the number of images which failed, painting or saving. */
+    return _failures;
+}
@@ -0,0 +1,131 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Periodic image snapshots                     --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"snapshot.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'snapshot' object exports monitoring images (hitmaps, event displays)
+// as PNG files at a fixed cadence, from a background thread of its own, with
+// no display at all: every image is painted into its offscreen 'canvas' by a
+// user 'painter', then saved. A 'hitmap' needs no painter, its snapshots are
+// drawn through the canvas palette.
+// Files are '<dir>/<name>.png', replaced atomically (written aside, then
+// renamed) so that a web page or a copy job never reads half an image; the
+// history option keeps a numbered copy of every shot as well.
+// MIND: painters run in the exporter thread, so whatever they read must be
+// safe to read from there. A hitmap added here is the consumer of its
+// snapshots ('hitmap::snapshot' swaps them out): no one else should take
+// them.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef snapshot_HPP
+#define snapshot_HPP
+
+// Application units.
+#include "canvas.hpp"
+#include "hitmap.hpp"
+
+// Standard library
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+
+//______________________________________________________________________________
+namespace cat { class snapshot; }
+class cat::snapshot
+{
+
+public:
+
+	// Draws an image, returns false to skip this shot (nothing new).
+	typedef std::function<bool(cat::canvas&)> painter;
+
+	// Special members.
+	snapshot(const std::string& = ".", const double& = 10);	//!< Ctor.
+	~snapshot();				//!< Dtor.
+
+	// No copy allowed, the exporter owns its thread.
+	snapshot(const snapshot&) = delete;
+	snapshot& operator=(const snapshot&) = delete;
+
+	// Setup (before 'start').
+	void add(const std::string&, const int&, const int&, const painter&);	//!< Add an image.
+	void add(const std::string&, cat::hitmap&, const int& = 0, const int& = 0);	//!< Add a hitmap image.
+	std::size_t images() const;	//!< Number of images.
+
+	// Cadence (any time).
+	double period() const;		//!< Retrieve the period [s].
+	void period(const double&);	//!< Set the period [s].
+	bool history() const;		//!< Whether numbered copies are kept.
+	void history(const bool&);	//!< Keep numbered copies of every shot.
+
+	// Running.
+	void start();				//!< Start the exporter thread.
+	void stop();				//!< Stop the exporter thread.
+	bool running() const;		//!< True while the exporter thread runs.
+	std::size_t shoot();		//!< Export all the images now.
+
+	// Monitoring.
+	uint64_t shots() const;		//!< Retrieve the images saved so far.
+	uint64_t failures() const;	//!< Retrieve the images failed so far.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Single image.
+	struct image {
+		std::string name;		// File name, no extension.
+		cat::canvas cv;			// Framebuffer.
+		painter draw;			// Painter.
+		uint64_t count;			// Shots of this image.
+	};
+
+	// Support routines.
+	void loop();				// Exporter thread.
+	bool save(image&);			// Writes an image file.
+
+	// Setup.
+	std::string _dir;					// Output directory.
+	std::vector<std::unique_ptr<image>> _image;
+	std::atomic<int64_t> _period;		// [ms]
+	std::atomic<bool> _history;			// Keep numbered copies.
+
+	// Thread.
+	std::thread _thread;
+	std::atomic<bool> _stop;
+	std::mutex _wake;					// Guards the stop wait.
+	std::condition_variable _cv;		// Wakes the thread up on stop.
+	std::mutex _shoot;					// Serializes the shots.
+
+	// Counters.
+	std::atomic<uint64_t> _shots;
+	std::atomic<uint64_t> _failures;
+};
+
+// Overloading check
+#endif
@@ -0,0 +1,194 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel batch time sorter                      --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"sorter.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "sorter.hpp"
+
+// Standard library
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::sorter::sorter(const int& bits) :
+    _roll(bits)
+{
+    /*! Ctor. \c bits is the width of the hardware timestamps, which roll over
+        every 2^bits counts; 0 means they do not roll over (or have already
+        been unwrapped, e.g. by the 'decoder'), and 'unwrap' does nothing.
+    */
+}
+
+//______________________________________________________________________________
+cat::sorter::~sorter()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+template <typename T>
+void cat::sorter::radix(cat::batch& b)
+{
+    /* Radix sort of \c b, moving the charges too for the analog traits. */
+    const std::size_t n = b.size();
+    if (n < 2) return;
+    long* tsp = b.tsp();
+    int* col = b.col();
+    int* row = b.row();
+    float* chg = b.charge();
+
+    // Time range, and the common case of an already sorted batch.
+    bool sorted = true;
+    long lo = tsp[0], hi = tsp[0];
+    for (std::size_t i = 1; i < n; i++) {
+        sorted &= tsp[i] >= tsp[i - 1];
+        lo = std::min(lo, tsp[i]);
+        hi = std::max(hi, tsp[i]);
+    }
+    if (sorted) return;
+
+    // Keys relative to the batch start, and all the digits histograms at once.
+    const uint64_t range = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+    int digits = 0;
+    while (digits < 8 && (range >> (8 * digits))) digits++;
+    _key[0].resize(n);
+    _key[1].resize(n);
+    _col.resize(n);
+    _row.resize(n);
+    if constexpr (T::charged) _chg.resize(n);
+    std::size_t count[8 * 256];
+    std::memset(count, 0, sizeof(std::size_t) * 256 * digits);
+    uint64_t* key = _key[0].data();
+    for (std::size_t i = 0; i < n; i++) {
+        const uint64_t k = static_cast<uint64_t>(tsp[i]) - static_cast<uint64_t>(lo);
+        key[i] = k;
+        for (int d = 0; d < digits; d++) count[d * 256 + ((k >> (8 * d)) & 0xFF)]++;
+    }
+
+    // Passes, swapping source and destination arrays every time.
+    uint64_t* ks = _key[0].data();
+    uint64_t* kd = _key[1].data();
+    int* cs = col;
+    int* cd = _col.data();
+    int* rs = row;
+    int* rd = _row.data();
+    float* qs = chg;
+    float* qd = _chg.data();
+    for (int d = 0; d < digits; d++) {
+
+        // Skip the digits equal for all the pixels.
+        std::size_t* cnt = &count[d * 256];
+        const unsigned shift = 8 * d;
+        if (cnt[(ks[0] >> shift) & 0xFF] == n) continue;
+
+        // Offsets.
+        std::size_t pos = 0;
+        for (int v = 0; v < 256; v++) {
+            const std::size_t c = cnt[v];
+            cnt[v] = pos;
+            pos += c;
+        }
+
+        // Scatter.
+        for (std::size_t i = 0; i < n; i++) {
+            const std::size_t j = cnt[(ks[i] >> shift) & 0xFF]++;
+            kd[j] = ks[i];
+            cd[j] = cs[i];
+            rd[j] = rs[i];
+            if constexpr (T::charged) qd[j] = qs[i];
+        }
+        std::swap(ks, kd);
+        std::swap(cs, cd);
+        std::swap(rs, rd);
+        std::swap(qs, qd);
+    }
+
+    // Back into the batch.
+    for (std::size_t i = 0; i < n; i++) tsp[i] = static_cast<long>(ks[i] + static_cast<uint64_t>(lo));
+    if (cs != col) {
+        std::memcpy(col, cs, n * sizeof(int));
+        std::memcpy(row, rs, n * sizeof(int));
+        if constexpr (T::charged) std::memcpy(chg, qs, n * sizeof(float));
+    }
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int cat::sorter::bits() const
+{
+    /*! Returns the hardware timestamps width, 0 if not rolling over. */
+    return _roll.bits();
+}
+
+//______________________________________________________________________________
+long cat::sorter::epoch() const
+{
+    /*! Returns the offset currently added to the raw timestamps. */
+    return _roll.epoch();
+}
+
+//______________________________________________________________________________
+void cat::sorter::reset()
+{
+    /*! Resets the rollover tracking, when the pixel stream restarts. */
+    _roll.reset();
+}
+
+//______________________________________________________________________________
+void cat::sorter::unwrap(cat::batch& b)
+{
+    /*! Replaces the raw timestamps of \c b with monotonic ones (see the
+        'rollover').
+    */
+    _roll.unwrap(b.tsp(), b.size());
+}
+
+//______________________________________________________________________________
+void cat::sorter::sort(cat::batch& b)
+{
+    /*! Sorts the pixels of \c b by timestamp (stable: pixels with the same
+        timestamp keep their order).
+    */
+    if (b.analog()) radix<cat::analog>(b);
+    else radix<cat::digital>(b);
+}
+
+//______________________________________________________________________________
+void cat::sorter::order(cat::batch& b)
+{
+    /*! Unwraps the timestamps of \c b, then sorts it. */
+    unwrap(b);
+    sort(b);
+}
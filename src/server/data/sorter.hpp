@@ -0,0 +1,88 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Pixel batch time sorter                      --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"sorter.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'sorter' object puts the pixels of a 'batch' in time order, as wanted
+// by both the clustering and the event building. Two steps:
+//	- 'unwrap' turns the wrapping hardware timestamps into monotonic ones,
+//	  adding a running epoch which advances at every rollover (pixels late
+//	  across a rollover, by less than half a period, keep the previous one);
+//	- 'sort' runs an LSD radix sort (8 bit digits) on the timestamps, moving
+//	  columns, rows (and charges) along. Only the digits spanned by the batch
+//	  time range are sorted, and digits equal for all the pixels are skipped,
+//	  so a batch covering a short time needs just one or two passes.
+// The radix scratch arrays are kept by the sorter and reused batch after
+// batch. As the unwrapping keeps a state, a sorter serves one pixel stream.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef sorter_HPP
+#define sorter_HPP
+
+// Application units.
+#include "batch.hpp"
+#include "rollover.hpp"
+
+// Standard library
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+
+//______________________________________________________________________________
+namespace cat { class sorter; }
+class cat::sorter
+{
+
+public:
+
+	// Special members.
+	sorter(const int& = 0);		//!< Ctor.
+	~sorter();					//!< Dtor.
+
+	// Properties.
+	int bits() const;			//!< Retrieve the hardware timestamp width.
+	long epoch() const;			//!< Retrieve the current rollover offset.
+	void reset();				//!< Reset the rollover tracking.
+
+	// Ordering.
+	void unwrap(cat::batch&);	//!< Unwrap the rollover of the timestamps.
+	void sort(cat::batch&);		//!< Sort the pixels by timestamp.
+	void order(cat::batch&);	//!< Unwrap, then sort.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Rollover tracking.
+	cat::rollover _roll;		// Timestamps unwrapping.
+
+	// Radix scratch.
+	std::vector<uint64_t> _key[2];
+	std::vector<int> _col;
+	std::vector<int> _row;
+	std::vector<float> _chg;
+
+	// Support routines.
+	template <typename T> void radix(cat::batch&);
+};
+
+// Overloading check
+#endif
@@ -0,0 +1,404 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Streaming statistics                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"stats.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "stats.hpp"
+#include "caf.hpp"
+
+// Standard library
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::moments::moments()
+{
+    /*! Ctor. Starts empty. */
+    clear();
+}
+
+//______________________________________________________________________________
+cat::moments::~moments()
+{
+    /*! Dtor. Nothing really to do. */
+}
+
+//______________________________________________________________________________
+cat::sketch::sketch(const int& k) :
+    _k(k),
+    _n(0),
+    _size(0),
+    _total(0),
+    _coin(0x5EED)
+{
+    /*! Ctor. \c k sets the accuracy: the normalized rank error is about
+        1.7 / k, the memory about 3 k values.
+    */
+    if (k < 8) throw std::runtime_error{ "sketch: accuracy parameter too small" };
+    _level.resize(1);
+    _total = capacity(0);
+}
+
+//______________________________________________________________________________
+cat::sketch::~sketch()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+//______________________________________________________________________________
+cat::stats::stats(const int& k) :
+    _sketch{ cat::sketch(k), cat::sketch(k), cat::sketch(k), cat::sketch(k) },
+    _started(false),
+    _last(0)
+{
+    /*! Ctor. \c k is the accuracy parameter of the metrics sketches. */
+}
+
+//______________________________________________________________________________
+cat::stats::~stats()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::size_t cat::sketch::capacity(const std::size_t& h) const
+{
+    /* Capacity of the \c h level: k at the top level, shrinking by 2/3 at
+       every level down, but never below 2.
+    */
+    const double c = _k * std::pow(2.0 / 3.0, static_cast<double>(_level.size() - 1 - h));
+    return std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(c)));
+}
+
+//______________________________________________________________________________
+void cat::sketch::compress()
+{
+    /* Compacts the lowest full level while the sketch exceeds its total
+       capacity: the level is sorted and half of its items, every other one
+       from a random offset, are promoted with a doubled weight.
+    */
+    while (_size >= _total) {
+        for (std::size_t h = 0; h < _level.size(); h++) {
+            std::vector<float>& lv = _level[h];
+            if (lv.size() < capacity(h)) continue;
+            if (h + 1 == _level.size()) {
+                _level.emplace_back();
+                _total = 0;
+                for (std::size_t l = 0; l < _level.size(); l++) _total += capacity(l);
+            }
+            std::vector<float>& up = _level[h + 1];
+            std::vector<float>& cur = _level[h];
+            std::sort(cur.begin(), cur.end());
+
+            // An odd item stays behind.
+            float odd = 0;
+            const bool keep = cur.size() & 1;
+            if (keep) {
+                odd = cur.back();
+                cur.pop_back();
+            }
+            const std::size_t offset = _coin() & 1;
+            for (std::size_t i = offset; i < cur.size(); i += 2) up.push_back(cur[i]);
+            _size -= cur.size() / 2;
+            cur.clear();
+            if (keep) cur.push_back(odd);
+            break;
+        }
+    }
+}
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+//______________________________________________________________________________
+std::ostream& operator<<(std::ostream& os, const cat::stats& st)
+{
+    // One {name: n, mean +- sigma, median [p10, p90]} block per metric.
+    for (int m = 0; m < cat::stats::M_COUNT; m++) {
+        const cat::stats::metric id = static_cast<cat::stats::metric>(m);
+        const cat::moments& mo = st.moments(id);
+        const cat::sketch& sk = st.sketch(id);
+        os << "{" << cat::caf::fcol(C_CL_COL) << cat::stats::name(id) << cat::caf::rst()
+           << ": " << mo.count() << ", " << mo.mean() << " +- " << mo.sigma()
+           << ", " << sk.quantile(0.5) << " [" << sk.quantile(0.1) << ", " << sk.quantile(0.9) << "]} ";
+    }
+
+    // Return.
+    return os;
+}
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void cat::moments::add(const double& x)
+{
+    /*! Adds the value \c x (Welford update). */
+    _n++;
+    const double d = x - _mean;
+    _mean += d / static_cast<double>(_n);
+    _m2 += d * (x - _mean);
+    _min = std::min(_min, x);
+    _max = std::max(_max, x);
+}
+
+//______________________________________________________________________________
+void cat::moments::merge(const cat::moments& m)
+{
+    /*! Merges the stream \c m (pairwise combination of the moments). */
+    if (!m._n) return;
+    if (!_n) {
+        *this = m;
+        return;
+    }
+    const double na = static_cast<double>(_n);
+    const double nb = static_cast<double>(m._n);
+    const double d = m._mean - _mean;
+    _n += m._n;
+    _mean += d * nb / (na + nb);
+    _m2 += m._m2 + d * d * na * nb / (na + nb);
+    _min = std::min(_min, m._min);
+    _max = std::max(_max, m._max);
+}
+
+//______________________________________________________________________________
+void cat::moments::clear()
+{
+    /*! Restarts from an empty stream. */
+    _n = 0;
+    _mean = 0;
+    _m2 = 0;
+    _min = std::numeric_limits<double>::infinity();
+    _max = -std::numeric_limits<double>::infinity();
+}
+
+//______________________________________________________________________________
+uint64_t cat::moments::count() const
+{
+    /*! Returns the number of values. */
+    return _n;
+}
+
+//______________________________________________________________________________
+double cat::moments::mean() const
+{
+    /*! Returns the mean, 0 if empty. */
+    return _mean;
+}
+
+//______________________________________________________________________________
+double cat::moments::variance() const
+{
+    /*! Returns the sample variance, 0 with less than two values. */
+    return _n > 1 ? _m2 / static_cast<double>(_n - 1) : 0;
+}
+
+//______________________________________________________________________________
+double cat::moments::sigma() const
+{
+    /*! Returns the sample standard deviation. */
+    return std::sqrt(variance());
+}
+
+//______________________________________________________________________________
+double cat::moments::min() const
+{
+    /*! Returns the minimum, +inf if empty. */
+    return _min;
+}
+
+//______________________________________________________________________________
+double cat::moments::max() const
+{
+    /*! Returns the maximum, -inf if empty. */
+    return _max;
+}
+
+//______________________________________________________________________________
+void cat::sketch::add(const float& x)
+{
+    /*! Adds the value \c x. */
+    _level[0].push_back(x);
+    _size++;
+    _n++;
+    if (_size >= _total) compress();
+}
+
+//______________________________________________________________________________
+void cat::sketch::merge(const cat::sketch& s)
+{
+    /*! Merges the sketch \c s, level by level, then compacts. */
+    if (_level.size() < s._level.size()) {
+        _level.resize(s._level.size());
+        _total = 0;
+        for (std::size_t l = 0; l < _level.size(); l++) _total += capacity(l);
+    }
+    for (std::size_t h = 0; h < s._level.size(); h++) {
+        _level[h].insert(_level[h].end(), s._level[h].begin(), s._level[h].end());
+    }
+    _size += s._size;
+    _n += s._n;
+    compress();
+}
+
+//______________________________________________________________________________
+void cat::sketch::clear()
+{
+    /*! Restarts from an empty stream. */
+    _level.assign(1, std::vector<float>());
+    _total = capacity(0);
+    _size = 0;
+    _n = 0;
+}
+
+//______________________________________________________________________________
+int cat::sketch::k() const
+{
+    /*! Returns the accuracy parameter. */
+    return _k;
+}
+
+//______________________________________________________________________________
+uint64_t cat::sketch::count() const
+{
+    /*! Returns the number of values added (merged ones included). */
+    return _n;
+}
+
+//______________________________________________________________________________
+std::size_t cat::sketch::size() const
+{
+    /*! Returns the number of values actually stored. */
+    return _size;
+}
+
+//______________________________________________________________________________
+float cat::sketch::quantile(const double& q) const
+{
+    /*! Returns the estimated \c q quantile (0 <= q <= 1), 0 if empty. */
+    if (!_size) return 0;
+    std::vector<std::pair<float, uint64_t>> items;
+    items.reserve(_size);
+    for (std::size_t h = 0; h < _level.size(); h++) {
+        for (const float& x : _level[h]) items.push_back({ x, uint64_t(1) << h });
+    }
+    std::sort(items.begin(), items.end());
+    uint64_t total = 0;
+    for (const auto& it : items) total += it.second;
+    const double target = std::clamp(q, 0.0, 1.0) * static_cast<double>(total);
+    uint64_t sum = 0;
+    for (const auto& it : items) {
+        sum += it.second;
+        if (static_cast<double>(sum) >= target) return it.first;
+    }
+    return items.back().first;
+}
+
+//______________________________________________________________________________
+double cat::sketch::rank(const float& x) const
+{
+    /*! Returns the estimated fraction of the values not larger than \c x. */
+    uint64_t below = 0, total = 0;
+    for (std::size_t h = 0; h < _level.size(); h++) {
+        for (const float& v : _level[h]) {
+            total += uint64_t(1) << h;
+            if (v <= x) below += uint64_t(1) << h;
+        }
+    }
+    return total ? static_cast<double>(below) / static_cast<double>(total) : 0;
+}
+
+//______________________________________________________________________________
+void cat::stats::fill(const cat::cluster& cl)
+{
+    /*! Adds the metrics of the (updated) cluster \c cl. The time distance is
+        taken from the previous cluster filled in this object.
+    */
+    const double v[M_DT] = { static_cast<double>(cl.mult()),
+                             static_cast<double>(cl.width()),
+                             static_cast<double>(cl.height()) };
+    for (int m = 0; m < M_DT; m++) {
+        _moments[m].add(v[m]);
+        _sketch[m].add(static_cast<float>(v[m]));
+    }
+    if (_started) {
+        const double dt = static_cast<double>(cl.tsp() - _last);
+        _moments[M_DT].add(dt);
+        _sketch[M_DT].add(static_cast<float>(dt));
+    }
+    _started = true;
+    _last = cl.tsp();
+}
+
+//______________________________________________________________________________
+void cat::stats::merge(const cat::stats& st)
+{
+    /*! Merges the metrics of \c st. */
+    for (int m = 0; m < M_COUNT; m++) {
+        _moments[m].merge(st._moments[m]);
+        _sketch[m].merge(st._sketch[m]);
+    }
+}
+
+//______________________________________________________________________________
+void cat::stats::clear()
+{
+    /*! Restarts all the metrics from empty. */
+    for (int m = 0; m < M_COUNT; m++) {
+        _moments[m].clear();
+        _sketch[m].clear();
+    }
+    _started = false;
+    _last = 0;
+}
+
+//______________________________________________________________________________
+const cat::moments& cat::stats::moments(const metric& m) const
+{
+    /*! Returns the moments of the metric \c m. */
+    return _moments[m];
+}
+
+//______________________________________________________________________________
+const cat::sketch& cat::stats::sketch(const metric& m) const
+{
+    /*! Returns the distribution sketch of the metric \c m. */
+    return _sketch[m];
+}
+
+//______________________________________________________________________________
+const char* cat::stats::name(const metric& m)
+{
+    /*! Returns the name of the metric \c m. */
+    static const char* names[M_COUNT] = { "mult", "width", "height", "dt" };
+    return m >= 0 && m < M_COUNT ? names[m] : "";
+}
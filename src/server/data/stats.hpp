@@ -0,0 +1,169 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - Streaming statistics                         --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"stats.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// Streaming statistics for the data quality monitoring, in fixed memory
+// whatever the run length:
+//	- 'moments' keeps count, mean, variance (Welford update), minimum and
+//	  maximum of a value stream;
+//	- 'sketch' is a KLL quantile sketch: a stack of compactors, level h items
+//	  weighing 2^h. A full level is sorted and every other item (random
+//	  offset) is promoted to the next one, so the memory stays around 3 k
+//	  items and the rank error around 1/k;
+//	- 'stats' bundles both for the cluster metrics of a sensor (multiplicity,
+//	  width, height, time distance from the previous cluster).
+// All of them merge: each thread fills its own objects, and the display side
+// merges them into a total. None is thread safe by itself.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef stats_HPP
+#define stats_HPP
+
+// Application units.
+#include "cluster.hpp"
+
+// Standard library
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <ostream>
+
+
+//______________________________________________________________________________
+namespace cat { class moments; }
+class cat::moments
+{
+
+public:
+
+	// Special members.
+	moments();					//!< Ctor.
+	~moments();					//!< Dtor.
+
+	// Filling.
+	void add(const double&);	//!< Add a value.
+	void merge(const moments&);	//!< Merge another stream.
+	void clear();				//!< Restart from empty.
+
+	// Results.
+	uint64_t count() const;		//!< Retrieve the number of values.
+	double mean() const;		//!< Retrieve the mean.
+	double variance() const;	//!< Retrieve the (sample) variance.
+	double sigma() const;		//!< Retrieve the standard deviation.
+	double min() const;			//!< Retrieve the minimum.
+	double max() const;			//!< Retrieve the maximum.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	uint64_t _n;				// Values count.
+	double _mean;				// Running mean.
+	double _m2;					// Running sum of squared deviations.
+	double _min;				// Minimum.
+	double _max;				// Maximum.
+};
+
+
+//______________________________________________________________________________
+namespace cat { class sketch; }
+class cat::sketch
+{
+
+public:
+
+	// Special members.
+	sketch(const int& = 200);	//!< Ctor.
+	~sketch();					//!< Dtor.
+
+	// Filling.
+	void add(const float&);		//!< Add a value.
+	void merge(const sketch&);	//!< Merge another sketch.
+	void clear();				//!< Restart from empty.
+
+	// Results.
+	int k() const;				//!< Retrieve the accuracy parameter.
+	uint64_t count() const;		//!< Retrieve the number of values.
+	std::size_t size() const;	//!< Retrieve the number of stored items.
+	float quantile(const double&) const;	//!< Retrieve a quantile.
+	double rank(const float&) const;		//!< Retrieve the normalized rank of a value.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	int _k;									// Accuracy parameter.
+	uint64_t _n;							// Values count.
+	std::size_t _size;						// Stored items.
+	std::size_t _total;						// Levels total capacity.
+	std::vector<std::vector<float>> _level;	// Compactors.
+	std::minstd_rand _coin;					// Compaction offsets.
+
+	// Support routines.
+	std::size_t capacity(const std::size_t&) const;
+	void compress();
+};
+
+
+//______________________________________________________________________________
+namespace cat { class stats; }
+class cat::stats
+{
+
+public:
+
+	// Monitored metrics.
+	enum metric { M_MULT = 0, M_WIDTH, M_HEIGHT, M_DT, M_COUNT };
+
+	// Special members.
+	stats(const int& = 200);	//!< Ctor.
+	~stats();					//!< Dtor.
+
+	// Filling.
+	void fill(const cat::cluster&);	//!< Add a cluster.
+	void merge(const stats&);		//!< Merge another set.
+	void clear();					//!< Restart from empty.
+
+	// Results.
+	const cat::moments& moments(const metric&) const;	//!< Retrieve a metric moments.
+	const cat::sketch& sketch(const metric&) const;		//!< Retrieve a metric distribution.
+	static const char* name(const metric&);				//!< Retrieve a metric name.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	cat::moments _moments[M_COUNT];
+	cat::sketch _sketch[M_COUNT];
+	bool _started;				// Any cluster seen yet.
+	long _last;					// Previous cluster timestamp.
+};
+
+//______________________________________________________________________________
+// Operators overload
+std::ostream& operator<<(std::ostream&, const cat::stats&);
+
+// Overloading check
+#endif
@@ -0,0 +1,104 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - ToT charge calibration                       --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"tot.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [Date]	        "19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application units
+#include "tot.hpp"
+
+// Standard library
+#include <cmath>
+#include <stdexcept>
+
+
+
+// *****************************************************************************
+// **                            Special members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+cat::tot::tot(const float& a, const float& b, const float& c, const float& t, const int& range) :
+    _a(a), _b(b), _c(c), _t(t)
+{
+    /*! Ctor. \c a, \c b, \c c and \c t are the curve parameters, \c range the
+        number of ToT values the readout can give (the table size).
+    */
+    if (a <= 0) throw std::runtime_error{ "tot: the curve slope must be positive" };
+    _table.resize(range > 0 ? range : 1);
+    for (std::size_t i = 0; i < _table.size(); i++) _table[i] = charge(static_cast<float>(i));
+}
+
+//______________________________________________________________________________
+cat::tot::~tot()
+{
+    /*! Dtor. Nothing really to do, all members are managed. */
+}
+
+
+// *****************************************************************************
+// **                            Private members                              **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                           Operators overload                            **
+// *****************************************************************************
+
+
+// *****************************************************************************
+// **                             Public members                              **
+// *****************************************************************************
+
+//______________________________________________________________________________
+float cat::tot::charge(const float& tot) const
+{
+    /*! Returns the charge giving \c tot, i.e. the larger root of
+        a Q^2 - (ToT + a t - b) Q + (ToT t - b t - c) = 0. ToT values below
+        the curve reach give the threshold charge.
+    */
+    const double a = _a, b = _b, c = _c, t = _t;
+    const double B = tot + a * t - b;
+    const double C = tot * t - b * t - c;
+    const double D = B * B - 4 * a * C;
+    if (D < 0) return _t;
+    return static_cast<float>((B + std::sqrt(D)) / (2 * a));
+}
+
+//______________________________________________________________________________
+float cat::tot::tot2q(const int& tot) const
+{
+    /*! Returns the charge of the integer ToT \c tot from the table, clamped to
+        the readout range.
+    */
+    if (tot <= 0) return _table.front();
+    if (tot >= static_cast<int>(_table.size())) return _table.back();
+    return _table[tot];
+}
+
+//______________________________________________________________________________
+void cat::tot::apply(cat::batch& b) const
+{
+    /*! Converts in place the charges of the analog batch \c b, holding the
+        raw ToT values, into calibrated charges.
+    */
+    float* q = b.charge();
+    if (!q) return;
+    const std::size_t n = b.size();
+    const int last = static_cast<int>(_table.size()) - 1;
+    const float* table = _table.data();
+    for (std::size_t i = 0; i < n; i++) {
+        int k = static_cast<int>(q[i]);
+        k = k < 0 ? 0 : (k > last ? last : k);
+        q[i] = table[k];
+    }
+}
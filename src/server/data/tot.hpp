@@ -0,0 +1,74 @@
+﻿//------------------------------------------------------------------------------
+// CAT - C++ Analysis Template - ToT charge calibration                       --
+// (C) Piero Giubilato 2011-2024, INFN PD									  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"tot.hpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"0.1"
+// [Modified by]	"Piero Giubilato"
+// [cat]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+//==============================================================================
+// The 'tot' object converts the Time over Threshold measured by the pixels
+// into charge, through the usual surrogate calibration curve:
+//
+//		ToT(Q) = a * Q + b - c / (Q - t)
+//
+// (linear at high charge, dropping near the threshold t). The inverse is
+// solved once for every integer ToT up to the readout range, so converting
+// a whole batch is a table lookup per pixel.
+//==============================================================================
+
+
+#pragma once
+
+// Overloading check
+#ifndef tot_HPP
+#define tot_HPP
+
+// Application units.
+#include "batch.hpp"
+
+// Standard library
+#include <vector>
+
+
+//______________________________________________________________________________
+namespace cat { class tot; }
+class cat::tot
+{
+
+public:
+
+	// Special members.
+	tot(const float&, const float&, const float&, const float&, const int& = 1024);	//!< Ctor.
+	~tot();						//!< Dtor.
+
+	// Conversion.
+	float charge(const float&) const;	//!< Charge of a ToT value.
+	float tot2q(const int&) const;		//!< Charge of an integer ToT (table).
+	void apply(cat::batch&) const;		//!< Convert a batch ToT to charge.
+
+protected:
+
+	// No protected at the moment
+
+private:
+
+	// Curve parameters.
+	float _a;
+	float _b;
+	float _c;
+	float _t;
+
+	// Conversion table.
+	std::vector<float> _table;
+};
+
+// Overloading check
+#endif
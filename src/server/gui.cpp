@@ -76,8 +76,8 @@ cat::gui::gui() :
             //sf::Window _window(sf::VideoMode(_winWidth, _winHeight), _winTitle);
             _window.create(sf::VideoMode(_winWidth, _winHeight), _winTitle);
 
-            // Frame rate limit, to avoid system overload when not necessary.
-            _window.setFramerateLimit(60);
+            // No frame rate limit: frames are drawn on demand, see
+            // cat::window::event().
             
             // Create the GUI interface.
             ImGui::SFML::Init(_window);
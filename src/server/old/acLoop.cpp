@@ -17,6 +17,7 @@
 #include "acLoop.h"
 #include "acMain.h"
 #include "acServer.h"
+#include "gpArray.h"
 
 // #############################################################################
 // Open namespaces
@@ -267,6 +268,58 @@ bool loop::cmdSceneAddGP(const std::string& cHnd, const Uint64& sIdx, std::strin
 	return false;
 }
 
+//______________________________________________________________________________
+bool loop::cmdScenePatchGP(const std::string& cHnd, const Uint64& sIdx, 
+						   const Uint64& gpHnd, std::stringstream& buf)
+{
+	/*! Patches the GP \c gpHnd of the scene \c sIdx of the \c cHnd Client
+		scene list. \c buf is the stream containing the patch record. Only 2D
+		arrays accept patches (tile records) at the moment. Returns false if
+		no errors occur, true otherwise.
+		\c gpHnd is the client handle of the GP. The add path streams it into
+		the GP (see GP::stream), so it is matched against GP::handle(), not
+		used as a server index: the two match as long as the client and the
+		server scenes grow in step, otherwise the GP is searched for.
+	*/
+
+	// Search for the client.
+	Uint64 cIdx = 0;
+	for (cIdx; cIdx < _client.size(); cIdx++) if (_client[cIdx].cHnd == cHnd) break;
+	if (cIdx >= _client.size()) return true;
+	
+	// Check it the scene actually exists in the scene list.
+	if (sIdx >= _client[cIdx].sHnd.size()) return true;
+
+	// Retrieve the actual scene Handle and pointer, then the GP.
+	Uint64 sHnd = _client[cIdx].sHnd[sIdx];
+	gp::scene* sPtr = _pad[1]->sceneGet(sHnd);
+	if (!sPtr) return true;
+	gp::GP* gp = sPtr->gpGet(gpHnd);
+	if (!gp || gp->handle() != gpHnd) {
+		gp = 0;
+		for (size_t h = 1; h < sPtr->gpSize() && !gp; h++) {
+			gp::GP* g = sPtr->gpGet(h);
+			if (g && g->handle() == gpHnd) gp = g;
+		}
+	}
+	if (!gp || gp->type() != CO::oType::gpArray) return true;
+
+	// Patch the array in place. The batch then overwrites the array mesh in
+	// place at the next draw.
+	if (static_cast<gp::array*>(gp)->tileLoad(buf)) return true;
+	_pad[1]->refresh();
+	
+	// Info
+	if (cat::ag::_verbose >= CAT_VERB_FULL) {
+		std::cout << "GP [" << COL(LWHITE) << gpHnd << COL(DEFAULT) << "] patched in scene [" 
+				  << COL(LWHITE) << sHnd << COL(DEFAULT) << "] from client [" 
+				  << COL(LGREEN) << cHnd << COL(DEFAULT) << "]\n";
+   	}
+	
+	// Everything fine.
+	return false;
+}
+
 //______________________________________________________________________________
 ui::pad* loop::padGet(const Uint64& pIdx)
 {
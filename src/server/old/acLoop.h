@@ -74,6 +74,7 @@ class loop  //: public ac
 		Uint64 cmdSceneBegin(const std::string&, std::stringstream&);				//!< Starts a new scene.
 		bool cmdSceneClose(const std::string&, const Uint64&);						//!< Closes an existing scene.
 		bool cmdSceneAddGP(const std::string&, const Uint64&, std::stringstream&);	//!< Adds a GP to a scene.
+		bool cmdScenePatchGP(const std::string&, const Uint64&, const Uint64&, std::stringstream&);	//!< Patches a GP of a scene.
 
 		// Application elements access.
 		ui::pad* padGet(const Uint64& = 1);	//!< Returns pointer to pIdx pad.	 
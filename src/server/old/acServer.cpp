@@ -271,9 +271,9 @@ bool server::parse(const Uint64& cIdx, const char* cBuf, const Uint64& cLen)
 		std::cout << COL(DEFAULT) << "]\n";
 	}
 	
-	// Retrieves the data buffer for BEGIN and ADD commands.
+	// Retrieves the data buffer for BEGIN, ADD and PATCH commands.
 	std::stringstream dataBuf(std::ios::binary | std::ios::out | std::ios::in);	
-	if (cmd == rc::kCmd::begin || cmd == rc::kCmd::add) {
+	if (cmd == rc::kCmd::begin || cmd == rc::kCmd::add || cmd == rc::kCmd::patch) {
 		read(cIdx, dataBuf, cArg3);
 	}
 
@@ -313,6 +313,11 @@ bool server::parse(const Uint64& cIdx, const char* cBuf, const Uint64& cLen)
 		return cat::ac::_loop->cmdSceneAddGP(_client[cIdx].cAdd, cArg1, dataBuf);
 	}
 
+	// The PATCH GP command.
+	if (cmd == rc::kCmd::patch) {
+		return cat::ac::_loop->cmdScenePatchGP(_client[cIdx].cAdd, cArg1, cArg2, dataBuf);
+	}
+
 	// The CLOSE command.
 	if (cmd == rc::kCmd::close) return cat::ac::_loop->cmdSceneClose(_client[cIdx].cAdd, cArg1);
 
@@ -546,6 +546,47 @@ void font::textDraw(const std::string& text, const std::vector<uint32_t>& color,
 	delete[] charDim;
 }
 
+//______________________________________________________________________________
+bool font::glyphDraw(const uint32_t& code, int32_t& left, int32_t& top,
+					 uint32_t& width, uint32_t& height, float& advance,
+					 std::vector<uint8_t>& map)
+{
+	/*! Renders the single glyph \c code with the currently loaded face, with
+	 *	no rotation (the text font angle is ignored), for the glyph atlas: the
+	 *	rotation is applied later to the glyph quads. The coverage (1 byte per
+	 *	pixel, rows top first, \c width x \c height) goes into \c map, the
+	 *	bitmap position respect the pen into \c left and \c top (pixels, y up)
+	 *	and the pen advance into \c advance. Returns false if the glyph could
+	 *	not be rendered.
+	 */
+
+	// Check if a face is available.
+	if (!_fFace) return false;
+
+	// No transformation, and render.
+	FT_Set_Transform(_fFace, 0, 0);
+	if (FT_Load_Char(_fFace, code, FT_LOAD_RENDER)) return false;
+	FT_GlyphSlot slot = _fFace->glyph;
+
+	// Metrics.
+	left = slot->bitmap_left;
+	top = slot->bitmap_top;
+	width = slot->bitmap.width;
+	height = slot->bitmap.rows;
+	advance = slot->advance.x / 64.0f;
+
+	// Coverage (the bitmap rows may be padded).
+	map.resize(width * height);
+	for (uint32_t y = 0; y < height; y++) {
+		const uint8_t* row = slot->bitmap.buffer + y * slot->bitmap.pitch;
+		for (uint32_t x = 0; x < width; x++) map[y * width + x] = row[x];
+	}
+
+	// Done.
+	return true;
+}
+
+
 
 // #############################################################################
 }} // Close namespaces
@@ -107,6 +107,14 @@ class font //: public AF
 		//! Draws the text on a pixmap.
 		void textDraw(const std::string& text, const std::vector<uint32_t>& color, 
 					  uint32_t& pxmWidth, uint32_t& pxmHeight, uint8_t*& pxmData);
+
+		//! Draws a single unrotated glyph of the text font (atlas caching).
+		bool glyphDraw(const uint32_t& code, int32_t& left, int32_t& top,
+					   uint32_t& width, uint32_t& height, float& advance,
+					   std::vector<uint8_t>& map);
+
+		//! Returns the text font line height (pixels).
+		uint32_t lineHeight() const {return _fLineHeight;}
 		
 		// Debug.
 		//void Test();
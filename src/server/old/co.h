@@ -110,7 +110,8 @@ class CO
 			gpCylinder,
 			gpCone,
 			gpSphere,
-			gpLabel
+			gpLabel,
+			gpArray
 			//131072,262144,524288, 1048576
 			// GT (Graphics Tools).
 		};
@@ -38,6 +38,7 @@
 //#include "pear_gp_Tube.h"
 //#include "pear_gp_Sphere.h"
 #include "gpLabel.h"
+#include "gpArray.h"
 
 
 //##############################################################################
@@ -177,6 +178,7 @@ gp::GP* GP::build(const uint64_t& type) const
 	//	case CO::oType::gpCone:		return new gp::cone();
 	//	case CO::oType::gpSphere:	return new gp::sphere();
 		case CO::oType::gpLabel:	return new gp::label();
+		case CO::oType::gpArray:	return new gp::array();
 	}
 
 	// Not recognized type!
@@ -781,6 +783,34 @@ void GP::glTrsfReset()
 	}
 }
 
+//______________________________________________________________________________
+bool GP::glMesh(mesh& m)
+{
+	/*! Writes the GP geometry, as triangles and lines, into the batch mesh
+	 *	\c m. GPs which can be drawn by the cat::gp::batch MUST overload this
+	 *	function and return true. The basic GP writes nothing and returns
+	 *	false, so it keeps being drawn by glDisplay().
+	 */
+	return false;
+}
+
+//______________________________________________________________________________
+void GP::glWorld(ge::point& p)
+{
+	/*! Moves the point \c p from the GP coordinates to the scene ones. It is
+	 *	the batched counterpart of glTrsfApply(), and MUST be overloaded for
+	 *	those GPs which carry a transformation. The function is hierarchical:
+	 *	the basic GP does not transform, and simply passes the point to the
+	 *	parent.
+	 */
+
+	// Transfer to parent.
+	if (_ownerPtr) {
+		GP* pPtr = _ownerPtr->gpGet(_parentHnd);
+		if (pPtr) pPtr->glWorld(p);  
+	}
+}
+
 //______________________________________________________________________________
 void GP::glDisplay()
 {
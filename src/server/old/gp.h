@@ -41,6 +41,8 @@
 // cat::go::gp::scene forward declaration
 namespace cat { namespace gp {
 	class scene;
+	class mesh;
+	class atlas;
 }}
 
 // #############################################################################
@@ -310,6 +312,10 @@ class GP : public CO
 			virtual void glTrsfApply();			//!< Apply (push) the gp Ref (hierarchical) transformation.
 			virtual void glTrsfReset();			//!< Reset (pop) the gp Ref (hierarchical) transformation.
 
+			// Batched drawing.
+			virtual bool glMesh(mesh&);			//!< Writes the GP geometry into a batch mesh.
+			virtual void glWorld(ge::point&);	//!< Moves a point through the (hierarchical) transformations.
+
 			// UI interaction.
 //			virtual void uiBarLoad(ui::Bar&);	//!< Load a bar with the GP specific properties.	
 //			static void TW_CALL cbkSizeGet(void*, void*);	//!< Get the GP size for TwBar.
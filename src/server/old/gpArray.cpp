@@ -0,0 +1,508 @@
+//------------------------------------------------------------------------------
+// CAT 2D Array Graphic Primitive class										  --
+// (C) Piero Giubilato 2011-2024, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpArray.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"c++"
+//______________________________________________________________________________
+
+// Application components.
+#include "gpArray.h"
+#include "gpBatch.h"
+
+#include <glad.h>
+
+// STL.
+#include <algorithm>
+
+// #############################################################################
+namespace cat { namespace gp {
+
+
+// *****************************************************************************
+// **								Special members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+array::array(): _cols(0), _rows(0), _colSize(0.1f), _rowSize(0.1f), _height(1),
+				_min(0), _max(0), _tileVersion(0),
+				_dirtyX0(0), _dirtyY0(0), _dirtyX1(0), _dirtyY1(0)
+{
+	/*! Default ctor, an empty grid. Mostly used by the GP factory before
+	 *	loading the array from a stream.
+	 */
+	#ifdef CAT_SERVER
+		_glTex = 0;
+		_texCols = _texRows = 0;
+	#endif
+}
+
+//______________________________________________________________________________
+array::array(const double* data, const uint32_t& cols, const uint32_t& rows,
+			 const double& colSize, const double& rowSize, const double& height)
+			: _cols(cols), _rows(rows), _colSize((float)colSize),
+			  _rowSize((float)rowSize), _height((float)height),
+			  _min(0), _max(0), _tileVersion(0),
+			  _dirtyX0(0), _dirtyY0(0), _dirtyX1(0), _dirtyY1(0)
+{
+	/*! Standard ctor. \c data points to \c cols x \c rows values, arranged
+	 *	by rows ({c0r0, c1r0, ..., c0r1, c1r1, ...}). \c colSize and \c rowSize
+	 *	are the cell sizes along X and Y, while \c height is the Z size of the
+	 *	cell holding the highest value (the lowest one being flat).
+	 */
+	#ifdef CAT_SERVER
+		_glTex = 0;
+		_texCols = _texRows = 0;
+	#endif
+
+	// Copy the whole payload at once.
+	_data.assign(data, data + (size_t)_cols * _rows);
+	range();
+	dirty(0, 0, _cols, _rows);
+}
+
+//______________________________________________________________________________
+array::~array()
+{
+	/*! Dtor. Releases the GL texture, if any. */
+	#ifdef CAT_SERVER
+		if (_glTex) glDeleteTextures(1, &_glTex);
+	#endif
+}
+
+
+// *****************************************************************************
+// **							Private support members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+bool array::inside(const uint32_t& x, const uint32_t& y, 
+				   const uint32_t& w, const uint32_t& h) const
+{
+	/*! Returns true if the (x, y, w, h) tile is a non empty part of the grid. */
+	return (w && h && x < _cols && y < _rows && w <= _cols - x && h <= _rows - y);
+}
+
+//______________________________________________________________________________
+void array::range()
+{
+	/*! Sets the values range from the whole payload. */
+	if (_data.empty()) {
+		_min = _max = 0;
+		return;
+	}
+	const auto mm = std::minmax_element(_data.begin(), _data.end());
+	_min = *mm.first;
+	_max = *mm.second;
+}
+
+//______________________________________________________________________________
+void array::patch(const uint32_t& x, const uint32_t& y, const uint32_t& w,
+				  const uint32_t& h, const float* data)
+{
+	/*! Copies the values \c data, by rows, into the (x, y, w, h) tile and
+	 *	marks it for upload. The range grows with the tile values alone,
+	 *	unless the tile overwrites a cell holding the lowest or the highest
+	 *	value with a different one: only then the whole payload is scanned.
+	 */
+	bool rescan = false;
+	float lo = data[0], hi = data[0];
+	for (uint32_t r = 0; r < h; r++) {
+		float* dst = _data.data() + (size_t)(y + r) * _cols + x;
+		const float* src = data + (size_t)r * w;
+		for (uint32_t c = 0; c < w; c++) {
+			if ((dst[c] == _min && src[c] > _min) || (dst[c] == _max && src[c] < _max)) rescan = true;
+			dst[c] = src[c];
+			lo = std::min(lo, src[c]);
+			hi = std::max(hi, src[c]);
+		}
+	}
+	if (rescan) {
+		range();
+	} else {
+		_min = std::min(_min, lo);
+		_max = std::max(_max, hi);
+	}
+	dirty(x, y, w, h);
+	modeNeedRedraw(true);
+}
+
+//______________________________________________________________________________
+void array::dirty(const uint32_t& x, const uint32_t& y, 
+				  const uint32_t& w, const uint32_t& h)
+{
+	/*! Grows the region to upload to include the (x, y, w, h) tile. */
+	if (_dirtyX0 >= _dirtyX1 || _dirtyY0 >= _dirtyY1) {
+		_dirtyX0 = x;
+		_dirtyY0 = y;
+		_dirtyX1 = x + w;
+		_dirtyY1 = y + h;
+	} else {
+		_dirtyX0 = std::min(_dirtyX0, x);
+		_dirtyY0 = std::min(_dirtyY0, y);
+		_dirtyX1 = std::max(_dirtyX1, x + w);
+		_dirtyY1 = std::max(_dirtyY1, y + h);
+	}
+}
+
+
+// *****************************************************************************
+// **					    Overloaded GP public members					  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+CO::oType array::type() const
+{
+	/*! Returns a numeric identification. */
+	return CO::oType::gpArray;
+}
+
+//______________________________________________________________________________
+cat::coVer_t array::version() const
+{
+	/*! Returns a numeric identification. */
+	return 100;
+}
+
+//______________________________________________________________________________
+std::string array::stem() const
+{
+	/*! Returns a string identification. */
+	return "array";
+}
+
+//______________________________________________________________________________
+size_t array::size(const bool& dynamic) const
+{
+	/*! Returns the complete (full static + full dynamic) allocated space for
+	 *	the GP if \c dynamic = false, the default call. If \c dynamic = true,
+	 *	it instead returns only the dynamically allocated space, without any
+	 *	contribution from the static part.
+	 */
+
+	// Get dynamically allocated size.
+	size_t tSize = filled::size(true) + _data.capacity() * sizeof(float);
+
+	// Returns.
+	if (dynamic) return tSize;
+	else return sizeof(*this) + tSize;
+}
+
+//______________________________________________________________________________
+void array::dump(const int& ind) const
+{
+	/*! Send out all the GP data. The values are not listed, only their range. */
+	filled::dump(ind);
+
+	// The array.
+	std::string pad2(ind + CAT_DUMP_PADDING, ' ');
+	std::string pad3(ind + 2 * CAT_DUMP_PADDING, ' ');
+	std::cout << pad2 << "array specific\n";
+	std::cout << pad3 << "Grid: " << _cols << " x " << _rows << "\n";
+	std::cout << pad3 << "Cell: " << _colSize << " x " << _rowSize
+						<< " x " << _height << "\n";
+	std::cout << pad3 << "Range: [" << _min << ", " << _max << "]\n";
+}
+
+//______________________________________________________________________________
+bool array::stream(std::stringstream& o, const bool& read)
+{
+	/*! Streams the primitive. The values are streamed as a single block. */
+
+	// Streams the parent.
+	if (filled::stream(o, read)) return true;
+
+	// Streams the geometry.
+	af::stream::rw(o, _cols, read);
+	af::stream::rw(o, _rows, read);
+	af::stream::rw(o, _colSize, read);
+	af::stream::rw(o, _rowSize, read);
+	af::stream::rw(o, _height, read);
+	af::stream::rw(o, _min, read);
+	af::stream::rw(o, _max, read);
+	af::stream::rw(o, _tileVersion, read);
+
+	// Streams the payload in one shot.
+	const size_t bytes = (size_t)_cols * _rows * sizeof(float);
+	if (read) {
+		_data.resize((size_t)_cols * _rows);
+		o.read((char*)_data.data(), bytes);
+		dirty(0, 0, _cols, _rows);
+		modeNeedRedraw(true);
+	} else {
+		o.write((const char*)_data.data(), bytes);
+	}
+
+	// Everything fine.
+	return false;
+}
+
+
+// *****************************************************************************
+// **					    GP data access public members					  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+uint32_t array::cols() const
+{
+	/*! Returns the columns count. */
+	return _cols;
+}
+
+//______________________________________________________________________________
+uint32_t array::rows() const
+{
+	/*! Returns the rows count. */
+	return _rows;
+}
+
+//______________________________________________________________________________
+float array::value(const uint32_t& col, const uint32_t& row) const
+{
+	/*! Returns the value of the cell (\c col, \c row). Returns 0 in case of
+		OOB call. */
+	if (col < _cols && row < _rows) return _data[(size_t)row * _cols + col];
+	else return 0;
+}
+
+//______________________________________________________________________________
+const float* array::data() const
+{
+	/*! Returns the whole payload, row-major. */
+	return _data.data();
+}
+
+//______________________________________________________________________________
+float array::min() const
+{
+	/*! Returns the lowest value. */
+	return _min;
+}
+
+//______________________________________________________________________________
+float array::max() const
+{
+	/*! Returns the highest value. */
+	return _max;
+}
+
+//______________________________________________________________________________
+uint64_t array::tileVersion() const
+{
+	/*! Returns the tiles version, i.e. how many tile changes the array went
+	 *	through since its creation.
+	 */
+	return _tileVersion;
+}
+
+//______________________________________________________________________________
+bool array::tile(const uint32_t& x, const uint32_t& y, const uint32_t& w,
+				 const uint32_t& h, const double* data)
+{
+	/*! Replaces the values of the tile starting at cell (\c x, \c y) and
+	 *	spanning \c w columns and \c h rows with \c data, arranged by rows
+	 *	as in the ctor. Returns true (and changes nothing) if the tile falls outside the grid.
+	 */
+	if (!inside(x, y, w, h)) return true;
+
+	// Patch the payload with the tile values.
+	const std::vector<float> tile(data, data + (size_t)w * h);
+	patch(x, y, w, h, tile.data());
+	_tileVersion++;
+
+	// Everything fine.
+	return false;
+}
+
+//______________________________________________________________________________
+bool array::rows(const uint32_t& first, const uint32_t& count, const double* data)
+{
+	/*! Replaces \c count rows starting from row \c first with the values in
+	 *	\c data. Just a full width tile.
+	 */
+	return tile(0, first, _cols, count, data);
+}
+
+//______________________________________________________________________________
+bool array::tileStream(std::stringstream& o, const uint32_t& x, const uint32_t& y,
+					   const uint32_t& w, const uint32_t& h) const
+{
+	/*! Writes into \c o the record for the (\c x, \c y, \c w, \c h) tile,
+	 *	with its current values and the current tiles version: the header
+	 *	followed by the w x h values, row by row. Returns true if the tile
+	 *	falls outside the grid.
+	 */
+	if (!inside(x, y, w, h)) return true;
+
+	// Header.
+	af::stream::write(o, _tileVersion);
+	af::stream::write(o, x);
+	af::stream::write(o, y);
+	af::stream::write(o, w);
+	af::stream::write(o, h);
+
+	// Values, one block per row.
+	for (uint32_t r = y; r < y + h; r++) {
+		o.write((const char*)(_data.data() + (size_t)r * _cols + x), w * sizeof(float));
+	}
+
+	// Everything fine.
+	return false;
+}
+
+//______________________________________________________________________________
+bool array::tileLoad(std::stringstream& o)
+{
+	/*! Reads a tile record written by tileStream and patches the payload in
+	 *	place. Records not newer than the current tiles version are stale (the
+	 *	full array or a later tile already carried them) and are skipped.
+	 *	Returns true if the record does not fit the grid or is truncated: in
+	 *	both cases the payload is left untouched.
+	 */
+	uint64_t version = 0;
+	uint32_t x = 0, y = 0, w = 0, h = 0;
+	af::stream::read(o, version);
+	if (!o) return true;
+	af::stream::read(o, x);
+	if (!o) return true;
+	af::stream::read(o, y);
+	if (!o) return true;
+	af::stream::read(o, w);
+	if (!o) return true;
+	af::stream::read(o, h);
+	if (!o) return true;
+	if (!inside(x, y, w, h)) return true;
+
+	// Stale record, just skip its values.
+	if (version <= _tileVersion) {
+		o.seekg((std::streamoff)w * h * sizeof(float), std::ios_base::cur);
+		return !o;
+	}
+
+	// Read the whole tile aside first, so a truncated one changes nothing.
+	std::vector<float> tile((size_t)w * h);
+	o.read((char*)tile.data(), tile.size() * sizeof(float));
+	if (!o) return true;
+
+	// Patch in place.
+	patch(x, y, w, h, tile.data());
+	_tileVersion = version;
+
+	// Everything fine.
+	return false;
+}
+
+
+// *****************************************************************************
+// **							     SERVER SIDE							  **
+// *****************************************************************************
+
+// Drawing and UI function are available only on the SERVER side.
+#ifdef CAT_SERVER
+
+
+// *****************************************************************************
+// **							     gl Functions							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void array::glUpload()
+{
+	/*! Uploads the cells values into the array texture. The texture is built
+	 *	(and fully loaded) the first time, or when the grid size changes,
+	 *	afterwards just the region changed since the previous upload is sent
+	 *	to the GPU, picked straight out of the payload.
+	 */
+	if (!_glTex) glGenTextures(1, &_glTex);
+	glBindTexture(GL_TEXTURE_2D, _glTex);
+	if (_texCols != _cols || _texRows != _rows) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, _cols, _rows, 0, GL_RED, GL_FLOAT, _data.data());
+		_texCols = _cols;
+		_texRows = _rows;
+	} else if (_dirtyX0 < _dirtyX1 && _dirtyY0 < _dirtyY1) {
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, _cols);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, _dirtyX0, _dirtyY0,
+						_dirtyX1 - _dirtyX0, _dirtyY1 - _dirtyY0, GL_RED, GL_FLOAT,
+						_data.data() + (size_t)_dirtyY0 * _cols + _dirtyX0);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Nothing left to upload.
+	_dirtyX0 = _dirtyY0 = _dirtyX1 = _dirtyY1 = 0;
+}
+
+//______________________________________________________________________________
+void array::glDrawSel()
+{
+	/*! Draws the selection skeleton. The array is drawn by the batch, which
+	 *	gets the skeleton (the grid base outline) from glMesh() as long as the
+	 *	array is selected.
+	 */
+
+	// Common drawing properties are handled by the parent.
+	filled::glDrawSel();
+}
+
+//______________________________________________________________________________
+void array::glDraw()
+{
+	/*! Draws the array. The array is drawn by the batch (see glMesh()). */
+
+	// Common drawing properties are handled by the parent.
+	filled::glDraw();
+}
+
+//______________________________________________________________________________
+bool array::glMesh(mesh& m)
+{
+	/*!	Writes the array into the batch mesh \c m as a heightfield: the cells
+	 *	are drawn by the batch out of the values texture, of which just the
+	 *	changed region is uploaded here, so the mesh gets only the grid
+	 *	placement and the values range: a tile costs its own values only. A selected
+	 *	array gets its base outline in the stroke, drawn even if invisible.
+	 */
+
+	// Selection skeleton.
+	const float cx = _cols * _colSize, cy = _rows * _rowSize;
+	if (modeSelected()) {
+		const std::vector<ge::point> base = { ge::point(0, 0, 0), ge::point(cx, 0, 0),
+											  ge::point(cx, cy, 0), ge::point(0, cy, 0) };
+		m.strip(base, true, _selColor);
+	}
+
+	// If not visible, nothing else to write.
+	if (!modeVisible() || _data.empty() || !_fillEnable) return true;
+
+	// The cells.
+	glUpload();
+	const double ax[9] = { _colSize, 0, 0, 0, _rowSize, 0, 0, 0, _height };
+	m.heightfield(_glTex, _cols, _rows, ax, _min, _max > _min ? _max - _min : 1, _fillColor);
+	return true;
+}
+
+//______________________________________________________________________________
+void array::glDrawEnd()
+{
+	/*! Closes the GP drawing. */
+	filled::glDrawEnd();
+}
+
+// *****************************************************************************
+// **							     ui Functions							  **
+// *****************************************************************************
+
+
+// End of CAT_SERVER if
+#endif
+
+// #############################################################################
+}} // Close namespace
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+// CAT 2D Array Graphic Primitive class					 					  --
+// (C) Piero Giubilato 2011-2024, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpArray.h"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"c++"
+//______________________________________________________________________________
+
+// Overloading check
+#if !defined gpArray_H
+#define gpArray_H
+
+// STL.
+#include <vector>
+
+// Components
+#include "gpFilled.h"
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+/*! cat::gp::array represents a 2D array of values as a lego-style heightmap,
+ *	i.e. a grid of \c cols x \c rows cells lying on the XY plane, each one
+ *	raised along Z proportionally to its value.
+ *	Differently from building the lego out of boxes, the whole grid is a
+ *	single GP carrying its values as one contiguous payload: it is streamed
+ *	in one shot, uploaded as a single R32F texture and drawn by the scene
+ *	batch as a heightfield, with one instanced call for all the cells (the
+ *	batch mesh carries just the grid placement and the values range).
+ *	Rectangular tiles (or whole rows) can be replaced afterwards: a tile
+ *	record carries just the (x, y, w, h) region values plus a version number,
+ *	the receiving array patches its payload in place and uploads just the
+ *	region changed since the last drawing.
+ *	The grid origin is the (0, 0, 0) corner: to move it around, make it the
+ *	child of a frame.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+
+//______________________________________________________________________________
+class array: public filled
+{
+	private:
+
+		// Grid geometry.
+		uint32_t _cols;				// Columns count.
+		uint32_t _rows;				// Rows count.
+		float _colSize;				// Cell size along X.
+		float _rowSize;				// Cell size along Y.
+		float _height;				// Z size of the highest cell.
+
+		// The payload, row-major (cols inner), one value per cell.
+		std::vector<float> _data;
+		float _min;					// Lowest value.
+		float _max;					// Highest value.
+
+		// Tiles version, increased by every tile change.
+		uint64_t _tileVersion;
+
+		// Region changed since the last upload, [x0, x1) x [y0, y1). NOT streamed.
+		uint32_t _dirtyX0;
+		uint32_t _dirtyY0;
+		uint32_t _dirtyX1;
+		uint32_t _dirtyY1;
+
+		// Support.
+		bool inside(const uint32_t&, const uint32_t&, const uint32_t&, const uint32_t&) const;
+		void range();
+		void patch(const uint32_t&, const uint32_t&, const uint32_t&, const uint32_t&, const float*);
+		void dirty(const uint32_t&, const uint32_t&, const uint32_t&, const uint32_t&);
+
+	protected:
+
+	public:
+
+		// Special Members.
+		array(); //!< Default ctor.
+
+		//! Standard ctor, cols x rows values with the cells dimensions.
+		array(const double* data, const uint32_t& cols, const uint32_t& rows,
+			  const double& colSize = 0.1, const double& rowSize = 0.1,
+			  const double& height = 1);
+
+		~array(); //!< Dtor.
+
+		// Default access public members
+		CO::oType type() const;					//!< Returns GP type.
+		coVer_t version() const;				//!< Returns GP version.
+		std::string stem() const;				//!< Returns GP stem name.
+		size_t size(const bool& = false) const;	//!< Returns GP size in bytes.
+		void dump(const int& = 0) const;		//!< Dumps GP data.
+		bool stream(std::stringstream& o, const bool& read = false);
+
+		// Grid access.
+		uint32_t cols() const;					//!< Returns the columns count.
+		uint32_t rows() const;					//!< Returns the rows count.
+		float value(const uint32_t&, const uint32_t&) const;	//!< Returns a cell value.
+		const float* data() const;				//!< Returns the whole payload.
+		float min() const;						//!< Returns the lowest value.
+		float max() const;						//!< Returns the highest value.
+
+		// Partial updates.
+		uint64_t tileVersion() const;			//!< Returns the tiles version.
+		
+		//! Replaces the values of a (x, y, w, h) tile.
+		bool tile(const uint32_t& x, const uint32_t& y, const uint32_t& w, 
+				  const uint32_t& h, const double* data);
+		
+		//! Replaces a range of rows.
+		bool rows(const uint32_t& first, const uint32_t& count, const double* data);
+
+		//! Writes a (x, y, w, h) tile record to a stream.
+		bool tileStream(std::stringstream& o, const uint32_t& x, const uint32_t& y, 
+						const uint32_t& w, const uint32_t& h) const;
+		
+		//! Applies a tile record read from a stream.
+		bool tileLoad(std::stringstream& o);
+
+		// Drawing functions are ONLY defined for the SERVER side!
+		#ifdef CAT_SERVER
+			void glDraw();		//!< Draws the GP on the current GLContext.
+			void glDrawSel();	//!< Draws the GP in selection mode.
+			void glDrawEnd();	//!< Closes the GP drawing. Mandatory call!
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
+
+		private:
+			GLuint _glTex;		// Texture holding the cells values.
+			uint32_t _texCols;	// Texture columns.
+			uint32_t _texRows;	// Texture rows.
+			void glUpload();	// Uploads the changed region, if any.
+		#endif
+};
+
+// #############################################################################
+}} // Close namespace
+
+
+// *****************************************************************************
+// **					Global namespace public functions					  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+inline std::ostream& operator << (std::ostream& o, const cat::gp::array& obj)
+{
+	/*! Overloads standard output operator << for a generic cat::gp::array. */
+	obj.dump();
+	return o;
+}
+
+// Overloading check
+#endif
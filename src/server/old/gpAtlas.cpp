@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives glyph atlas										  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpAtlas.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application components.
+#include "gpAtlas.h"
+#include "acMain.h"
+#include "afFont.h"
+
+// Standard library.
+#include <algorithm>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+
+// *****************************************************************************
+// **								Special members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+atlas::atlas(const uint32_t& width, const uint32_t& limit)
+{
+	/*! atlas ctor, starts empty with a small map \c width pixels wide, which
+	 *	can grow up to \c limit pixels in height. No GL object is created until
+	 *	the first drawing.
+	 */
+	_width = width;
+	_limit = std::max(limit, 64u);
+	_height = 64;
+	_px.assign(_width * _height, 0);
+	_x = _y = _shelf = 0;
+	_lo = UINT32_MAX;
+	_hi = 0;
+	_gen = 0;
+	_tex = 0;
+	_texHeight = 0;
+}
+
+//______________________________________________________________________________
+atlas::~atlas()
+{
+	/*! Releases all allocated resources. The GL context the atlas has been
+	 *	drawn into MUST still be current.
+	 */
+	if (_tex) glDeleteTextures(1, &_tex);
+}
+
+
+// *****************************************************************************
+// **								Private members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+bool atlas::place(const uint32_t& w, const uint32_t& h, uint32_t& x, uint32_t& y)
+{
+	/* Finds room for a \c w x \c h glyph (plus one pixel of padding) on the
+	 * current shelf, or on a new one, doubling the map height if needed.
+	 * Growing moves the glyphs texture coordinates, so it starts a new
+	 * generation. Returns false if the map is full.
+	 */
+	if (w + 1 > _width || h + 1 > _limit) return false;
+	if (_x + w + 1 > _width) {
+		_y += _shelf;
+		_x = _shelf = 0;
+	}
+	while (_y + h + 1 > _height) {
+		if (_height >= _limit) return false;
+		const uint32_t height = std::min(_height * 2, _limit);
+		const float f = (float)_height / height;
+		for (auto& g : _glyph) {
+			g.second.uv[1] *= f;
+			g.second.uv[3] *= f;
+		}
+		_px.resize(_width * height, 0);
+		_height = height;
+		_gen++;
+	}
+	x = _x;
+	y = _y;
+	_x += w + 1;
+	_shelf = std::max(_shelf, h + 1);
+	return true;
+}
+
+
+// *****************************************************************************
+// **								Public members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+uint32_t atlas::face(const std::string& family, const std::string& style, const uint32_t& size)
+{
+	/*! Returns the id of the face (\c family, \c style, \c size in pixels),
+	 *	adding it if new. Faces are few, so a linear search is fine.
+	 */
+	for (size_t f = 0; f < _face.size(); f++) {
+		const fface& k = _face[f];
+		if (k.size == size && k.family == family && k.style == style) return (uint32_t)f;
+	}
+	fface k = { family, style, size, (float)size };
+	if (af::_font) {
+		af::_font->textFont(family, style, size, 0);
+		k.line = (float)af::_font->lineHeight();
+	}
+	_face.push_back(k);
+	return (uint32_t)_face.size() - 1;
+}
+
+//______________________________________________________________________________
+const atlas::glyph& atlas::get(const uint32_t& face, const uint32_t& code)
+{
+	/*! Returns the glyph \c code of the \c face, rendering and packing it the
+	 *	first time. If the map is full, all the glyphs are dropped first (see
+	 *	generation()). Glyphs which cannot be rendered are empty.
+	 */
+	const uint64_t key = (uint64_t)face << 32 | code;
+	auto it = _glyph.find(key);
+	if (it != _glyph.end()) return it->second;
+
+	// Render.
+	glyph g = { { 0, 0, 0, 0 }, 0, 0, 0, 0, 0 };
+	int32_t left = 0, top = 0;
+	uint32_t w = 0, h = 0;
+	bool ok = false;
+	if (face < _face.size() && af::_font) {
+		const fface& k = _face[face];
+		af::_font->textFont(k.family, k.style, k.size, 0);
+		ok = af::_font->glyphDraw(code, left, top, w, h, g.advance, _map);
+	}
+
+	// Pack, starting over if the map is full.
+	uint32_t x = 0, y = 0;
+	bool room = ok && w && h && place(w, h, x, y);
+	if (ok && w && h && !room) {
+		clear();
+		room = place(w, h, x, y);
+	}
+	if (room) {
+		for (uint32_t r = 0; r < h; r++) {
+			std::copy(_map.begin() + r * w, _map.begin() + (r + 1) * w, _px.begin() + (y + r) * _width + x);
+		}
+		_lo = std::min(_lo, y);
+		_hi = std::max(_hi, y + h);
+		g.uv[0] = (float)x / _width;
+		g.uv[1] = (float)y / _height;
+		g.uv[2] = (float)(x + w) / _width;
+		g.uv[3] = (float)(y + h) / _height;
+		g.left = (int16_t)left;
+		g.top = (int16_t)top;
+		g.width = (uint16_t)w;
+		g.height = (uint16_t)h;
+	}
+	return _glyph[key] = g;
+}
+
+//______________________________________________________________________________
+float atlas::lineHeight(const uint32_t& face) const
+{
+	/*! Returns the line height of the \c face (pixels). */
+	return face < _face.size() ? _face[face].line : 0;
+}
+
+//______________________________________________________________________________
+uint64_t atlas::generation() const
+{
+	/*! Returns the atlas generation: it changes whenever the cached glyphs
+	 *	are dropped or moved, so that text laid out with glyphs of a previous
+	 *	generation must be laid out again.
+	 */
+	return _gen;
+}
+
+//______________________________________________________________________________
+void atlas::clear()
+{
+	/*! Drops all the glyphs, keeping the map size and the face ids. */
+	_glyph.clear();
+	std::fill(_px.begin(), _px.end(), 0);
+	_x = _y = _shelf = 0;
+	_lo = 0;
+	_hi = _height;
+	_gen++;
+}
+
+//______________________________________________________________________________
+GLuint atlas::glTexture()
+{
+	/*! Returns the atlas texture (a single red channel), creating it or
+	 *	sending the rows changed since the last call.
+	 */
+	if (!_tex) {
+		glGenTextures(1, &_tex);
+		glBindTexture(GL_TEXTURE_2D, _tex);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		_texHeight = 0;
+	} else {
+		glBindTexture(GL_TEXTURE_2D, _tex);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if (_texHeight != _height) {
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, _width, _height, 0, GL_RED, GL_UNSIGNED_BYTE, _px.data());
+		_texHeight = _height;
+	} else if (_lo < _hi) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _lo, _width, _hi - _lo, GL_RED, GL_UNSIGNED_BYTE, _px.data() + _lo * _width);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	_lo = UINT32_MAX;
+	_hi = 0;
+	return _tex;
+}
+
+//______________________________________________________________________________
+uint32_t atlas::width() const
+{
+	/*! Returns the map width (pixels). */
+	return _width;
+}
+
+//______________________________________________________________________________
+uint32_t atlas::height() const
+{
+	/*! Returns the map height (pixels). */
+	return _height;
+}
+
+//______________________________________________________________________________
+size_t atlas::glyphs() const
+{
+	/*! Returns the number of cached glyphs. */
+	return _glyph.size();
+}
+
+// #############################################################################
+}} // Close namespace
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives glyph atlas										  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpAtlas.h"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"c++"
+//______________________________________________________________________________
+
+// Overloading check
+#if !defined gpAtlas_H
+#define gpAtlas_H
+
+// GLAD bindings.
+#include "glad.h"
+
+// Standard library.
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+//! Glyph atlas
+/*! A cat::gp::atlas caches the glyphs of the text GPs in a single texture:
+ *	every glyph is rendered once per (family, style, size) through the font
+ *	facility, when first asked for, and packed in shelves (rows of glyphs as
+ *	tall as the tallest one) of a one byte per pixel coverage map. The map
+ *	grows in height up to a limit; when it is full, all the glyphs are
+ *	dropped and the generation number moves on, so that the users of the
+ *	previous glyphs know they must lay out their text again. Only the rows
+ *	changed since the last drawing are sent to the GPU.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+class atlas
+{
+	public:
+
+		//! A cached glyph.
+		struct glyph {
+			float uv[4];						//!< Texture box (u0, v0 top, u1, v1 bottom).
+			int16_t left, top;					//!< Bitmap corner respect the pen (pixels, y up).
+			uint16_t width, height;				//!< Bitmap size (pixels).
+			float advance;						//!< Pen advance (pixels).
+		};
+
+		// Special members.
+		atlas(const uint32_t& width = 1024, const uint32_t& limit = 4096);	//!< Ctor, with the map width and height limit.
+		~atlas();								//!< Dtor, releases the GL texture.
+
+		// Glyphs.
+		uint32_t face(const std::string& family, const std::string& style, const uint32_t& size);	//!< Retrieves a face id.
+		const glyph& get(const uint32_t& face, const uint32_t& code);	//!< Retrieves (rendering it in case) a glyph.
+		float lineHeight(const uint32_t& face) const;	//!< Face line height (pixels).
+		uint64_t generation() const;			//!< Changes whenever the cached glyphs move.
+		void clear();							//!< Drops all the glyphs.
+
+		// Drawing.
+		GLuint glTexture();						//!< Uploads the changes, returns the texture.
+
+		// Statistics.
+		uint32_t width() const;					//!< Map width (pixels).
+		uint32_t height() const;				//!< Map height (pixels).
+		size_t glyphs() const;					//!< Number of cached glyphs.
+
+	private:
+
+		// A face: font family, style and size.
+		struct fface {
+			std::string family, style;			// Font.
+			uint32_t size;						// Size (pixels, 0 = default).
+			float line;							// Line height (pixels).
+		};
+
+		// Storage.
+		std::vector<fface> _face;				// The faces.
+		std::unordered_map<uint64_t, glyph> _glyph;	// Glyphs, by (face, code).
+		std::vector<uint8_t> _px;				// Coverage map, rows top first.
+		std::vector<uint8_t> _map;				// Rendering scratch.
+		uint32_t _width, _height, _limit;		// Map size and height limit.
+		uint32_t _x, _y, _shelf;				// Packing pen and shelf height.
+		uint32_t _lo, _hi;						// Rows to upload.
+		uint64_t _gen;							// Generation.
+
+		// Drawing.
+		GLuint _tex;							// GL texture.
+		uint32_t _texHeight;					// GL texture height.
+
+		// Support functions.
+		bool place(const uint32_t&, const uint32_t&, uint32_t&, uint32_t&);
+};
+
+// #############################################################################
+}} // Close namespace
+
+// Overloading check
+#endif
@@ -0,0 +1,2281 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives batched geometry									  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpBatch.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application components.
+#include "gpBatch.h"
+#include "gpArray.h"
+#include "gpFrame.h"
+#include "gpScene.h"
+
+// Standard library.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+
+// *****************************************************************************
+// **								Shaders									  **
+// *****************************************************************************
+
+// Vertex shader: scene coordinates to clip ones, normals to eye ones. When
+// instancing, the unit shape is transformed by the instance axes and moved to
+// the instance position; the dots are sized by the x axis length instead.
+// A heightfield instance is a grid cell, the unit cube moved to the cell and
+// raised by the scaled cell value.
+static const char* batchVtxShader =
+	"#version 150\n"
+	"uniform mat4 uMvp;\n"
+	"uniform mat4 uMv;\n"
+	"uniform int uInst;\n"
+	"uniform int uField;\n"
+	"uniform int uFCols;\n"
+	"uniform vec2 uFScale;\n"
+	"uniform vec3 uFPos;\n"
+	"uniform mat3 uFAx;\n"
+	"uniform vec4 uFCol;\n"
+	"uniform sampler2D uValues;\n"
+	"in vec3 aPos;\n"
+	"in vec3 aNrm;\n"
+	"in vec4 aCol;\n"
+	"in vec3 aIPos;\n"
+	"in vec3 aIX;\n"
+	"in vec3 aIY;\n"
+	"in vec3 aIZ;\n"
+	"in vec4 aICol;\n"
+	"out vec4 vCol;\n"
+	"out vec3 vNrm;\n"
+	"void main() {\n"
+	"	vec3 p = aPos;\n"
+	"	vec3 n = aNrm;\n"
+	"	vCol = aCol;\n"
+	"	gl_PointSize = 1.0;\n"
+	"	if (uInst != 0) {\n"
+	"		mat3 m = mat3(aIX, aIY, aIZ);\n"
+	"		p = aIPos + m * aPos;\n"
+	"		if (abs(determinant(m)) > 1e-30) n = transpose(inverse(m)) * aNrm;\n"
+	"		vCol = aICol;\n"
+	"		gl_PointSize = aIX.x;\n"
+	"	} else if (uField != 0) {\n"
+	"		ivec2 c = ivec2(gl_InstanceID % uFCols, gl_InstanceID / uFCols);\n"
+	"		float z = clamp((texelFetch(uValues, c, 0).r - uFScale.x) / uFScale.y, 0.0, 1.0);\n"
+	"		p = uFPos + uFAx * vec3(vec2(c) + aPos.xy + 0.5, (aPos.z + 0.5) * z);\n"
+	"		if (abs(determinant(uFAx)) > 1e-30) n = transpose(inverse(uFAx)) * aNrm;\n"
+	"		vCol = uFCol;\n"
+	"	}\n"
+	"	vNrm = mat3(uMv) * n;\n"
+	"	gl_Position = uMvp * vec4(p, 1.0);\n"
+	"}\n";
+
+// Fragment shader: a headlight for the fill part, plain color for the stroke.
+static const char* batchFrgShader =
+	"#version 150\n"
+	"uniform int uLit;\n"
+	"in vec4 vCol;\n"
+	"in vec3 vNrm;\n"
+	"out vec4 oCol;\n"
+	"void main() {\n"
+	"	float d = 1.0;\n"
+	"	if (uLit != 0) d = 0.3 + 0.7 * abs(normalize(vNrm).z);\n"
+	"	oCol = vec4(vCol.rgb * d, vCol.a);\n"
+	"}\n";
+
+// Text vertex shader: the anchor is projected (or taken as is, if already in
+// viewport pixels), snapped to the pixel grid, and moved by the glyph vertex
+// offset, so that the text keeps its pixel size whatever the zoom. Anchors
+// behind the eye are moved out of the clip volume.
+static const char* textVtxShader =
+	"#version 150\n"
+	"uniform mat4 uMvp;\n"
+	"uniform vec2 uView;\n"
+	"in vec4 aPos;\n"
+	"in vec2 aOff;\n"
+	"in vec2 aUv;\n"
+	"in vec4 aCol;\n"
+	"out vec2 vUv;\n"
+	"out vec4 vCol;\n"
+	"void main() {\n"
+	"	vec4 c = vec4(2.0 * aPos.xy / uView - 1.0, -1.0, 1.0);\n"
+	"	if (aPos.w != 0.0) c = uMvp * vec4(aPos.xyz, 1.0);\n"
+	"	vUv = aUv;\n"
+	"	vCol = aCol;\n"
+	"	if (c.w <= 0.0) {\n"
+	"		gl_Position = vec4(0.0, 0.0, 2.0, 1.0);\n"
+	"		return;\n"
+	"	}\n"
+	"	vec3 n = c.xyz / c.w;\n"
+	"	vec2 p = floor((n.xy * 0.5 + 0.5) * uView + 0.5) + aOff;\n"
+	"	gl_Position = vec4(2.0 * p / uView - 1.0, n.z, 1.0);\n"
+	"}\n";
+
+// Text fragment shader: the atlas coverage modulates the glyph alpha.
+static const char* textFrgShader =
+	"#version 150\n"
+	"uniform sampler2D uAtlas;\n"
+	"in vec2 vUv;\n"
+	"in vec4 vCol;\n"
+	"out vec4 oCol;\n"
+	"void main() {\n"
+	"	float a = texture(uAtlas, vUv).r * vCol.a;\n"
+	"	if (a <= 0.0) discard;\n"
+	"	oCol = vec4(vCol.rgb, a);\n"
+	"}\n";
+
+
+// *****************************************************************************
+// **							mesh Special members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+mesh::mesh()
+{
+	/*! mesh ctor, starts empty. */
+	font = 0;
+	clear();
+}
+
+//______________________________________________________________________________
+mesh::~mesh()
+{
+	/*! Releases all allocated resources. */
+}
+
+
+// *****************************************************************************
+// **							mesh Public members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void mesh::clear(GP* gp)
+{
+	/*! Empties the mesh, keeping the allocated memory, to write the geometry
+	 *	of \c gp. The GP family transformations are applied to every written
+	 *	vertex.
+	 */
+	for (uint32_t p = 0; p < kPart::count; p++) {
+		vtx[p].clear();
+		idx[p].clear();
+		alpha[p] = false;
+	}
+	material = 0;
+	shape = kShape::none;
+	slices = stacks = 0;
+	param[0] = param[1] = param[2] = param[3] = 0;
+	grid.tex = 0;
+	text.clear();
+	level = 0;
+	detailed = false;
+	_gp = gp;
+}
+
+//______________________________________________________________________________
+bool mesh::empty() const
+{
+	/*! Returns true if no geometry has been written. */
+	return vtx[kPart::fill].empty() && vtx[kPart::stroke].empty() && text.empty() && !grid.tex;
+}
+
+//______________________________________________________________________________
+uint32_t mesh::vertexAdd(const kPart& part, const ge::point& p, const float* nrm, const float* col)
+{
+	/*! Adds a vertex to the \c part, returning its index. \c p is in the GP
+	 *	coordinates, \c nrm already in the scene ones.
+	 */
+	ge::point w(p);
+	if (_gp) _gp->glWorld(w);
+	vertex v;
+	v.pos[0] = (float)w.x(); v.pos[1] = (float)w.y(); v.pos[2] = (float)w.z();
+	v.nrm[0] = nrm[0]; v.nrm[1] = nrm[1]; v.nrm[2] = nrm[2];
+	v.rgba = rgba(col);
+	if (col[3] < 1) alpha[part] = true;
+	vtx[part].push_back(v);
+	return (uint32_t)vtx[part].size() - 1;
+}
+
+//______________________________________________________________________________
+void mesh::triangle(const ge::point& a, const ge::point& b, const ge::point& c, const float* col)
+{
+	/*! Adds the (counterclockwise) triangle \c a, \c b, \c c to the fill part.
+	 *	The flat normal is computed from the scene coordinates.
+	 */
+	ge::point w[3] = { a, b, c };
+	if (_gp) for (auto i = 0; i < 3; i++) _gp->glWorld(w[i]);
+	double u[3] = { w[1].x() - w[0].x(), w[1].y() - w[0].y(), w[1].z() - w[0].z() };
+	double v[3] = { w[2].x() - w[0].x(), w[2].y() - w[0].y(), w[2].z() - w[0].z() };
+	double n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+	double l = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	if (l > 0) for (auto i = 0; i < 3; i++) n[i] /= l;
+	const float nrm[3] = { (float)n[0], (float)n[1], (float)n[2] };
+
+	// Vertexes are already moved, so write them directly.
+	GP* gp = _gp;
+	_gp = 0;
+	for (auto i = 0; i < 3; i++) idx[kPart::fill].push_back(vertexAdd(kPart::fill, w[i], nrm, col));
+	_gp = gp;
+}
+
+//______________________________________________________________________________
+void mesh::quad(const ge::point& a, const ge::point& b, const ge::point& c, const ge::point& d, const float* col)
+{
+	/*! Adds the (counterclockwise, planar) quad \c a, \c b, \c c, \c d to the
+	 *	fill part, as two triangles.
+	 */
+	triangle(a, b, c, col);
+	triangle(a, c, d, col);
+}
+
+//______________________________________________________________________________
+void mesh::segment(const ge::point& a, const ge::point& b, const float* col)
+{
+	/*! Adds the segment \c a, \c b to the stroke part. */
+	static const float nrm[3] = { 0, 0, 1 };
+	idx[kPart::stroke].push_back(vertexAdd(kPart::stroke, a, nrm, col));
+	idx[kPart::stroke].push_back(vertexAdd(kPart::stroke, b, nrm, col));
+}
+
+//______________________________________________________________________________
+void mesh::strip(const std::vector<ge::point>& pts, const bool& closed, const float* col)
+{
+	/*! Adds the polyline \c pts to the stroke part, sharing the vertexes
+	 *	between consecutive segments. If \c closed, the last point is joined
+	 *	to the first one.
+	 */
+	if (pts.size() < 2) return;
+	static const float nrm[3] = { 0, 0, 1 };
+	uint32_t first = vertexAdd(kPart::stroke, pts[0], nrm, col);
+	uint32_t last = first;
+	for (size_t i = 1; i < pts.size(); i++) {
+		uint32_t cur = vertexAdd(kPart::stroke, pts[i], nrm, col);
+		idx[kPart::stroke].push_back(last);
+		idx[kPart::stroke].push_back(cur);
+		last = cur;
+	}
+	if (closed && pts.size() > 2) {
+		idx[kPart::stroke].push_back(last);
+		idx[kPart::stroke].push_back(first);
+	}
+}
+
+//______________________________________________________________________________
+void mesh::shaped(const kShape& shp, const ge::point& p, const double* ax, const float* col,
+				  const uint16_t& sl, const uint16_t& st, const float* par)
+{
+	/*! Writes the GP as an instance of the unit shape \c shp, centered in \c p
+	 *	and transformed by the x, y, z axes \c ax (9 values, GP coordinates).
+	 *	For a dot, ax[0] is the size in pixels. \c sl, \c st are the shape
+	 *	tessellation and \c par its 4 parameters (the tube radii, relative to
+	 *	the unit one), if any. A GP is one instance at most, and may write
+	 *	triangles and lines as well.
+	 */
+	ge::point w(p);
+	if (_gp) _gp->glWorld(w);
+	shape = shp;
+	slices = sl;
+	stacks = st;
+	for (auto i = 0; i < 4; i++) param[i] = par ? par[i] : 0;
+	inst.pos[0] = (float)w.x(); inst.pos[1] = (float)w.y(); inst.pos[2] = (float)w.z();
+
+	// Axes in the scene, as differences of moved points.
+	for (auto a = 0; a < 3; a++) {
+		if (shp == kShape::dot) {
+			for (auto c = 0; c < 3; c++) inst.ax[a * 3 + c] = (float)ax[a * 3 + c];
+			continue;
+		}
+		ge::point e(p.x() + ax[a * 3], p.y() + ax[a * 3 + 1], p.z() + ax[a * 3 + 2]);
+		if (_gp) _gp->glWorld(e);
+		inst.ax[a * 3] = (float)(e.x() - w.x());
+		inst.ax[a * 3 + 1] = (float)(e.y() - w.y());
+		inst.ax[a * 3 + 2] = (float)(e.z() - w.z());
+	}
+	inst.rgba = rgba(col);
+	alpha[kPart::fill] = col[3] < 1;
+}
+
+//______________________________________________________________________________
+void mesh::heightfield(const GLuint& tex, const uint32_t& cols, const uint32_t& rows, const double* ax,
+					   const float& lo, const float& span, const float* col)
+{
+	/*! Writes the GP as a heightfield of \c cols x \c rows cells, with its
+	 *	corner in the GP origin: \c ax are the cell x, y axes and the z axis
+	 *	of the highest cell (9 values, GP coordinates). The cell values are
+	 *	the texels of \c tex, an R32F texture, the value \c lo being flat and
+	 *	lo + \c span full height. A GP is one heightfield at most.
+	 */
+	ge::point w(0, 0, 0);
+	if (_gp) _gp->glWorld(w);
+	grid.tex = tex;
+	grid.cols = cols;
+	grid.rows = rows;
+	grid.lo = lo;
+	grid.span = span;
+	grid.frame.pos[0] = (float)w.x(); grid.frame.pos[1] = (float)w.y(); grid.frame.pos[2] = (float)w.z();
+	for (auto a = 0; a < 3; a++) {
+		ge::point e(ax[a * 3], ax[a * 3 + 1], ax[a * 3 + 2]);
+		if (_gp) _gp->glWorld(e);
+		grid.frame.ax[a * 3] = (float)(e.x() - w.x());
+		grid.frame.ax[a * 3 + 1] = (float)(e.y() - w.y());
+		grid.frame.ax[a * 3 + 2] = (float)(e.z() - w.z());
+	}
+	grid.frame.rgba = rgba(col);
+	grid.alpha = col[3] < 1;
+}
+
+//______________________________________________________________________________
+void mesh::glyph(const ge::point& at, const bool& screen, const float* xy, const float* uv, const uint32_t& rgba)
+{
+	/*! Adds a glyph quad anchored to \c at, a point in the GP coordinates or,
+	 *	if \c screen, in the viewport pixels. \c xy are the four corners offsets
+	 *	from the anchor (pixels, counterclockwise from the bottom left one),
+	 *	\c uv the glyph atlas box (see atlas::glyph) and \c rgba the packed
+	 *	color (see rgba()).
+	 */
+	ge::point w(at);
+	if (_gp && !screen) _gp->glWorld(w);
+	letter l;
+	l.pos[0] = (float)w.x(); l.pos[1] = (float)w.y(); l.pos[2] = (float)w.z();
+	l.pos[3] = screen ? 0.0f : 1.0f;
+	l.rgba = rgba;
+	const float cuv[4][2] = { { uv[0], uv[3] }, { uv[2], uv[3] }, { uv[2], uv[1] }, { uv[0], uv[1] } };
+	static const int tri[6] = { 0, 1, 2, 0, 2, 3 };
+	for (auto i = 0; i < 6; i++) {
+		const int c = tri[i];
+		l.off[0] = xy[2 * c];
+		l.off[1] = xy[2 * c + 1];
+		l.uv[0] = cuv[c][0];
+		l.uv[1] = cuv[c][1];
+		text.push_back(l);
+	}
+}
+
+//______________________________________________________________________________
+uint16_t mesh::lod(const uint16_t& n, const uint16_t& min)
+{
+	/*! Returns the tessellation to use instead of \c n (slices, stacks, ...)
+	 *	at the current detail level: halved at every level, but not below
+	 *	\c min. Calling it marks the GP as level dependent, so the batch will
+	 *	write it again when the level changes.
+	 */
+	detailed = true;
+	uint16_t l = n >> level;
+	if (l < min) l = min;
+	return l < n ? l : n;
+}
+
+//______________________________________________________________________________
+uint32_t mesh::rgba(const float* col)
+{
+	/*! Packs the \c col float color into 4 bytes, R first in memory. */
+	uint32_t c = 0;
+	for (auto i = 0; i < 4; i++) {
+		float f = col[i] < 0 ? 0 : (col[i] > 1 ? 1 : col[i]);
+		c |= (uint32_t)(f * 255.0f + 0.5f) << (8 * i);
+	}
+	return c;
+}
+
+
+// *****************************************************************************
+// **							tess Special members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+tess::tess(const size_t& budget)
+{
+	/*! tess ctor, with the memory \c budget (bytes) of the unreferenced
+	 *	meshes. No GL object is created until the first acquire().
+	 */
+	_budget = budget;
+	_bytes = 0;
+	_clock = 0;
+}
+
+//______________________________________________________________________________
+tess::~tess()
+{
+	/*! Releases all the GL buffers. The GL context the meshes have been
+	 *	built into MUST still be current.
+	 */
+	for (size_t e = 0; e < _entry.size(); e++) if (_entry[e].vbo) evict((int32_t)e);
+}
+
+
+// *****************************************************************************
+// **							tess Private members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void tess::build(const key& k, std::vector<vertex>& vtx, std::vector<uint32_t>& idx) const
+{
+	/* Tessellates the unit shape of \c k: a single vertex for dots, a cube
+	 * of side 1 and a sphere of radius 1 (both centered in the origin), a
+	 * tube along z from 0 to 1 with the radii of the key parameters.
+	 */
+	static const float white[4] = { 1, 1, 1, 1 };
+	static const double pi = 3.14159265358979;
+	vertex v;
+	v.rgba = mesh::rgba(white);
+	vtx.clear();
+	idx.clear();
+
+	// Dot.
+	if (k.shape == mesh::kShape::dot) {
+		v.pos[0] = v.pos[1] = v.pos[2] = 0;
+		v.nrm[0] = v.nrm[1] = 0; v.nrm[2] = 1;
+		vtx.push_back(v);
+		idx.push_back(0);
+
+	// Cube: four vertexes per face, for flat normals.
+	} else if (k.shape == mesh::kShape::cube) {
+		for (auto a = 0; a < 3; a++) {
+			for (auto sgn = -1; sgn <= 1; sgn += 2) {
+				const uint32_t b = (uint32_t)vtx.size();
+				const int u = (a + 1) % 3, w = (a + 2) % 3;
+				static const float uv[4][2] = { {-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f} };
+				for (auto c = 0; c < 4; c++) {
+					v.pos[a] = 0.5f * sgn;
+					v.pos[u] = uv[c][0];
+					v.pos[w] = uv[c][1] * sgn;
+					v.nrm[a] = (float)sgn; v.nrm[u] = 0; v.nrm[w] = 0;
+					vtx.push_back(v);
+				}
+				const uint32_t q[6] = { 0, 1, 2, 0, 2, 3 };
+				for (auto c = 0; c < 6; c++) idx.push_back(b + q[c]);
+			}
+		}
+
+	// Sphere: stacks x slices grid, smooth normals.
+	} else if (k.shape == mesh::kShape::ball) {
+		const int sl = k.slices < 3 ? 3 : k.slices;
+		const int st = k.stacks < 2 ? 2 : k.stacks;
+		for (auto i = 0; i <= st; i++) {
+			const double th = pi * i / st;
+			for (auto j = 0; j <= sl; j++) {
+				const double ph = 2 * pi * j / sl;
+				v.nrm[0] = (float)(std::sin(th) * std::cos(ph));
+				v.nrm[1] = (float)(std::sin(th) * std::sin(ph));
+				v.nrm[2] = (float)std::cos(th);
+				for (auto c = 0; c < 3; c++) v.pos[c] = v.nrm[c];
+				vtx.push_back(v);
+			}
+		}
+		for (auto i = 0; i < st; i++) {
+			for (auto j = 0; j < sl; j++) {
+				const uint32_t a = i * (sl + 1) + j, b = a + sl + 1;
+				idx.push_back(a); idx.push_back(b); idx.push_back(a + 1);
+				idx.push_back(a + 1); idx.push_back(b); idx.push_back(b + 1);
+			}
+		}
+
+	// Tube: outer (and inner) slices x stacks grids with smooth normals,
+	// then the base and top rings, or disks if not hollow.
+	} else if (k.shape == mesh::kShape::pipe) {
+		const int sl = k.slices < 3 ? 3 : k.slices;
+		const int st = k.stacks < 1 ? 1 : k.stacks;
+		const double riB = k.param[0] / 10000.0, roB = k.param[1] / 10000.0;
+		const double riT = k.param[2] / 10000.0, roT = k.param[3] / 10000.0;
+		const bool hollow = riB > 0 || riT > 0;
+		auto grid = [&](const double& rb, const double& rt, const float& sgn) {
+			const uint32_t b = (uint32_t)vtx.size();
+			const double l = std::sqrt(1 + (rb - rt) * (rb - rt));
+			for (auto j = 0; j <= st; j++) {
+				const double f = (double)j / st, r = rb + (rt - rb) * f;
+				for (auto i = 0; i <= sl; i++) {
+					const double a = 2 * pi * i / sl;
+					v.pos[0] = (float)(r * std::cos(a)); v.pos[1] = (float)(r * std::sin(a)); v.pos[2] = (float)f;
+					v.nrm[0] = sgn * (float)(std::cos(a) / l);
+					v.nrm[1] = sgn * (float)(std::sin(a) / l);
+					v.nrm[2] = sgn * (float)((rb - rt) / l);
+					vtx.push_back(v);
+				}
+			}
+			for (auto j = 0; j < st; j++) {
+				for (auto i = 0; i < sl; i++) {
+					const uint32_t a = b + j * (sl + 1) + i, c = a + sl + 1;
+					if (sgn > 0) {
+						idx.push_back(a); idx.push_back(a + 1); idx.push_back(c + 1);
+						idx.push_back(a); idx.push_back(c + 1); idx.push_back(c);
+					} else {
+						idx.push_back(a); idx.push_back(c + 1); idx.push_back(a + 1);
+						idx.push_back(a); idx.push_back(c); idx.push_back(c + 1);
+					}
+				}
+			}
+		};
+		auto cap = [&](const double& ri, const double& ro, const float& z) {
+			const uint32_t b = (uint32_t)vtx.size();
+			v.nrm[0] = v.nrm[1] = 0; v.nrm[2] = z > 0 ? 1.0f : -1.0f;
+			v.pos[2] = z;
+			for (auto i = 0; i <= sl; i++) {
+				const double a = 2 * pi * i / sl;
+				for (auto r = 0; r < 2; r++) {
+					const double rr = r ? ro : ri;
+					v.pos[0] = (float)(rr * std::cos(a)); v.pos[1] = (float)(rr * std::sin(a));
+					vtx.push_back(v);
+				}
+			}
+			for (auto i = 0; i < sl; i++) {
+				const uint32_t in0 = b + 2 * i, out0 = in0 + 1, in1 = in0 + 2, out1 = in0 + 3;
+				if (z > 0) {
+					idx.push_back(in0); idx.push_back(out0); idx.push_back(out1);
+					idx.push_back(in0); idx.push_back(out1); idx.push_back(in1);
+				} else {
+					idx.push_back(in0); idx.push_back(out1); idx.push_back(out0);
+					idx.push_back(in0); idx.push_back(in1); idx.push_back(out1);
+				}
+			}
+		};
+		grid(roB, roT, 1);
+		if (hollow) grid(riB, riT, -1);
+		cap(riB, roB, 0);
+		cap(riT, roT, 1);
+	}
+}
+
+//______________________________________________________________________________
+void tess::evict(const int32_t& e)
+{
+	/* Deletes the mesh \c e and frees its entry. */
+	entry& k = _entry[e];
+	glDeleteBuffers(1, &k.vbo);
+	glDeleteBuffers(1, &k.ibo);
+	_bytes -= k.bytes;
+	_index.erase(k.k);
+	k.vbo = k.ibo = 0;
+	k.count = 0;
+	k.bytes = 0;
+	k.refs = 0;
+	_free.push_back(e);
+}
+
+//______________________________________________________________________________
+void tess::trim()
+{
+	/* Evicts the least recently used unreferenced meshes while the cache is
+	 * over its budget. The referenced ones are never evicted.
+	 */
+	while (_bytes > _budget) {
+		int32_t lru = -1;
+		for (size_t e = 0; e < _entry.size(); e++) {
+			const entry& k = _entry[e];
+			if (!k.vbo || k.refs) continue;
+			if (lru < 0 || k.stamp < _entry[lru].stamp) lru = (int32_t)e;
+		}
+		if (lru < 0) return;
+		evict(lru);
+	}
+}
+
+
+// *****************************************************************************
+// **							tess Public members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+bool tess::key::operator<(const key& k) const
+{
+	/*! Lexicographic ordering, for the cache index. */
+	if (shape != k.shape) return shape < k.shape;
+	if (slices != k.slices) return slices < k.slices;
+	if (stacks != k.stacks) return stacks < k.stacks;
+	for (auto i = 0; i < 4; i++) if (param[i] != k.param[i]) return param[i] < k.param[i];
+	return false;
+}
+
+//______________________________________________________________________________
+bool tess::key::operator==(const key& k) const
+{
+	/*! Same shape, tessellation and parameters. */
+	return !(*this < k) && !(k < *this);
+}
+
+//______________________________________________________________________________
+tess::key tess::make(const uint32_t& shape, const uint16_t& slices, const uint16_t& stacks, const float* param)
+{
+	/*! Returns the canonical key of a unit shape: the values the shape does
+	 *	not use are zeroed and the parameters quantized, so that equivalent
+	 *	requests share the same mesh.
+	 */
+	key k;
+	k.shape = shape;
+	const bool grid = shape == mesh::kShape::ball || shape == mesh::kShape::pipe;
+	k.slices = grid ? slices : 0;
+	k.stacks = grid ? stacks : 0;
+	for (auto i = 0; i < 4; i++) {
+		k.param[i] = shape == mesh::kShape::pipe && param ? (int32_t)std::lround(param[i] * 10000.0) : 0;
+	}
+	return k;
+}
+
+//______________________________________________________________________________
+void tess::extent(const uint32_t& shape, float* lo, float* hi)
+{
+	/*! Copies into \c lo, \c hi the bounds of the unit \c shape. */
+	for (auto a = 0; a < 3; a++) {
+		lo[a] = shape == mesh::kShape::cube ? -0.5f : (shape == mesh::kShape::dot ? 0.0f : -1.0f);
+		hi[a] = -lo[a];
+	}
+	if (shape == mesh::kShape::pipe) {
+		lo[2] = 0;
+		hi[2] = 1;
+	}
+}
+
+//______________________________________________________________________________
+int32_t tess::acquire(const key& k)
+{
+	/*! Returns the handle of the mesh for \c k, tessellating and uploading it
+	 *	if it is not cached. Every acquire() must be paired by a release().
+	 */
+	int32_t e = -1;
+	auto it = _index.find(k);
+	if (it != _index.end()) {
+		e = it->second;
+	} else {
+		std::vector<vertex> vtx;
+		std::vector<uint32_t> idx;
+		build(k, vtx, idx);
+		if (_free.empty()) {
+			_entry.push_back(entry());
+			e = (int32_t)_entry.size() - 1;
+		} else {
+			e = _free.back();
+			_free.pop_back();
+		}
+		entry& n = _entry[e];
+		n.k = k;
+		n.refs = 0;
+		n.count = (GLsizei)idx.size();
+		n.bytes = vtx.size() * sizeof(vertex) + idx.size() * sizeof(uint32_t);
+		glGenBuffers(1, &n.vbo);
+		glGenBuffers(1, &n.ibo);
+		glBindBuffer(GL_ARRAY_BUFFER, n.vbo);
+		glBufferData(GL_ARRAY_BUFFER, vtx.size() * sizeof(vertex), vtx.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, n.ibo);
+		glBufferData(GL_COPY_WRITE_BUFFER, idx.size() * sizeof(uint32_t), idx.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		_bytes += n.bytes;
+		_index[k] = e;
+	}
+	_entry[e].refs++;
+	_entry[e].stamp = ++_clock;
+	trim();
+	return e;
+}
+
+//______________________________________________________________________________
+void tess::release(const int32_t& e)
+{
+	/*! Releases the mesh \c e. Unreferenced, it stays cached until evicted. */
+	if (e < 0 || e >= (int32_t)_entry.size() || !_entry[e].refs) return;
+	_entry[e].refs--;
+	_entry[e].stamp = ++_clock;
+	trim();
+}
+
+//______________________________________________________________________________
+GLuint tess::vbo(const int32_t& e) const
+{
+	/*! Returns the vertex buffer of the mesh \c e. */
+	return _entry[e].vbo;
+}
+
+//______________________________________________________________________________
+GLuint tess::ibo(const int32_t& e) const
+{
+	/*! Returns the index buffer of the mesh \c e. */
+	return _entry[e].ibo;
+}
+
+//______________________________________________________________________________
+GLsizei tess::count(const int32_t& e) const
+{
+	/*! Returns the index count of the mesh \c e. */
+	return _entry[e].count;
+}
+
+//______________________________________________________________________________
+void tess::clear()
+{
+	/*! Evicts all the unreferenced meshes. */
+	for (size_t e = 0; e < _entry.size(); e++) {
+		if (_entry[e].vbo && !_entry[e].refs) evict((int32_t)e);
+	}
+}
+
+//______________________________________________________________________________
+size_t tess::budget() const
+{
+	/*! Returns the memory budget (bytes) of the cache. */
+	return _budget;
+}
+
+//______________________________________________________________________________
+void tess::budget(const size_t& b)
+{
+	/*! Sets the memory budget (bytes) of the cache, evicting if needed. */
+	_budget = b;
+	trim();
+}
+
+//______________________________________________________________________________
+size_t tess::bytes() const
+{
+	/*! Returns the GL memory (bytes) used by the cached meshes. */
+	return _bytes;
+}
+
+//______________________________________________________________________________
+size_t tess::size() const
+{
+	/*! Returns the number of cached meshes, referenced or not. */
+	return _index.size();
+}
+
+
+// *****************************************************************************
+// **							batch Special members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+batch::batch()
+{
+	/*! batch ctor. No GL object is created until the first drawing, so the
+	 *	batch can be built before the GL context is current.
+	 */
+	_scene = 0;
+	_program = 0;
+	_uMvp = -1;
+	_uMv = -1;
+	_uLit = -1;
+	_uInst = -1;
+	_uField = _uFCols = _uFScale = _uFPos = _uFAx = _uFCol = _uValues = -1;
+	_fMesh = -1;
+	_fVao = 0;
+	_tProgram = 0;
+	_tMvp = -1;
+	_tView = -1;
+	_tAtlas = -1;
+	_tHoles = 0;
+	_tLo = SIZE_MAX;
+	_tHi = 0;
+	_tCap = 0;
+	_tVao = _tVbo = 0;
+	_tGen = 0;
+	_mesh.font = &_atlas;
+	_culled = false;
+	_dotMax = 0;
+	_glFailed = false;
+	_calls = 0;
+}
+
+//______________________________________________________________________________
+batch::~batch()
+{
+	/*! Releases all allocated resources. The GL context the batch has drawn
+	 *	into MUST still be current.
+	 */
+	clear();
+	if (_program) glDeleteProgram(_program);
+	if (_tProgram) glDeleteProgram(_tProgram);
+}
+
+
+// *****************************************************************************
+// **							batch Private members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int32_t batch::bucketGet(const GPHnd& material, const uint32_t& part, const bool& alpha)
+{
+	/* Returns the bucket for (material, part, alpha), creating it if needed.
+	 * The buckets are few, so a linear search is fine.
+	 */
+	for (size_t b = 0; b < _bucket.size(); b++) {
+		const bucket& k = _bucket[b];
+		if (k.material == material && k.part == part && k.alpha == alpha) return (int32_t)b;
+	}
+	bucket k;
+	k.material = material;
+	k.part = part;
+	k.alpha = alpha;
+	k.holes = 0;
+	k.vLo = k.iLo = SIZE_MAX;
+	k.vHi = k.iHi = 0;
+	k.repack = false;
+	k.vao = k.vbo = k.ibo = 0;
+	k.vCap = k.iCap = 0;
+	_bucket.push_back(k);
+	return (int32_t)_bucket.size() - 1;
+}
+
+//______________________________________________________________________________
+void batch::erase(slot& s, const uint32_t& part)
+{
+	/* Removes the \c part geometry of slot \c s from its bucket. The indexes
+	 * are collapsed on the first vertex (degenerate, so nothing is drawn) and
+	 * the vertexes left as a hole, to be reclaimed by the next packing.
+	 */
+	if (s.bucket[part] < 0) return;
+	bucket& k = _bucket[s.bucket[part]];
+	for (uint32_t i = s.i0[part]; i < s.i0[part] + s.in[part]; i++) k.idx[i] = s.v0[part];
+	if (s.in[part]) {
+		k.iLo = std::min<size_t>(k.iLo, s.i0[part]);
+		k.iHi = std::max<size_t>(k.iHi, s.i0[part] + s.in[part]);
+	}
+	k.holes += s.vn[part];
+	if (k.holes > k.vtx.size() - k.holes) k.repack = true;
+	s.bucket[part] = -1;
+	s.v0[part] = s.vn[part] = s.i0[part] = s.in[part] = 0;
+}
+
+//______________________________________________________________________________
+void batch::textErase(slot& s)
+{
+	/* Removes the glyphs of slot \c s. They are collapsed on their anchor (no
+	 * offsets, so nothing is drawn) and left as a hole, to be reclaimed by the
+	 * next packing.
+	 */
+	if (!s.tn) return;
+	for (uint32_t i = s.t0; i < s.t0 + s.tn; i++) _text[i].off[0] = _text[i].off[1] = 0;
+	_tLo = std::min<size_t>(_tLo, s.t0);
+	_tHi = std::max<size_t>(_tHi, s.t0 + s.tn);
+	_tHoles += s.tn;
+	s.t0 = s.tn = 0;
+}
+
+//______________________________________________________________________________
+void batch::textPack()
+{
+	/* Packs the glyphs dropping their holes, and moves the slots accordingly.
+	 * The whole glyph buffer will be uploaded again.
+	 */
+	std::vector<letter> text;
+	text.reserve(_text.size() - _tHoles);
+	for (auto& s : _slot) {
+		if (!s.tn) continue;
+		const uint32_t t0 = (uint32_t)text.size();
+		text.insert(text.end(), _text.begin() + s.t0, _text.begin() + s.t0 + s.tn);
+		s.t0 = t0;
+	}
+	_text.swap(text);
+	_tHoles = 0;
+	_tLo = 0;
+	_tHi = _text.size();
+}
+
+//______________________________________________________________________________
+void batch::textDraw(const float* mvp)
+{
+	/* Draws the glyphs of the visible GPs with a single call, through the
+	 * \c mvp projection * modelview matrix, after sending the changed glyphs
+	 * and atlas rows to the GPU.
+	 */
+	if (_tHoles > _text.size() - _tHoles) textPack();
+	if (_text.empty()) return;
+
+	// Creates the GL objects and the vertex layout.
+	if (!_tVao) {
+		glGenVertexArrays(1, &_tVao);
+		glGenBuffers(1, &_tVbo);
+		glBindVertexArray(_tVao);
+		glBindBuffer(GL_ARRAY_BUFFER, _tVbo);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(letter), (void*)offsetof(letter, pos));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(letter), (void*)offsetof(letter, off));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(letter), (void*)offsetof(letter, uv));
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(letter), (void*)offsetof(letter, rgba));
+	} else {
+		glBindVertexArray(_tVao);
+		glBindBuffer(GL_ARRAY_BUFFER, _tVbo);
+	}
+
+	// Glyphs.
+	if (_text.size() > _tCap) {
+		_tCap = _text.size() + _text.size() / 2;
+		glBufferData(GL_ARRAY_BUFFER, _tCap * sizeof(letter), 0, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, _text.size() * sizeof(letter), _text.data());
+	} else if (_tLo < _tHi) {
+		const size_t hi = std::min(_tHi, _text.size());
+		if (_tLo < hi) glBufferSubData(GL_ARRAY_BUFFER, _tLo * sizeof(letter), (hi - _tLo) * sizeof(letter), _text.data() + _tLo);
+	}
+	_tLo = SIZE_MAX;
+	_tHi = 0;
+
+	// If culling, the ranges of the visible GPs, the adjacent ones merged.
+	if (_culled) {
+		std::vector<std::pair<uint32_t, uint32_t>> run;
+		for (size_t h = 0; h < _slot.size(); h++) {
+			if (_slot[h].tn && visible(h)) run.push_back({ _slot[h].t0, _slot[h].tn });
+		}
+		std::sort(run.begin(), run.end());
+		_tFirst.clear();
+		_tCount.clear();
+		uint32_t end = UINT32_MAX;
+		for (auto& r : run) {
+			if (r.first == end) {
+				_tCount.back() += r.second;
+			} else {
+				_tFirst.push_back(r.first);
+				_tCount.push_back(r.second);
+			}
+			end = r.first + r.second;
+		}
+		if (_tFirst.empty()) return;
+	}
+
+	// One call, with the atlas texture.
+	GLint vp[4];
+	glGetIntegerv(GL_VIEWPORT, vp);
+	glUseProgram(_tProgram);
+	glUniformMatrix4fv(_tMvp, 1, GL_FALSE, mvp);
+	glUniform2f(_tView, (float)vp[2], (float)vp[3]);
+	glUniform1i(_tAtlas, 0);
+	glActiveTexture(GL_TEXTURE0);
+	_atlas.glTexture();
+	if (_culled) glMultiDrawArrays(GL_TRIANGLES, _tFirst.data(), _tCount.data(), (GLsizei)_tFirst.size());
+	else glDrawArrays(GL_TRIANGLES, 0, (GLsizei)_text.size());
+	glBindTexture(GL_TEXTURE_2D, 0);
+	_calls++;
+}
+
+//______________________________________________________________________________
+int32_t batch::groupGet(const mesh& m)
+{
+	/* Returns the instanced group matching the mesh \c m shape, creating it
+	 * if needed.
+	 */
+	const GPHnd material = m.shape == mesh::kShape::dot ? 0 : m.material;
+	const bool alpha = m.alpha[mesh::kPart::fill];
+	const tess::key key = tess::make(m.shape, m.slices, m.stacks, m.param);
+	for (size_t g = 0; g < _group.size(); g++) {
+		const group& k = _group[g];
+		if (k.key == key && k.material == material && k.alpha == alpha) return (int32_t)g;
+	}
+	group k;
+	k.key = key;
+	k.mesh = -1;
+	k.material = material;
+	k.alpha = alpha;
+	k.lo = SIZE_MAX;
+	k.hi = 0;
+	k.vao = k.ibuf = k.cbuf = 0;
+	k.stale = true;
+	k.count = 0;
+	k.cap = 0;
+	_group.push_back(k);
+	return (int32_t)_group.size() - 1;
+}
+
+//______________________________________________________________________________
+void batch::unlink(slot& s)
+{
+	/* Removes the slot \c s instance from its group. The last instance of
+	 * the group takes its place, so the group stays packed. An emptied group
+	 * gives its unit mesh back to the cache.
+	 */
+	if (s.group < 0) return;
+	group& k = _group[s.group];
+	const uint32_t i = s.inst;
+	const uint32_t last = (uint32_t)k.inst.size() - 1;
+	if (i != last) {
+		k.inst[i] = k.inst[last];
+		k.owner[i] = k.owner[last];
+		_slot[k.owner[i]].inst = i;
+		k.lo = std::min<size_t>(k.lo, i);
+		k.hi = std::max<size_t>(k.hi, i + 1);
+	}
+	k.inst.pop_back();
+	k.owner.pop_back();
+	if (k.inst.empty() && k.vao) {
+		glDeleteVertexArrays(1, &k.vao);
+		k.vao = 0;
+		_tess.release(k.mesh);
+		k.mesh = -1;
+	}
+	s.group = -1;
+	s.inst = 0;
+}
+
+//______________________________________________________________________________
+void batch::fieldErase(slot& s)
+{
+	/* Removes the slot \c s heightfield. The last heightfield takes its
+	 * place.
+	 */
+	if (s.field < 0) return;
+	const uint32_t i = (uint32_t)s.field;
+	const uint32_t last = (uint32_t)_field.size() - 1;
+	if (i != last) {
+		_field[i] = _field[last];
+		_fOwner[i] = _fOwner[last];
+		_slot[_fOwner[i]].field = (int32_t)i;
+	}
+	_field.pop_back();
+	_fOwner.pop_back();
+	s.field = -1;
+}
+
+//______________________________________________________________________________
+void batch::fieldDraw(const mesh::field& f)
+{
+	/* Draws the heightfield \c f with one instanced call, a unit cube per
+	 * cell, shared by all the heightfields through their vertex array.
+	 */
+	if (!_fVao) {
+		_fMesh = _tess.acquire(tess::make(mesh::kShape::cube, 0, 0, 0));
+		glGenVertexArrays(1, &_fVao);
+		glBindVertexArray(_fVao);
+		glBindBuffer(GL_ARRAY_BUFFER, _tess.vbo(_fMesh));
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _tess.ibo(_fMesh));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof(vertex, pos));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof(vertex, nrm));
+	}
+	const uint8_t* c = (const uint8_t*)&f.frame.rgba;
+	glBindVertexArray(_fVao);
+	glUniform1i(_uLit, 1);
+	glUniform1i(_uInst, 0);
+	glUniform1i(_uField, 1);
+	glUniform1i(_uFCols, (GLint)f.cols);
+	glUniform2f(_uFScale, f.lo, f.span);
+	glUniform3fv(_uFPos, 1, f.frame.pos);
+	glUniformMatrix3fv(_uFAx, 1, GL_FALSE, f.frame.ax);
+	glUniform4f(_uFCol, c[0] / 255.0f, c[1] / 255.0f, c[2] / 255.0f, c[3] / 255.0f);
+	glUniform1i(_uValues, 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, f.tex);
+	glDrawElementsInstanced(GL_TRIANGLES, _tess.count(_fMesh), GL_UNSIGNED_INT, 0, (GLsizei)(f.cols * f.rows));
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glUniform1i(_uField, 0);
+	_calls++;
+}
+
+//______________________________________________________________________________
+bool batch::fieldHit(const GPHnd& h, const mesh::field& f, const double* o, const double* d, double& t) const
+{
+	/* Tests the ray o + s * d against the cells of the heightfield \c f, of
+	 * the array GP \c h, walking the cells crossed by the ray in the grid
+	 * space. Returns true if a cell is hit at 0 <= s < \c t, setting \c t.
+	 */
+	const GP* gp = _scene ? _scene->gpGet(h) : 0;
+	if (!gp || gp->type() != CO::oType::gpArray) return false;
+	const array* a = static_cast<const array*>(gp);
+	if (a->cols() != f.cols || a->rows() != f.rows) return false;
+
+	// The ray in the grid space (cells, full height), through the inverse axes.
+	auto dot3 = [](const double* u, const double* v) { return u[0] * v[0] + u[1] * v[1] + u[2] * v[2]; };
+	auto cross = [](const double* u, const double* v, double* c) {
+		c[0] = u[1] * v[2] - u[2] * v[1];
+		c[1] = u[2] * v[0] - u[0] * v[2];
+		c[2] = u[0] * v[1] - u[1] * v[0];
+	};
+	const double X[3] = { f.frame.ax[0], f.frame.ax[1], f.frame.ax[2] };
+	const double Y[3] = { f.frame.ax[3], f.frame.ax[4], f.frame.ax[5] };
+	const double Z[3] = { f.frame.ax[6], f.frame.ax[7], f.frame.ax[8] };
+	double yz[3], zx[3], xy[3];
+	cross(Y, Z, yz);
+	cross(Z, X, zx);
+	cross(X, Y, xy);
+	const double det = dot3(X, yz);
+	if (std::fabs(det) < 1e-300) return false;
+	const double w[3] = { o[0] - f.frame.pos[0], o[1] - f.frame.pos[1], o[2] - f.frame.pos[2] };
+	const double uo[3] = { dot3(yz, w) / det, dot3(zx, w) / det, dot3(xy, w) / det };
+	const double ud[3] = { dot3(yz, d) / det, dot3(zx, d) / det, dot3(xy, d) / det };
+
+	// Clipped to the grid box.
+	const double hi[3] = { (double)f.cols, (double)f.rows, 1 };
+	double s0 = 0, s1 = t;
+	for (auto k = 0; k < 3; k++) {
+		if (ud[k] == 0) {
+			if (uo[k] < 0 || uo[k] > hi[k]) return false;
+			continue;
+		}
+		double ta = -uo[k] / ud[k], tb = (hi[k] - uo[k]) / ud[k];
+		if (ta > tb) std::swap(ta, tb);
+		s0 = std::max(s0, ta);
+		s1 = std::min(s1, tb);
+	}
+	if (s0 > s1) return false;
+
+	// Cell by cell, the ray against the cell box [0, z].
+	const int sx = ud[0] > 0 ? 1 : -1, sy = ud[1] > 0 ? 1 : -1;
+	int cx = std::min<int>((int)f.cols - 1, std::max(0, (int)std::floor(uo[0] + ud[0] * s0)));
+	int cy = std::min<int>((int)f.rows - 1, std::max(0, (int)std::floor(uo[1] + ud[1] * s0)));
+	double nx = ud[0] != 0 ? (cx + (sx > 0) - uo[0]) / ud[0] : 1e300;
+	double ny = ud[1] != 0 ? (cy + (sy > 0) - uo[1]) / ud[1] : 1e300;
+	const double dx = ud[0] != 0 ? std::fabs(1 / ud[0]) : 0, dy = ud[1] != 0 ? std::fabs(1 / ud[1]) : 0;
+	double s = s0;
+	while (s <= s1) {
+		const double e = std::min(std::min(nx, ny), s1);
+		const double z = std::min(1.0, std::max(0.0, (a->value(cx, cy) - f.lo) / (double)f.span));
+		const double z0 = uo[2] + ud[2] * s, z1 = uo[2] + ud[2] * e;
+		double at = -1;
+		if (z0 >= 0 && z0 <= z) at = s;
+		else if (z0 > z && z1 <= z) at = s + (z - z0) / ud[2];
+		else if (z0 < 0 && z1 >= 0) at = s - z0 / ud[2];
+		if (at >= 0 && at < t) {
+			t = at;
+			return true;
+		}
+		if (e >= s1) break;
+		if (nx < ny) {
+			cx += sx;
+			s = nx;
+			nx += dx;
+		} else {
+			cy += sy;
+			s = ny;
+			ny += dy;
+		}
+		if (cx < 0 || cy < 0 || cx >= (int)f.cols || cy >= (int)f.rows) break;
+	}
+	return false;
+}
+
+//______________________________________________________________________________
+void batch::unit(group& k)
+{
+	/* Binds the group \c k to its unit mesh, acquired from the shared cache,
+	 * in a new vertex array: the unit mesh is static, the instances are
+	 * per-instance attributes (divisor 1).
+	 */
+	k.mesh = _tess.acquire(k.key);
+	glGenVertexArrays(1, &k.vao);
+	if (!k.ibuf) glGenBuffers(1, &k.ibuf);
+	if (!k.cbuf) glGenBuffers(1, &k.cbuf);
+	glBindVertexArray(k.vao);
+	glBindBuffer(GL_ARRAY_BUFFER, _tess.vbo(k.mesh));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _tess.ibo(k.mesh));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof(vertex, pos));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof(vertex, nrm));
+	for (GLuint a = 3; a < 8; a++) {
+		glEnableVertexAttribArray(a);
+		glVertexAttribDivisor(a, 1);
+	}
+	instAttrib(k.ibuf);
+	k.count = _tess.count(k.mesh);
+	k.cap = 0;
+	k.lo = 0;
+	k.hi = k.inst.size();
+}
+
+//______________________________________________________________________________
+void batch::instAttrib(const GLuint& buf, const size_t& first)
+{
+	/* Points the per-instance attributes of the bound VAO to \c buf, from
+	 * its \c first instance on.
+	 */
+	const size_t o = first * sizeof(instance);
+	glBindBuffer(GL_ARRAY_BUFFER, buf);
+	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(instance), (void*)(o + offsetof(instance, pos)));
+	for (GLuint a = 0; a < 3; a++) {
+		glVertexAttribPointer(4 + a, 3, GL_FLOAT, GL_FALSE, sizeof(instance), (void*)(o + offsetof(instance, ax) + a * 3 * sizeof(float)));
+	}
+	glVertexAttribPointer(7, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(instance), (void*)(o + offsetof(instance, rgba)));
+}
+
+//______________________________________________________________________________
+void batch::instDraw(const group& k, const GLuint& buf, const uint32_t& first, const uint32_t& n)
+{
+	/* Draws \c n instances of the group \c k, from the \c first one of
+	 * \c buf, the instance buffer the bound VAO points to. The first
+	 * instance goes as base instance (GL 4.2), or else the attributes are
+	 * pointed to it for the call.
+	 */
+	const GLenum mode = k.key.shape == mesh::kShape::dot ? GL_POINTS : GL_TRIANGLES;
+	if (!first) {
+		glDrawElementsInstanced(mode, k.count, GL_UNSIGNED_INT, 0, n);
+	} else if (GLAD_GL_VERSION_4_2) {
+		glDrawElementsInstancedBaseInstance(mode, k.count, GL_UNSIGNED_INT, 0, n, first);
+	} else {
+		instAttrib(buf, first);
+		glDrawElementsInstanced(mode, k.count, GL_UNSIGNED_INT, 0, n);
+		instAttrib(buf);
+	}
+	_calls++;
+}
+
+//______________________________________________________________________________
+void batch::bound(const GPHnd& hnd)
+{
+	/* Sets the bvh bounds of the GP \c hnd from the mesh just written (the
+	 * text by its scene anchors only). GPs without batched geometry, or with
+	 * viewport text only, leave the bvh.
+	 */
+	float lo[3], hi[3];
+	bool any = false;
+	auto grow = [&](const float* p, const float* d) {
+		for (auto a = 0; a < 3; a++) {
+			lo[a] = any ? std::min(lo[a], p[a] - d[a]) : p[a] - d[a];
+			hi[a] = any ? std::max(hi[a], p[a] + d[a]) : p[a] + d[a];
+		}
+		any = true;
+	};
+	static const float zero[3] = { 0, 0, 0 };
+	if (_slot[hnd].batched) {
+		for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+			for (auto& v : _mesh.vtx[p]) grow(v.pos, zero);
+		}
+		for (auto& l : _mesh.text) if (l.pos[3] != 0) grow(l.pos, zero);
+		if (_mesh.grid.tex) {
+			const mesh::field& f = _mesh.grid;
+			for (auto c = 0; c < 8; c++) {
+				const float u[3] = { c & 1 ? (float)f.cols : 0, c & 2 ? (float)f.rows : 0, c & 4 ? 1.0f : 0 };
+				float w[3];
+				for (auto a = 0; a < 3; a++) w[a] = f.frame.pos[a] + f.frame.ax[a] * u[0] + f.frame.ax[3 + a] * u[1] + f.frame.ax[6 + a] * u[2];
+				grow(w, zero);
+			}
+		}
+		if (_mesh.shape == mesh::kShape::dot) {
+			grow(_mesh.inst.pos, zero);
+		} else if (_mesh.shape != mesh::kShape::none) {
+
+			// The unit shape bounds corners, transformed.
+			float ulo[3], uhi[3];
+			tess::extent(_mesh.shape, ulo, uhi);
+			const float* ax = _mesh.inst.ax;
+			for (auto c = 0; c < 8; c++) {
+				const float u[3] = { c & 1 ? uhi[0] : ulo[0], c & 2 ? uhi[1] : ulo[1], c & 4 ? uhi[2] : ulo[2] };
+				float w[3];
+				for (auto a = 0; a < 3; a++) w[a] = _mesh.inst.pos[a] + ax[a] * u[0] + ax[3 + a] * u[1] + ax[6 + a] * u[2];
+				grow(w, zero);
+			}
+		}
+	}
+	if (any) _bvh.set(hnd, lo, hi);
+	else _bvh.remove(hnd);
+}
+
+//______________________________________________________________________________
+void batch::runs()
+{
+	/* Collects, for every bucket, the index ranges of the visible GPs, the
+	 * adjacent ones merged, as glMultiDrawElements arguments.
+	 */
+	std::vector<std::vector<std::pair<uint32_t, uint32_t>>> run(_bucket.size());
+	for (size_t h = 0; h < _slot.size(); h++) {
+		const slot& s = _slot[h];
+		if (!visible(h)) continue;
+		for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+			if (s.bucket[p] >= 0 && s.in[p]) run[s.bucket[p]].push_back({ s.i0[p], s.in[p] });
+		}
+	}
+	for (size_t b = 0; b < _bucket.size(); b++) {
+		bucket& k = _bucket[b];
+		std::sort(run[b].begin(), run[b].end());
+		k.rc.clear();
+		k.ro.clear();
+		uint32_t end = UINT32_MAX;
+		for (auto& r : run[b]) {
+			if (r.first == end) {
+				k.rc.back() += r.second;
+			} else {
+				k.rc.push_back(r.second);
+				k.ro.push_back((const void*)(r.first * sizeof(uint32_t)));
+			}
+			end = r.first + r.second;
+		}
+	}
+}
+
+//______________________________________________________________________________
+void batch::sort(const float* mv)
+{
+	/* Sorts back to front all the visible transparent GPs, in one order: the
+	 * batched ones by the view distance of their bounds center (\c mv being
+	 * the column-major modelview), the ones left to glDisplay() by their
+	 * origin. The order is then cut in steps, a step being a run of GPs drawn
+	 * by the same bucket (their ranges, the adjacent ones merged), the same
+	 * group (their instances, in the group sorted buffer), or a heightfield
+	 * or a GP to glDisplay() on its own.
+	 */
+	auto dist = [&](const GPHnd& h) {
+		float lo[3], hi[3];
+		if (!_bvh.box(h, lo, hi)) return 0.0f;
+		const float c[3] = { (lo[0] + hi[0]) / 2, (lo[1] + hi[1]) / 2, (lo[2] + hi[2]) / 2 };
+		return -(mv[2] * c[0] + mv[6] * c[1] + mv[10] * c[2] + mv[14]);
+	};
+
+	// New frame.
+	_depth.begin();
+	for (size_t h = 1; h < _slot.size(); h++) {
+		const slot& s = _slot[h];
+		if (!s.batched || !visible(h)) continue;
+		bool any = (s.group >= 0 && _group[s.group].alpha) || (s.field >= 0 && _field[s.field].alpha);
+		for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+			if (s.bucket[p] >= 0 && s.in[p] && _bucket[s.bucket[p]].alpha) any = true;
+		}
+		if (any) _depth.set(h, dist(h));
+	}
+	const size_t n = _scene ? _scene->gpSize() : 0;
+	for (GPHnd h = 1; h < n; h++) {
+		GP* gp = _scene->gpGet(h);
+		if (!gp || batched(h) || !gp->glAlpha()) continue;
+		ge::point o(0, 0, 0);
+		gp->glWorld(o);
+		_depth.set(h, (float)-(mv[2] * o.x() + mv[6] * o.y() + mv[10] * o.z() + mv[14]));
+	}
+
+	// Steps.
+	_step.clear();
+	_rc.clear();
+	_ro.clear();
+	for (auto& k : _group) k.sorted.clear();
+	uint32_t end = UINT32_MAX;
+	for (auto h : _depth.end()) {
+		if (!batched(h)) {
+			_step.push_back({ -1, -1, h, 0, 0, -1 });
+			continue;
+		}
+		const slot& s = _slot[h];
+		for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+			const int32_t b = s.bucket[p];
+			if (b < 0 || !s.in[p] || !_bucket[b].alpha) continue;
+			if (_step.empty() || _step.back().bucket != b) {
+				_step.push_back({ b, -1, 0, (uint32_t)_rc.size(), 0, -1 });
+				end = UINT32_MAX;
+			}
+			if (s.i0[p] == end) {
+				_rc.back() += s.in[p];
+			} else {
+				_rc.push_back(s.in[p]);
+				_ro.push_back((const void*)(s.i0[p] * sizeof(uint32_t)));
+				_step.back().rn++;
+			}
+			end = s.i0[p] + s.in[p];
+		}
+		if (s.group >= 0 && _group[s.group].alpha) {
+			group& k = _group[s.group];
+			if (_step.empty() || _step.back().group != s.group) _step.push_back({ -1, s.group, 0, (uint32_t)k.sorted.size(), 0, -1 });
+			k.sorted.push_back(s.inst);
+			_step.back().rn++;
+		}
+		if (s.field >= 0 && _field[s.field].alpha) _step.push_back({ -1, -1, 0, 0, 0, s.field });
+	}
+}
+
+//______________________________________________________________________________
+void batch::stream(group& k, std::vector<uint32_t>& seq)
+{
+	/* Fills the visible instances buffer of \c k with the instances \c seq
+	 * (by index), only if they, or the instances, changed since the last
+	 * time. \c seq is swapped with the previous content.
+	 */
+	if (!k.stale && seq == k.seq) return;
+	_cinst.clear();
+	for (auto i : seq) _cinst.push_back(k.inst[i]);
+	glBindBuffer(GL_ARRAY_BUFFER, k.cbuf);
+	glBufferData(GL_ARRAY_BUFFER, _cinst.size() * sizeof(instance), _cinst.data(), GL_STREAM_DRAW);
+	k.seq.swap(seq);
+	k.stale = false;
+}
+
+//______________________________________________________________________________
+bool batch::hit(const GPHnd& h, const double* o, const double* d, const double* px, double& t) const
+{
+	/* Tests the ray o + s * d against the geometry of the GP \c h. Returns
+	 * true if it is hit at 0 <= s < \c t, setting \c t to the nearest hit.
+	 * Triangles and instanced solids are hit exactly, lines and dots within
+	 * some pixels, px[0] + (px[1] - px[0]) * s being the pixel size along
+	 * the ray.
+	 */
+	const slot& sl = _slot[h];
+	if (!sl.batched) return false;
+	bool got = false;
+	auto take = [&](const double& s) {
+		if (s >= 0 && s < t) {
+			t = s;
+			got = true;
+		}
+	};
+	auto pixel = [&](const double& s) { return px[0] + (px[1] - px[0]) * s; };
+	auto dot3 = [](const double* a, const double* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; };
+	auto cross = [](const double* a, const double* b, double* c) {
+		c[0] = a[1] * b[2] - a[2] * b[1];
+		c[1] = a[2] * b[0] - a[0] * b[2];
+		c[2] = a[0] * b[1] - a[1] * b[0];
+	};
+
+	// Triangles and lines in the buckets.
+	for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+		if (sl.bucket[p] < 0) continue;
+		const bucket& k = _bucket[sl.bucket[p]];
+		const size_t step = p == mesh::kPart::fill ? 3 : 2;
+		for (size_t i = sl.i0[p]; i + step <= sl.i0[p] + sl.in[p]; i += step) {
+			const float* a = k.vtx[k.idx[i]].pos;
+			const float* b = k.vtx[k.idx[i + 1]].pos;
+			const double e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			const double w[3] = { o[0] - a[0], o[1] - a[1], o[2] - a[2] };
+
+			// Triangle (Moller-Trumbore).
+			if (step == 3) {
+				const float* c = k.vtx[k.idx[i + 2]].pos;
+				const double e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+				double pv[3], qv[3];
+				cross(d, e2, pv);
+				const double det = dot3(e1, pv);
+				if (std::fabs(det) < 1e-300) continue;
+				const double u = dot3(w, pv) / det;
+				if (u < 0 || u > 1) continue;
+				cross(w, e1, qv);
+				const double v = dot3(d, qv) / det;
+				if (v < 0 || u + v > 1) continue;
+				take(dot3(e2, qv) / det);
+
+			// Segment, within 3 pixels.
+			} else {
+				const double A = dot3(d, d), B = dot3(d, e1), C = dot3(e1, e1);
+				const double D = dot3(d, w), E = dot3(e1, w);
+				const double den = A * C - B * B;
+				double u = den > 1e-12 * A * C ? (A * E - B * D) / den : 0;
+				u = u < 0 ? 0 : (u > 1 ? 1 : u);
+				double s = (u * B - D) / A;
+				if (s < 0) s = 0;
+				double dd = 0;
+				for (auto c = 0; c < 3; c++) {
+					const double x = o[c] + s * d[c] - a[c] - u * e1[c];
+					dd += x * x;
+				}
+				if (std::sqrt(dd) <= 3 * pixel(s)) take(s);
+			}
+		}
+	}
+
+	// Heightfield.
+	if (sl.field >= 0 && fieldHit(h, _field[sl.field], o, d, t)) got = true;
+
+	// Instanced shape.
+	if (sl.group < 0) return got;
+	const group& g = _group[sl.group];
+	const instance& in = g.inst[sl.inst];
+	const double w[3] = { o[0] - in.pos[0], o[1] - in.pos[1], o[2] - in.pos[2] };
+
+	// Dots, within 3 pixels of their border.
+	if (g.key.shape == mesh::kShape::dot) {
+		const double s = std::max(0.0, -dot3(w, d) / dot3(d, d));
+		double dd = 0;
+		for (auto c = 0; c < 3; c++) dd += (w[c] + s * d[c]) * (w[c] + s * d[c]);
+		if (std::sqrt(dd) <= (3 + in.ax[0] / 2) * pixel(s)) take(s);
+		return got;
+	}
+
+	// Solids: the ray into the unit shape space, through the inverse axes.
+	const double X[3] = { in.ax[0], in.ax[1], in.ax[2] };
+	const double Y[3] = { in.ax[3], in.ax[4], in.ax[5] };
+	const double Z[3] = { in.ax[6], in.ax[7], in.ax[8] };
+	double yz[3], zx[3], xy[3];
+	cross(Y, Z, yz);
+	cross(Z, X, zx);
+	cross(X, Y, xy);
+	const double det = dot3(X, yz);
+	if (std::fabs(det) < 1e-300) return got;
+	const double uo[3] = { dot3(yz, w) / det, dot3(zx, w) / det, dot3(xy, w) / det };
+	const double ud[3] = { dot3(yz, d) / det, dot3(zx, d) / det, dot3(xy, d) / det };
+
+	// Cube: slabs.
+	if (g.key.shape == mesh::kShape::cube) {
+		double s0 = -1e300, s1 = 1e300;
+		for (auto a = 0; a < 3; a++) {
+			if (ud[a] == 0) {
+				if (std::fabs(uo[a]) > 0.5) return got;
+				continue;
+			}
+			double ta = (-0.5 - uo[a]) / ud[a], tb = (0.5 - uo[a]) / ud[a];
+			if (ta > tb) std::swap(ta, tb);
+			s0 = std::max(s0, ta);
+			s1 = std::min(s1, tb);
+		}
+		if (s0 <= s1) take(s0 >= 0 ? s0 : s1);
+
+	// Sphere.
+	} else if (g.key.shape == mesh::kShape::ball) {
+		const double A = dot3(ud, ud), B = 2 * dot3(uo, ud), C = dot3(uo, uo) - 1;
+		const double q = B * B - 4 * A * C;
+		if (q >= 0) {
+			const double s0 = (-B - std::sqrt(q)) / (2 * A);
+			take(s0 >= 0 ? s0 : (-B + std::sqrt(q)) / (2 * A));
+		}
+
+	// Tube: outer and inner surfaces (r = a + b z), then the caps rings.
+	} else if (g.key.shape == mesh::kShape::pipe) {
+		const double ri0 = g.key.param[0] / 10000.0, ro0 = g.key.param[1] / 10000.0;
+		const double ri1 = g.key.param[2] / 10000.0, ro1 = g.key.param[3] / 10000.0;
+		auto surface = [&](const double& a, const double& b) {
+			const double A = ud[0] * ud[0] + ud[1] * ud[1] - b * b * ud[2] * ud[2];
+			const double B = 2 * (uo[0] * ud[0] + uo[1] * ud[1] - (a + b * uo[2]) * b * ud[2]);
+			const double C = uo[0] * uo[0] + uo[1] * uo[1] - (a + b * uo[2]) * (a + b * uo[2]);
+			double r[2];
+			int n = 0;
+			if (std::fabs(A) < 1e-12) {
+				if (B != 0) r[n++] = -C / B;
+			} else {
+				const double q = B * B - 4 * A * C;
+				if (q < 0) return;
+				r[n++] = (-B - std::sqrt(q)) / (2 * A);
+				r[n++] = (-B + std::sqrt(q)) / (2 * A);
+			}
+			for (auto i = 0; i < n; i++) {
+				const double z = uo[2] + r[i] * ud[2];
+				if (z >= 0 && z <= 1 && a + b * z >= 0) take(r[i]);
+			}
+		};
+		surface(ro0, ro1 - ro0);
+		if (ri0 > 0 || ri1 > 0) surface(ri0, ri1 - ri0);
+		if (ud[2] != 0) {
+			for (auto z = 0; z < 2; z++) {
+				const double s = (z - uo[2]) / ud[2];
+				const double x = uo[0] + s * ud[0], y = uo[1] + s * ud[1];
+				const double ri = z ? ri1 : ri0, ro = z ? ro1 : ro0;
+				if (x * x + y * y >= ri * ri && x * x + y * y <= ro * ro) take(s);
+			}
+		}
+	}
+	return got;
+}
+
+//______________________________________________________________________________
+void batch::detail(const float* mvp, const float& fy)
+{
+	/* Updates the detail level of the visible level dependent GPs from the
+	 * projected radius (pixels) of their bounds, \c fy being the projection
+	 * y focal times half the viewport height. A level is left only when the
+	 * radius is 20% past its threshold, to avoid popping back and forth. The
+	 * GPs changing level are written again.
+	 */
+	static const float thr[3] = { 64, 24, 8 };
+	auto pick = [](const float& px) {
+		uint8_t l = 0;
+		while (l < 3 && px < thr[l]) l++;
+		return l;
+	};
+	for (size_t h = 1; h < _slot.size(); h++) {
+		slot& sl = _slot[h];
+		float lo[3], hi[3];
+		if (!sl.detailed || !visible(h) || !_bvh.box(h, lo, hi)) continue;
+
+		// Projected bounding sphere radius.
+		float c[3], r = 0;
+		for (auto a = 0; a < 3; a++) {
+			c[a] = (lo[a] + hi[a]) / 2;
+			r += (hi[a] - lo[a]) * (hi[a] - lo[a]) / 4;
+		}
+		r = std::sqrt(r);
+		const float w = mvp[3] * c[0] + mvp[7] * c[1] + mvp[11] * c[2] + mvp[15];
+		const float px = w > r ? r * fy / w : thr[0] * 2;
+
+		// New level, with hysteresis.
+		uint8_t level = sl.level;
+		const uint8_t finer = pick(px / 1.2f);
+		const uint8_t coarser = pick(px * 1.2f);
+		if (finer < level) level = finer;
+		else if (coarser > level) level = coarser;
+		if (level == sl.level) continue;
+		sl.level = level;
+		GP* gp = _scene ? _scene->gpGet(h) : 0;
+		if (gp) {
+			write(gp, sl);
+			bound(h);
+		}
+	}
+}
+
+//______________________________________________________________________________
+void batch::write(GP* gp, slot& s)
+{
+	/* Writes the \c gp geometry into the buckets, its text into the glyphs
+	 * buffer. A part keeping its bucket and size is overwritten in place,
+	 * otherwise it is appended.
+	 */
+	_mesh.clear(gp);
+	_mesh.level = s.level;
+	s.batched = gp->glMesh(_mesh);
+	s.detailed = _mesh.detailed;
+	for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+		const std::vector<vertex>& mv = _mesh.vtx[p];
+		const std::vector<uint32_t>& mi = _mesh.idx[p];
+		int32_t b = -1;
+		if (s.batched && !mv.empty()) {
+			b = bucketGet(p == mesh::kPart::fill ? _mesh.material : 0, p, _mesh.alpha[p]);
+		}
+
+		// Same place: overwrite.
+		if (b >= 0 && b == s.bucket[p] && mv.size() == s.vn[p] && mi.size() == s.in[p]) {
+			bucket& k = _bucket[b];
+			std::copy(mv.begin(), mv.end(), k.vtx.begin() + s.v0[p]);
+			for (size_t i = 0; i < mi.size(); i++) k.idx[s.i0[p] + i] = s.v0[p] + mi[i];
+			k.vLo = std::min<size_t>(k.vLo, s.v0[p]);
+			k.vHi = std::max<size_t>(k.vHi, s.v0[p] + mv.size());
+			k.iLo = std::min<size_t>(k.iLo, s.i0[p]);
+			k.iHi = std::max<size_t>(k.iHi, s.i0[p] + mi.size());
+			continue;
+		}
+
+		// Otherwise drop the old geometry and append the new one.
+		erase(s, p);
+		if (b < 0) continue;
+		bucket& k = _bucket[b];
+		s.bucket[p] = b;
+		s.v0[p] = (uint32_t)k.vtx.size();
+		s.vn[p] = (uint32_t)mv.size();
+		s.i0[p] = (uint32_t)k.idx.size();
+		s.in[p] = (uint32_t)mi.size();
+		k.vLo = std::min<size_t>(k.vLo, k.vtx.size());
+		k.iLo = std::min<size_t>(k.iLo, k.idx.size());
+		k.vtx.insert(k.vtx.end(), mv.begin(), mv.end());
+		for (size_t i = 0; i < mi.size(); i++) k.idx.push_back(s.v0[p] + mi[i]);
+		k.vHi = k.vtx.size();
+		k.iHi = k.idx.size();
+	}
+
+	// The glyphs: overwritten in place if the same count, appended otherwise.
+	const std::vector<letter>& mt = _mesh.text;
+	if (s.batched && !mt.empty() && mt.size() == s.tn) {
+		std::copy(mt.begin(), mt.end(), _text.begin() + s.t0);
+		_tLo = std::min<size_t>(_tLo, s.t0);
+		_tHi = std::max<size_t>(_tHi, s.t0 + s.tn);
+	} else {
+		textErase(s);
+		if (s.batched && !mt.empty()) {
+			s.t0 = (uint32_t)_text.size();
+			s.tn = (uint32_t)mt.size();
+			_tLo = std::min<size_t>(_tLo, _text.size());
+			_text.insert(_text.end(), mt.begin(), mt.end());
+			_tHi = _text.size();
+		}
+	}
+
+	// The heightfield, rewritten in place.
+	if (s.batched && _mesh.grid.tex) {
+		if (s.field < 0) {
+			s.field = (int32_t)_field.size();
+			_field.push_back(_mesh.grid);
+			_fOwner.push_back(gp->handle());
+		}
+		_field[s.field] = _mesh.grid;
+	} else {
+		fieldErase(s);
+	}
+
+	// The instance: rewritten in place if still in the same group.
+	int32_t g = -1;
+	if (s.batched && _mesh.shape != mesh::kShape::none) g = groupGet(_mesh);
+	if (g >= 0 && _mesh.shape == mesh::kShape::dot) _dotMax = std::max(_dotMax, _mesh.inst.ax[0]);
+	if (g >= 0 && g == s.group) {
+		group& k = _group[g];
+		k.inst[s.inst] = _mesh.inst;
+		k.lo = std::min<size_t>(k.lo, s.inst);
+		k.hi = std::max<size_t>(k.hi, s.inst + 1);
+		return;
+	}
+	unlink(s);
+	if (g < 0) return;
+	group& k = _group[g];
+	s.group = g;
+	s.inst = (uint32_t)k.inst.size();
+	k.inst.push_back(_mesh.inst);
+	k.owner.push_back(gp->handle());
+	k.lo = std::min<size_t>(k.lo, s.inst);
+	k.hi = k.inst.size();
+}
+
+//______________________________________________________________________________
+void batch::pack(bucket& k)
+{
+	/* Packs the bucket \c k dropping its holes, and moves the slots which
+	 * live in it accordingly. The whole bucket will be uploaded again.
+	 */
+	const int32_t b = (int32_t)(&k - &_bucket[0]);
+	std::vector<vertex> vtx;
+	std::vector<uint32_t> idx;
+	vtx.reserve(k.vtx.size() - k.holes);
+	idx.reserve(k.idx.size());
+	for (auto& s : _slot) {
+		const uint32_t p = k.part;
+		if (s.bucket[p] != b) continue;
+		const uint32_t v0 = (uint32_t)vtx.size();
+		vtx.insert(vtx.end(), k.vtx.begin() + s.v0[p], k.vtx.begin() + s.v0[p] + s.vn[p]);
+		const uint32_t i0 = (uint32_t)idx.size();
+		for (uint32_t i = s.i0[p]; i < s.i0[p] + s.in[p]; i++) idx.push_back(k.idx[i] - s.v0[p] + v0);
+		s.v0[p] = v0;
+		s.i0[p] = i0;
+	}
+	k.vtx.swap(vtx);
+	k.idx.swap(idx);
+	k.holes = 0;
+	k.repack = false;
+	k.vLo = k.iLo = 0;
+	k.vHi = k.vtx.size();
+	k.iHi = k.idx.size();
+}
+
+//______________________________________________________________________________
+void batch::upload(bucket& k)
+{
+	/* Sends the changed ranges of \c k to its GL buffers, creating them or
+	 * growing them (by half their size, to amortize) when needed.
+	 */
+	if (k.repack) pack(k);
+
+	// Creates the GL objects and the vertex layout.
+	if (!k.vao) {
+		glGenVertexArrays(1, &k.vao);
+		glGenBuffers(1, &k.vbo);
+		glGenBuffers(1, &k.ibo);
+		glBindVertexArray(k.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, k.vbo);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, k.ibo);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof(vertex, pos));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(vertex), (void*)offsetof(vertex, nrm));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(vertex), (void*)offsetof(vertex, rgba));
+	} else {
+		glBindVertexArray(k.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, k.vbo);
+	}
+
+	// Vertexes.
+	if (k.vtx.size() > k.vCap) {
+		k.vCap = k.vtx.size() + k.vtx.size() / 2;
+		glBufferData(GL_ARRAY_BUFFER, k.vCap * sizeof(vertex), 0, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, k.vtx.size() * sizeof(vertex), k.vtx.data());
+	} else if (k.vLo < k.vHi) {
+		glBufferSubData(GL_ARRAY_BUFFER, k.vLo * sizeof(vertex), (k.vHi - k.vLo) * sizeof(vertex), k.vtx.data() + k.vLo);
+	}
+
+	// Indexes.
+	if (k.idx.size() > k.iCap) {
+		k.iCap = k.idx.size() + k.idx.size() / 2;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, k.iCap * sizeof(uint32_t), 0, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, k.idx.size() * sizeof(uint32_t), k.idx.data());
+	} else if (k.iLo < k.iHi) {
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, k.iLo * sizeof(uint32_t), (k.iHi - k.iLo) * sizeof(uint32_t), k.idx.data() + k.iLo);
+	}
+
+	// Clean.
+	k.vLo = k.iLo = SIZE_MAX;
+	k.vHi = k.iHi = 0;
+}
+
+//______________________________________________________________________________
+GLuint batch::glLink(const char* vtx, const char* frg, const char** attr, const GLuint& n)
+{
+	/* Compiles the \c vtx and \c frg shaders and links them, binding the \c n
+	 * \c attr attributes names to their index. Returns the program, or 0 if
+	 * something failed.
+	 */
+
+	// Compile.
+	GLint ok = 0;
+	bool failed = false;
+	GLuint sh[2] = { glCreateShader(GL_VERTEX_SHADER), glCreateShader(GL_FRAGMENT_SHADER) };
+	glShaderSource(sh[0], 1, &vtx, 0);
+	glShaderSource(sh[1], 1, &frg, 0);
+	for (auto i = 0; i < 2; i++) {
+		glCompileShader(sh[i]);
+		glGetShaderiv(sh[i], GL_COMPILE_STATUS, &ok);
+		if (!ok) {
+			char log[512];
+			glGetShaderInfoLog(sh[i], 512, 0, log);
+			std::cout << "batch: shader compilation failed: " << log << "\n";
+			failed = true;
+		}
+	}
+
+	// Link.
+	GLuint program = 0;
+	if (!failed) {
+		program = glCreateProgram();
+		glAttachShader(program, sh[0]);
+		glAttachShader(program, sh[1]);
+		for (GLuint a = 0; a < n; a++) glBindAttribLocation(program, a, attr[a]);
+		glLinkProgram(program);
+		glGetProgramiv(program, GL_LINK_STATUS, &ok);
+		if (!ok) {
+			std::cout << "batch: shader linking failed\n";
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+	glDeleteShader(sh[0]);
+	glDeleteShader(sh[1]);
+	return program;
+}
+
+//______________________________________________________________________________
+bool batch::glProgram()
+{
+	/* Compiles and links the batch and text shaders on first use. Returns
+	 * false if the programs are available, true otherwise.
+	 */
+	if (_program) return false;
+	if (_glFailed) return true;
+
+	// Build.
+	static const char* attr[8] = { "aPos", "aNrm", "aCol", "aIPos", "aIX", "aIY", "aIZ", "aICol" };
+	static const char* tAttr[4] = { "aPos", "aOff", "aUv", "aCol" };
+	_program = glLink(batchVtxShader, batchFrgShader, attr, 8);
+	_tProgram = glLink(textVtxShader, textFrgShader, tAttr, 4);
+	if (!_program || !_tProgram) {
+		if (_program) glDeleteProgram(_program);
+		if (_tProgram) glDeleteProgram(_tProgram);
+		_program = _tProgram = 0;
+		_glFailed = true;
+		return true;
+	}
+
+	// Uniforms.
+	_uMvp = glGetUniformLocation(_program, "uMvp");
+	_uMv = glGetUniformLocation(_program, "uMv");
+	_uLit = glGetUniformLocation(_program, "uLit");
+	_uInst = glGetUniformLocation(_program, "uInst");
+	_uField = glGetUniformLocation(_program, "uField");
+	_uFCols = glGetUniformLocation(_program, "uFCols");
+	_uFScale = glGetUniformLocation(_program, "uFScale");
+	_uFPos = glGetUniformLocation(_program, "uFPos");
+	_uFAx = glGetUniformLocation(_program, "uFAx");
+	_uFCol = glGetUniformLocation(_program, "uFCol");
+	_uValues = glGetUniformLocation(_program, "uValues");
+	_tMvp = glGetUniformLocation(_tProgram, "uMvp");
+	_tView = glGetUniformLocation(_tProgram, "uView");
+	_tAtlas = glGetUniformLocation(_tProgram, "uAtlas");
+	return false;
+}
+
+
+// *****************************************************************************
+// **							batch Public members						  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void batch::clear()
+{
+	/*! Drops all the geometry and the buffers. The next update() will write
+	 *	the whole scene again. The unit meshes and the glyphs stay cached for
+	 *	reuse.
+	 */
+	for (auto& k : _bucket) {
+		if (k.vao) glDeleteVertexArrays(1, &k.vao);
+		if (k.vbo) glDeleteBuffers(1, &k.vbo);
+		if (k.ibo) glDeleteBuffers(1, &k.ibo);
+	}
+	_bucket.clear();
+	for (auto& k : _group) {
+		if (k.vao) glDeleteVertexArrays(1, &k.vao);
+		if (k.mesh >= 0) _tess.release(k.mesh);
+		if (k.ibuf) glDeleteBuffers(1, &k.ibuf);
+		if (k.cbuf) glDeleteBuffers(1, &k.cbuf);
+	}
+	_group.clear();
+	_field.clear();
+	_fOwner.clear();
+	if (_fVao) glDeleteVertexArrays(1, &_fVao);
+	if (_fMesh >= 0) _tess.release(_fMesh);
+	_fVao = 0;
+	_fMesh = -1;
+	if (_tVao) glDeleteVertexArrays(1, &_tVao);
+	if (_tVbo) glDeleteBuffers(1, &_tVbo);
+	_tVao = _tVbo = 0;
+	_text.clear();
+	_tHoles = 0;
+	_tLo = SIZE_MAX;
+	_tHi = 0;
+	_tCap = 0;
+	_slot.clear();
+	_bvh.clear();
+	_visible.clear();
+	_depth.clear();
+	_step.clear();
+	_culled = false;
+	_dotMax = 0;
+	_scene = 0;
+}
+
+//______________________________________________________________________________
+void batch::update(scene* s)
+{
+	/*! Brings the buffers in sync with the scene \c s. Nothing is done if the
+	 *	scene has not changed since the last call. Otherwise the new and the
+	 *	modified GPs are written again, as well as all the GPs below a moved
+	 *	frame (their scene coordinates depend on it), and the deleted GPs are
+	 *	dropped. The GPs redraw flags are reset.
+	 */
+	if (s != _scene) {
+		clear();
+		_scene = s;
+	}
+	if (!s) return;
+	const size_t n = s->gpSize();
+	if (_slot.size() == n && !s->modeNeedRedraw()) return;
+
+	// New slots.
+	slot empty;
+	for (uint32_t p = 0; p < mesh::kPart::count; p++) {
+		empty.bucket[p] = -1;
+		empty.v0[p] = empty.vn[p] = empty.i0[p] = empty.in[p] = 0;
+	}
+	empty.group = -1;
+	empty.inst = 0;
+	empty.field = -1;
+	empty.t0 = empty.tn = 0;
+	empty.level = 0;
+	empty.detailed = false;
+	empty.batched = false;
+	empty.known = false;
+	empty.frameVer = 0;
+	if (_slot.size() < n) _slot.resize(n, empty);
+
+	// Write what changed.
+	for (size_t h = 1; h < n; h++) {
+		slot& sl = _slot[h];
+		GP* gp = s->gpGet(h);
+
+		// Deleted GP.
+		if (!gp) {
+			if (sl.known) {
+				for (uint32_t p = 0; p < mesh::kPart::count; p++) erase(sl, p);
+				textErase(sl);
+				unlink(sl);
+				fieldErase(sl);
+				_bvh.remove(h);
+			}
+			sl = empty;
+			continue;
+		}
+
+		// Changed GP, or GP moved by a frame. The redraw flag of a frame is
+		// no use here, as every changed child raises it: the frames versions
+		// tell the actual moves.
+		uint64_t fv = 0;
+		for (GP* pp = s->gpGet(gp->parent()); pp; pp = s->gpGet(pp->parent())) {
+			if (pp->type() == CO::oType::gpFrame) fv = std::max(fv, static_cast<frame*>(pp)->trsfVersion());
+		}
+		if (!sl.known || gp->modeNeedRedraw() || fv != sl.frameVer) {
+			write(gp, sl);
+			bound(h);
+			sl.known = true;
+			sl.frameVer = fv;
+		}
+		if (gp->modeNeedRedraw()) gp->modeNeedRedraw(false);
+	}
+}
+
+//______________________________________________________________________________
+bool batch::batched(const GPHnd& hnd) const
+{
+	/*! Returns true if the GP \c hnd is drawn by the batch, i.e. it must not
+	 *	be drawn through glDisplay().
+	 */
+	return hnd < _slot.size() && _slot[hnd].batched;
+}
+
+//______________________________________________________________________________
+bool batch::visible(const GPHnd& hnd) const
+{
+	/*! Returns false if the GP \c hnd was out of the view frustum at the last
+	 *	opaque glDraw(). GPs without bounds are always visible.
+	 */
+	if (!_culled || !_bvh.has(hnd)) return true;
+	return hnd < _visible.size() && _visible[hnd];
+}
+
+//______________________________________________________________________________
+GPHnd batch::pick(const double* o, const double* d, const double* px, double& t, std::vector<GPHnd>* all)
+{
+	/*! Casts the ray o + s * d (scene coordinates), 0 <= s <= \c t, and
+	 *	returns the nearest GP hit (0 if none), setting \c t to the hit. The
+	 *	lines and dots are hit within a few pixels, px[0] and px[1] being the
+	 *	pixel size at s = 0 and s = 1. If \c all is given, every GP hit along
+	 *	the ray is appended to it as well. Only the batched GPs can be picked.
+	 */
+	const float fo[3] = { (float)o[0], (float)o[1], (float)o[2] };
+	const float fd[3] = { (float)d[0], (float)d[1], (float)d[2] };
+	const double slack = 3 + _dotMax / 2;
+	const float m[2] = { (float)(slack * px[0]), (float)(slack * (px[1] - px[0])) };
+	float ft = (float)t;
+	double best = t;
+	GPHnd hnd = 0;
+	_bvh.ray(fo, fd, m, ft, [&](const GPHnd& h, float& s) {
+		double sh = all ? t : std::min<double>(s, best);
+		if (!hit(h, o, d, px, sh)) return false;
+		if (all) all->push_back(h);
+		if (sh < best) {
+			best = sh;
+			hnd = h;
+		}
+		s = (float)sh;
+		return !all;
+	});
+	if (hnd) t = best;
+	return hnd;
+}
+
+//______________________________________________________________________________
+void batch::glDraw(const double* mv, const double* prj, const bool& alpha)
+{
+	/*! Draws the opaque buckets if \c alpha = false, the transparent ones
+	 *	otherwise (with depth writing disabled, so call it after the opaque
+	 *	drawing). \c mv and \c prj are the column-major modelview and
+	 *	projection matrixes of the view. One draw call is issued per bucket
+	 *	and one instanced call per group (a few, if culled) or heightfield.
+	 *	The transparent pass draws instead all the transparent GPs back to
+	 *	front, the ones not batched too (through their glDisplay()), then all
+	 *	the text with one more call. The opaque call also culls the GPs
+	 *	against the view frustum, for both passes.
+	 */
+	if (!alpha) _calls = 0;
+	if (glProgram()) {
+		const size_t n = alpha && _scene ? _scene->gpSize() : 0;
+		for (GPHnd h = 1; h < n; h++) {
+			GP* gp = _scene->gpGet(h);
+			if (gp && !batched(h) && gp->glAlpha()) gp->glDisplay();
+		}
+		return;
+	}
+
+	// Matrixes.
+	float fMv[16], fMvp[16];
+	for (auto c = 0; c < 4; c++) {
+		for (auto r = 0; r < 4; r++) {
+			double sum = 0;
+			for (auto k = 0; k < 4; k++) sum += prj[k * 4 + r] * mv[c * 4 + k];
+			fMvp[c * 4 + r] = (float)sum;
+			fMv[c * 4 + r] = (float)mv[c * 4 + r];
+		}
+	}
+	glUseProgram(_program);
+	glUniformMatrix4fv(_uMvp, 1, GL_FALSE, fMvp);
+	glUniformMatrix4fv(_uMv, 1, GL_FALSE, fMv);
+
+	// Culling and level of detail, once per frame. The buckets are then
+	// uploaded before collecting the visible ranges, as packing moves them.
+	if (!alpha) {
+		GLint vp[4];
+		glGetIntegerv(GL_VIEWPORT, vp);
+		_culled = _bvh.cull(fMvp, _visible) < _bvh.size();
+		detail(fMvp, (float)(prj[5] * vp[3] / 2));
+
+		// Text laid out with glyphs the atlas has since moved is written
+		// again (a further move is caught by the next frame).
+		if (_tGen != _atlas.generation()) {
+			_tGen = _atlas.generation();
+			for (size_t h = 1; h < _slot.size(); h++) {
+				GP* gp = _scene ? _scene->gpGet(h) : 0;
+				if (gp && _slot[h].tn) write(gp, _slot[h]);
+			}
+		}
+		for (auto& k : _bucket) upload(k);
+		if (_culled) runs();
+	}
+	if (alpha) {
+		sort(fMv);
+		glDepthMask(GL_FALSE);
+	}
+
+	// One call per bucket, on the visible ranges only if culling. The
+	// transparent ones are drawn by the steps, below.
+	for (auto& k : _bucket) {
+		if (k.alpha != alpha) continue;
+		upload(k);
+		if (alpha || k.idx.empty()) continue;
+		if (_culled && k.rc.empty()) continue;
+		const GLenum mode = k.part == mesh::kPart::fill ? GL_TRIANGLES : GL_LINES;
+		glUniform1i(_uLit, k.part == mesh::kPart::fill);
+		glUniform1i(_uInst, 0);
+		if (_culled) glMultiDrawElements(mode, k.rc.data(), GL_UNSIGNED_INT, k.ro.data(), (GLsizei)k.rc.size());
+		else glDrawElements(mode, (GLsizei)k.idx.size(), GL_UNSIGNED_INT, 0);
+		_calls++;
+	}
+
+	// The groups. Only the changed instances are sent.
+	for (auto& k : _group) {
+		if (k.alpha != alpha || k.inst.empty()) continue;
+		if (!k.vao) unit(k);
+		glBindVertexArray(k.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, k.ibuf);
+		if (k.inst.size() > k.cap) {
+			k.cap = k.inst.size() + k.inst.size() / 2;
+			glBufferData(GL_ARRAY_BUFFER, k.cap * sizeof(instance), 0, GL_DYNAMIC_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, k.inst.size() * sizeof(instance), k.inst.data());
+			k.stale = true;
+		} else if (k.lo < k.hi) {
+			const size_t hi = std::min(k.hi, k.inst.size());
+			if (k.lo < hi) glBufferSubData(GL_ARRAY_BUFFER, k.lo * sizeof(instance), (hi - k.lo) * sizeof(instance), k.inst.data() + k.lo);
+			k.stale = true;
+		}
+		k.lo = SIZE_MAX;
+		k.hi = 0;
+
+		// The transparent ones are drawn by the steps, from their sorted
+		// buffer.
+		if (alpha) {
+			stream(k, k.sorted);
+			instAttrib(k.cbuf);
+			continue;
+		}
+		const bool dot = k.key.shape == mesh::kShape::dot;
+		glUniform1i(_uLit, !dot);
+		glUniform1i(_uInst, 1);
+		if (dot) glEnable(GL_PROGRAM_POINT_SIZE);
+
+		// All the instances, or a few runs of the visible ones, straight
+		// from the instance buffer.
+		_cseq.clear();
+		if (_culled) {
+			for (uint32_t i = 0; i < (uint32_t)k.inst.size(); i++) if (visible(k.owner[i])) _cseq.push_back(i);
+		}
+		size_t runs = 0;
+		for (size_t i = 0; i < _cseq.size(); i++) if (!i || _cseq[i] != _cseq[i - 1] + 1) runs++;
+		if (!_culled) {
+			instDraw(k, k.ibuf, 0, (uint32_t)k.inst.size());
+		} else if (runs <= 8) {
+			for (size_t i = 0, j = 0; i < _cseq.size(); i = j) {
+				for (j = i + 1; j < _cseq.size() && _cseq[j] == _cseq[j - 1] + 1; j++);
+				instDraw(k, k.ibuf, _cseq[i], (uint32_t)(j - i));
+			}
+
+		// Scattered ones from their own buffer.
+		} else {
+			stream(k, _cseq);
+			instAttrib(k.cbuf);
+			instDraw(k, k.cbuf, 0, (uint32_t)k.seq.size());
+			instAttrib(k.ibuf);
+		}
+		if (dot) glDisable(GL_PROGRAM_POINT_SIZE);
+	}
+
+	// One instanced call per heightfield.
+	if (!alpha) {
+		for (size_t i = 0; i < _field.size(); i++) {
+			if (!_field[i].alpha && visible(_fOwner[i])) fieldDraw(_field[i]);
+		}
+	}
+
+	// The transparent steps, back to front. The GPs left to glDisplay()
+	// are drawn in between, without the batch program.
+	if (alpha) {
+		bool bound = true;
+		for (auto& t : _step) {
+			if (t.gp) {
+				GP* gp = _scene ? _scene->gpGet(t.gp) : 0;
+				if (!gp) continue;
+				glBindVertexArray(0);
+				glUseProgram(0);
+				gp->glDisplay();
+				bound = false;
+				continue;
+			}
+			if (!bound) glUseProgram(_program);
+			bound = true;
+			if (t.field >= 0) {
+				fieldDraw(_field[t.field]);
+			} else if (t.bucket >= 0) {
+				const bucket& k = _bucket[t.bucket];
+				glBindVertexArray(k.vao);
+				glUniform1i(_uLit, k.part == mesh::kPart::fill);
+				glUniform1i(_uInst, 0);
+				glMultiDrawElements(k.part == mesh::kPart::fill ? GL_TRIANGLES : GL_LINES,
+					_rc.data() + t.r0, GL_UNSIGNED_INT, _ro.data() + t.r0, (GLsizei)t.rn);
+				_calls++;
+			} else {
+				const group& k = _group[t.group];
+				const bool dot = k.key.shape == mesh::kShape::dot;
+				glBindVertexArray(k.vao);
+				glUniform1i(_uLit, !dot);
+				glUniform1i(_uInst, 1);
+				if (dot) glEnable(GL_PROGRAM_POINT_SIZE);
+				instDraw(k, k.cbuf, t.r0, t.rn);
+				if (dot) glDisable(GL_PROGRAM_POINT_SIZE);
+			}
+		}
+
+		// The text, after all the transparent geometry.
+		textDraw(fMvp);
+	}
+
+	// Restore.
+	if (alpha) glDepthMask(GL_TRUE);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+//______________________________________________________________________________
+tess& batch::cache()
+{
+	/*! Returns the cache of the unit meshes, e.g. to set its budget. */
+	return _tess;
+}
+
+//______________________________________________________________________________
+atlas& batch::font()
+{
+	/*! Returns the glyph atlas of the text. */
+	return _atlas;
+}
+
+//______________________________________________________________________________
+size_t batch::buckets() const
+{
+	/*! Returns the number of buckets (material, part, transparency). */
+	return _bucket.size();
+}
+
+//______________________________________________________________________________
+size_t batch::calls() const
+{
+	/*! Returns the draw calls issued by the last frame. */
+	return _calls;
+}
+
+//______________________________________________________________________________
+size_t batch::vertexes() const
+{
+	/*! Returns the vertexes stored in the buckets, holes included. */
+	size_t n = 0;
+	for (auto& k : _bucket) n += k.vtx.size();
+	return n;
+}
+
+//______________________________________________________________________________
+size_t batch::instances() const
+{
+	/*! Returns the instances stored in the groups. */
+	size_t n = 0;
+	for (auto& k : _group) n += k.inst.size();
+	return n;
+}
+
+//______________________________________________________________________________
+size_t batch::glyphs() const
+{
+	/*! Returns the glyph quads stored, holes included. */
+	return _text.size() / 6;
+}
+
+// #############################################################################
+}} // Close namespace
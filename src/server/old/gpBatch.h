@@ -0,0 +1,442 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives batched geometry									  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpBatch.h"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"c++"
+//______________________________________________________________________________
+
+// Overloading check
+#if !defined gpBatch_H
+#define gpBatch_H
+
+// GLAD bindings.
+#include "glad.h"
+
+// Application components.
+#include "gp.h"
+#include "gpAtlas.h"
+#include "gpBvh.h"
+#include "gpDepth.h"
+
+// Standard library.
+#include <map>
+#include <vector>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+//! Batched vertex.
+/*! The vertex layout shared by all the batched geometry: position and normal
+ *	in scene (world) coordinates, and a packed RGBA color.
+ */
+struct vertex { float pos[3]; float nrm[3]; uint32_t rgba; };
+
+//! Batched instance.
+/*! The per-instance attributes of the instanced shapes: the transform of
+ *	the unit shape, as position and x, y, z axes (columns) in scene
+ *	coordinates, and a packed RGBA color. For dots, ax[0] is the size in
+ *	pixels.
+ */
+struct instance { float pos[3]; float ax[9]; uint32_t rgba; };
+
+//! Batched glyph vertex.
+/*! The vertex layout of the batched text: the anchor of the text, in scene
+ *	coordinates (pos[3] = 1) or in viewport pixels (pos[3] = 0), the vertex
+ *	offset from the projected anchor in pixels, the atlas texture coordinates
+ *	and a packed RGBA color.
+ */
+struct letter { float pos[4]; float off[2]; float uv[2]; uint32_t rgba; };
+
+
+//! GP geometry writer
+/*! A cat::gp::mesh collects the triangles (fill part) and the lines (stroke
+ *	part) a GP is made of, already moved into scene coordinates through the
+ *	GP family transformations, and its text as glyph quads of the batch atlas
+ *	(which the GP lays out through \c font). GPs write themselves into a mesh through their
+ *	glMesh() member, the cat::gp::batch then copies the mesh into the shared
+ *	buffers.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+class mesh
+{
+	public:
+
+		//! Mesh parts.
+		enum kPart : uint32_t {
+			fill = 0,		//! Triangles.
+			stroke = 1,		//! Lines.
+			count = 2
+		};
+
+		//! Instanced shapes.
+		enum kShape : uint32_t {
+			none = 0,		//! Not an instance.
+			dot = 1,		//! Screen point.
+			ball = 2,		//! Unit sphere.
+			cube = 3,		//! Unit cube.
+			pipe = 4		//! Unit tube (along z, from 0 to 1).
+		};
+
+		//! Heightfield: a grid of cells, each a box raised by the value of
+		//! its texel in an R32F texture.
+		struct field {
+			GLuint tex;								//!< Values texture (0 = none).
+			uint32_t cols, rows;					//!< Grid size.
+			float lo, span;							//!< Values to heights, (v - lo) / span.
+			instance frame;							//!< Grid corner, cell x, y axes, full height z axis, color.
+			bool alpha;								//!< Transparent cells.
+		};
+
+		// The geometry.
+		std::vector<vertex> vtx[kPart::count];		//!< Vertexes, by part.
+		std::vector<uint32_t> idx[kPart::count];	//!< Indexes, by part.
+		bool alpha[kPart::count];					//!< Transparent part.
+		GPHnd material;								//!< Fill material (0 = colors only).
+		kShape shape;								//!< Instanced shape (none = no instance).
+		uint16_t slices;							//!< Instanced shape slices.
+		uint16_t stacks;							//!< Instanced shape stacks.
+		float param[4];								//!< Instanced shape parameters.
+		instance inst;								//!< The instance attributes.
+		field grid;									//!< The heightfield, if any.
+		std::vector<letter> text;					//!< Glyph quads (6 vertexes each).
+		atlas* font;								//!< The glyph atlas of the text.
+		uint8_t level;								//!< Detail level (0 = full) to write.
+		bool detailed;								//!< The GP used the detail level.
+
+		// Special members.
+		mesh();									//!< Default ctor.
+		~mesh();								//!< Dtor.
+
+		// Setup.
+		void clear(GP* = 0);					//!< Empties the mesh for a GP.
+		bool empty() const;						//!< Nothing written.
+
+		// Writing (coordinates are GP ones).
+		uint32_t vertexAdd(const kPart&, const ge::point&, const float* nrm, const float* col);
+		void triangle(const ge::point&, const ge::point&, const ge::point&, const float* col);
+		void quad(const ge::point&, const ge::point&, const ge::point&, const ge::point&, const float* col);
+		void segment(const ge::point&, const ge::point&, const float* col);
+		void strip(const std::vector<ge::point>&, const bool& closed, const float* col);
+		void shaped(const kShape&, const ge::point&, const double* ax, const float* col,
+					const uint16_t& = 0, const uint16_t& = 0, const float* = 0);
+		void glyph(const ge::point&, const bool& screen, const float* xy, const float* uv, const uint32_t& rgba);
+		void heightfield(const GLuint& tex, const uint32_t& cols, const uint32_t& rows, const double* ax,
+						 const float& lo, const float& span, const float* col);
+
+		// Level of detail.
+		uint16_t lod(const uint16_t& n, const uint16_t& min);	//!< Tessellation for the detail level.
+
+		// Color packing.
+		static uint32_t rgba(const float* col);
+
+	private:
+
+		GP* _gp;								// The GP being written.
+};
+
+
+//! Shared tessellation cache
+/*! A cat::gp::tess keeps the GL meshes of the unit shapes (sphere, cube,
+ *	tube, ...) used by the instanced GPs, keyed by their canonical parameters
+ *	(shape, slices, stacks, quantized ratios), so that thousands of GPs with
+ *	the same parameters share one mesh and carry just their transform. Meshes
+ *	are built on the first acquire() and reference counted; the unreferenced
+ *	ones are kept for reuse, and evicted least recently used first when the
+ *	cache exceeds its memory budget.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+class tess
+{
+	public:
+
+		//! Canonical shape parameters.
+		struct key {
+			uint32_t shape;						//!< Unit shape (mesh::kShape).
+			uint16_t slices, stacks;			//!< Tessellation.
+			int32_t param[4];					//!< Parameters, in 1/10000.
+			bool operator<(const key&) const;	//!< Ordering.
+			bool operator==(const key&) const;	//!< Equality.
+		};
+
+		// Special members.
+		tess(const size_t& budget = 16 << 20);	//!< Ctor, with the memory budget (bytes).
+		~tess();								//!< Dtor, releases the GL buffers.
+
+		// Keys.
+		static key make(const uint32_t& shape, const uint16_t& slices, const uint16_t& stacks, const float* param);
+		static void extent(const uint32_t& shape, float* lo, float* hi);	//!< Unit shape bounds.
+
+		// Meshes.
+		int32_t acquire(const key&);			//!< Retrieves (building it in case) a mesh.
+		void release(const int32_t&);			//!< Releases a mesh.
+		GLuint vbo(const int32_t&) const;		//!< Mesh vertex buffer.
+		GLuint ibo(const int32_t&) const;		//!< Mesh index buffer.
+		GLsizei count(const int32_t&) const;	//!< Mesh index count.
+
+		// Cache management.
+		void clear();							//!< Drops the unreferenced meshes.
+		size_t budget() const;					//!< Returns the memory budget.
+		void budget(const size_t&);				//!< Sets the memory budget.
+		size_t bytes() const;					//!< Memory used by the meshes.
+		size_t size() const;					//!< Number of meshes.
+
+	private:
+
+		// A cached mesh.
+		struct entry {
+			key k;								// Parameters.
+			GLuint vbo, ibo;					// GL buffers.
+			GLsizei count;						// Index count.
+			size_t bytes;						// GL memory.
+			uint32_t refs;						// References.
+			uint64_t stamp;						// Last use.
+		};
+
+		// Storage.
+		std::vector<entry> _entry;				// The meshes.
+		std::map<key, int32_t> _index;			// Meshes by parameters.
+		std::vector<int32_t> _free;				// Free entries.
+		size_t _budget;							// Memory budget.
+		size_t _bytes;							// Memory used.
+		uint64_t _clock;						// Use counter.
+
+		// Support functions.
+		void build(const key&, std::vector<vertex>&, std::vector<uint32_t>&) const;
+		void evict(const int32_t&);
+		void trim();
+};
+
+
+//! Batched scene renderer
+/*! A cat::gp::batch keeps the geometry of all the batchable GPs of a scene in
+ *	a few shared GL vertex/index buffers, one pair for every (material, part,
+ *	transparency) bucket. A GP geometry is written once, when the GP appears
+ *	or is modified (modeNeedRedraw), and every frame draws each bucket with a
+ *	single call. Modified GPs keeping the same vertex count are overwritten
+ *	in place; the others leave a hole, and the bucket is packed again when
+ *	holes exceed the live geometry. Only the changed buffer ranges are sent to
+ *	the GPU.
+ *	GPs which are many copies of the same shape (points, spheres, boxes,
+ *	tubes) are drawn instanced instead: one shared unit mesh (cat::gp::tess)
+ *	per (shape parameters, material, transparency) group, plus a per-instance
+ *	transform buffer of which only the changed instances are uploaded.
+ *	Heightfields (cat::gp::array) are drawn with one instanced call each, a
+ *	unit box per cell raised by the cell texel of the GP values texture: the
+ *	mesh carries just the grid placement and scaling.
+ *	The scene bounds of the written GPs are kept in a cat::gp::bvh, and the
+ *	drawing skips the GPs outside the view frustum: buckets draw only the
+ *	index ranges of the visible GPs (glMultiDrawElements), groups only the
+ *	visible instances: runs of them straight from the instance buffer, or,
+ *	if too scattered, a copy streamed again only when they change.
+ *	Tessellated GPs (spheres, tubes) get a level of detail from their
+ *	projected size, with some hysteresis, and are written again only when the
+ *	level changes.
+ *	The transparent GPs, batched or not, are drawn back to front in a single
+ *	order kept between frames by a cat::gp::depth, one call for every run of
+ *	GPs sharing a bucket or a group, so they blend right with each other.
+ *	The text of all the GPs shares a single glyph quads buffer, textured by
+ *	one glyph atlas (cat::gp::atlas), and is drawn with the transparent
+ *	geometry in one call: the glyphs are rendered once, and labels keeping
+ *	their text are never laid out again.
+ *	Picking casts a ray through the bvh, testing the GPs met against their
+ *	actual geometry (triangles, lines, instanced shapes) on the CPU.
+ *	GPs which do not implement glMesh() are left to the usual glDisplay(),
+ *	called by the batch itself for the transparent ones, in their order.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+class batch
+{
+	private:
+
+		// A bucket: geometry sharing material, part and transparency.
+		struct bucket {
+			GPHnd material;						// Material handle (0 = colors only).
+			uint32_t part;						// Mesh part.
+			bool alpha;							// Transparent geometry.
+			std::vector<vertex> vtx;			// Vertexes (CPU copy).
+			std::vector<uint32_t> idx;			// Indexes (CPU copy).
+			size_t holes;						// Vertexes no more used.
+			size_t vLo, vHi, iLo, iHi;			// Ranges to upload.
+			bool repack;						// Indexes to rebuild.
+			GLuint vao, vbo, ibo;				// GL objects.
+			size_t vCap, iCap;					// GL buffers capacity.
+			std::vector<GLsizei> rc;			// Visible ranges counts.
+			std::vector<const void*> ro;		// Visible ranges offsets.
+		};
+
+		// An instanced group: same shape, tessellation and transparency.
+		struct group {
+			tess::key key;						// Unit shape parameters.
+			int32_t mesh;						// Unit mesh in the cache (-1 = none).
+			GPHnd material;						// Material handle (0 = colors only).
+			bool alpha;							// Transparent instances.
+			std::vector<instance> inst;			// Instances (CPU copy).
+			std::vector<GPHnd> owner;			// Instances GP.
+			size_t lo, hi;						// Range to upload.
+			GLuint vao, ibuf;					// GL objects (vertex array and instances).
+			GLuint cbuf;						// GL visible instances buffer.
+			std::vector<uint32_t> seq;			// Instances in cbuf, by index.
+			bool stale;							// Instances changed since cbuf.
+			GLsizei count;						// Unit mesh indexes.
+			size_t cap;							// GL instance buffer capacity.
+			std::vector<uint32_t> sorted;		// Back to front instances (transparent only).
+		};
+
+		// A transparent drawing step: back to front GPs sharing a bucket or
+		// a group, or a GP left to glDisplay().
+		struct step {
+			int32_t bucket;						// Bucket (-1 = none).
+			int32_t group;						// Group (-1 = none).
+			GPHnd gp;							// GP to glDisplay() (0 = none).
+			uint32_t r0, rn;					// Ranges (bucket) or sorted instances (group).
+			int32_t field;						// Heightfield (-1 = none).
+		};
+
+		// Where a GP geometry lives, by part.
+		struct slot {
+			int32_t bucket[mesh::kPart::count];	// Bucket index (-1 = none).
+			uint32_t v0[mesh::kPart::count];	// First vertex.
+			uint32_t vn[mesh::kPart::count];	// Vertex count.
+			uint32_t i0[mesh::kPart::count];	// First index.
+			uint32_t in[mesh::kPart::count];	// Index count.
+			int32_t group;						// Instanced group (-1 = none).
+			uint32_t inst;						// Instance index in the group.
+			int32_t field;						// Heightfield (-1 = none).
+			uint32_t t0, tn;					// Glyph vertexes (first, count).
+			uint8_t level;						// Detail level.
+			bool detailed;						// GP uses the detail level.
+			bool batched;						// GP written by glMesh.
+			bool known;							// GP already seen.
+			uint64_t frameVer;					// Newest parent frame version written against.
+		};
+
+		// Storage.
+		std::vector<bucket> _bucket;			// The buckets.
+		std::vector<group> _group;				// The instanced groups.
+		std::vector<mesh::field> _field;		// The heightfields.
+		std::vector<GPHnd> _fOwner;				// Heightfields GP.
+		int32_t _fMesh;							// Heightfields cell mesh in the cache (-1 = none).
+		GLuint _fVao;							// Heightfields GL vertex array.
+		std::vector<slot> _slot;				// The slots, by GP handle.
+		std::vector<letter> _text;				// Glyph vertexes (CPU copy).
+		size_t _tHoles;							// Glyph vertexes no more used.
+		size_t _tLo, _tHi;						// Glyph range to upload.
+		size_t _tCap;							// GL glyph buffer capacity.
+		GLuint _tVao, _tVbo;					// GL glyph objects.
+		std::vector<GLint> _tFirst;				// Visible glyph ranges firsts.
+		std::vector<GLsizei> _tCount;			// Visible glyph ranges counts.
+		uint64_t _tGen;							// Atlas generation of the glyphs.
+		atlas _atlas;							// The glyphs.
+		mesh _mesh;								// Writing scratch.
+		tess _tess;								// Unit meshes.
+		bvh _bvh;								// The GPs scene bounds.
+		std::vector<uint8_t> _visible;			// Visible GPs, by handle.
+		std::vector<instance> _cinst;			// Visible instances scratch.
+		std::vector<uint32_t> _cseq;			// Visible instances indexes scratch.
+		depth _depth;							// Back to front transparent GPs.
+		std::vector<step> _step;				// Transparent drawing steps.
+		std::vector<GLsizei> _rc;				// Steps ranges counts.
+		std::vector<const void*> _ro;			// Steps ranges offsets.
+		bool _culled;							// Some GP is out of the view.
+		float _dotMax;							// Largest dot size (pixels).
+		scene* _scene;							// The scene in the buffers.
+
+		// Drawing.
+		GLuint _program;						// Shader program.
+		GLint _uMvp;							// Projection * modelview location.
+		GLint _uMv;								// Modelview location.
+		GLint _uLit;							// Lighting switch location.
+		GLint _uInst;							// Instancing switch location.
+		GLint _uField;							// Heightfield switch location.
+		GLint _uFCols;							// Heightfield columns location.
+		GLint _uFScale;							// Heightfield values scaling location.
+		GLint _uFPos;							// Heightfield corner location.
+		GLint _uFAx;							// Heightfield axes location.
+		GLint _uFCol;							// Heightfield color location.
+		GLint _uValues;							// Heightfield values sampler location.
+		GLuint _tProgram;						// Text shader program.
+		GLint _tMvp;							// Text projection * modelview location.
+		GLint _tView;							// Text viewport size location.
+		GLint _tAtlas;							// Text atlas sampler location.
+		bool _glFailed;							// Shaders did not compile.
+		size_t _calls;							// Draw calls of the last frame.
+
+		// Support functions.
+		int32_t bucketGet(const GPHnd&, const uint32_t&, const bool&);
+		void write(GP*, slot&);
+		void erase(slot&, const uint32_t&);
+		void textErase(slot&);
+		void textPack();
+		void textDraw(const float*);
+		int32_t groupGet(const mesh&);
+		void unlink(slot&);
+		void fieldErase(slot&);
+		void fieldDraw(const mesh::field&);
+		bool fieldHit(const GPHnd&, const mesh::field&, const double*, const double*, double&) const;
+		void unit(group&);
+		void bound(const GPHnd&);
+		void runs();
+		void sort(const float*);
+		void stream(group&, std::vector<uint32_t>&);
+		bool hit(const GPHnd&, const double*, const double*, const double*, double&) const;
+		void detail(const float*, const float&);
+		static void instAttrib(const GLuint&, const size_t& = 0);
+		void instDraw(const group&, const GLuint&, const uint32_t&, const uint32_t&);
+		void pack(bucket&);
+		void upload(bucket&);
+		bool glProgram();
+		static GLuint glLink(const char*, const char*, const char**, const GLuint&);
+
+	public:
+
+		// Special members.
+		batch();								//!< Default ctor.
+		~batch();								//!< Dtor, releases the GL objects.
+
+		// Scene synchronization.
+		void clear();							//!< Drops all the geometry.
+		void update(scene*);					//!< Writes the new/modified GPs.
+		bool batched(const GPHnd&) const;		//!< Whether a GP is drawn by the batch.
+		bool visible(const GPHnd&) const;		//!< Whether a GP passed the last culling.
+
+		// Picking.
+		GPHnd pick(const double* o, const double* d, const double* px, double& t,
+				   std::vector<GPHnd>* all = 0);	//!< Nearest GP along a ray.
+
+		// Drawing.
+		void glDraw(const double* mv, const double* prj, const bool& alpha);	//!< Draws opaque or transparent buckets.
+
+		// Tessellation cache.
+		tess& cache();							//!< The unit meshes cache.
+		atlas& font();							//!< The glyph atlas.
+
+		// Statistics.
+		size_t buckets() const;					//!< Number of buckets.
+		size_t calls() const;					//!< Draw calls of the last frame.
+		size_t vertexes() const;				//!< Vertexes stored.
+		size_t instances() const;				//!< Instances stored.
+		size_t glyphs() const;					//!< Glyph quads stored.
+};
+
+// #############################################################################
+}} // Close namespace
+
+// Overloading check
+#endif
@@ -14,9 +14,13 @@
 
 // Application components.
 #include "gpBox.h"
+#include "gpBatch.h"
 
 #include <glad.h>
 
+// Standard library.
+#include <cmath>
+
 // #############################################################################
 namespace cat { namespace gp {
 
@@ -176,6 +180,7 @@ box& box::trsf(const ge::ref& rf, const bool& inv)
 	 *	if inv = false, and by applying the inverse transformation if inv = true. 
 	 */
 	for (auto i = 0; i < 8; i++) rf.trsf(_vtx[i], inv);
+	modeNeedRedraw(true);
 	return *this;
 }	
 
@@ -353,6 +358,65 @@ void box::glDraw()
 	}
 }
 
+//______________________________________________________________________________
+bool box::glMesh(mesh& m)
+{
+	/*!	Writes the box into the batch mesh \c m: the six faces (same vertex
+	 *	order as in glDraw) for the filling, the twelve edges for the stroke.
+	 *	A box which is a parallelepiped is filled as an instance of the unit
+	 *	cube instead, transformed by its edges.
+	 */
+
+	// If not visible, nothing to write.
+	if (!modeVisible()) return true;
+
+	// Stroke outline.
+	if (_strkEnable) {
+		static const int edge[12][2] = { {0, 1}, {0, 3}, {0, 4}, {2, 1}, {2, 3}, {2, 6},
+										 {7, 3}, {7, 4}, {7, 6}, {5, 1}, {5, 4}, {5, 6} };
+		for (auto i = 0; i < 12; i++) m.segment(_vtx[edge[i][0]], _vtx[edge[i][1]], _strkColor);
+	}
+
+	// Solid filling.
+	if (_fillEnable) {
+		static const int face[6][4] = { {0, 4, 5, 1}, {3, 2, 6, 7}, {0, 3, 7, 4},
+										{1, 5, 6, 2}, {0, 1, 2, 3}, {4, 7, 6, 5} };
+		m.material = _fillMaterial;
+
+		// Parallelepiped: every vertex is the first one plus a sum of edges.
+		const ge::point& o = _vtx[0];
+		const double e[3][3] = { { _vtx[1].x() - o.x(), _vtx[1].y() - o.y(), _vtx[1].z() - o.z() },
+								 { _vtx[3].x() - o.x(), _vtx[3].y() - o.y(), _vtx[3].z() - o.z() },
+								 { _vtx[4].x() - o.x(), _vtx[4].y() - o.y(), _vtx[4].z() - o.z() } };
+		static const int sum[8][3] = { {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+									   {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1} };
+		double size = 0;
+		for (auto i = 0; i < 3; i++) size += std::fabs(e[i][0]) + std::fabs(e[i][1]) + std::fabs(e[i][2]);
+		bool prism = true;
+		for (auto i = 0; i < 8 && prism; i++) {
+			const double c[3] = { _vtx[i].x() - o.x(), _vtx[i].y() - o.y(), _vtx[i].z() - o.z() };
+			for (auto a = 0; a < 3; a++) {
+				const double d = sum[i][0] * e[0][a] + sum[i][1] * e[1][a] + sum[i][2] * e[2][a];
+				if (std::fabs(c[a] - d) > 1e-6 * (size + 1)) prism = false;
+			}
+		}
+		if (prism) {
+			ge::point ctr(o.x() + (e[0][0] + e[1][0] + e[2][0]) / 2,
+						  o.y() + (e[0][1] + e[1][1] + e[2][1]) / 2,
+						  o.z() + (e[0][2] + e[1][2] + e[2][2]) / 2);
+			const double ax[9] = { e[0][0], e[0][1], e[0][2], e[1][0], e[1][1], e[1][2], e[2][0], e[2][1], e[2][2] };
+			m.shaped(mesh::kShape::cube, ctr, ax, _fillColor);
+			return true;
+		}
+
+		// Generic box.
+		for (auto i = 0; i < 6; i++) {
+			m.quad(_vtx[face[i][0]], _vtx[face[i][1]], _vtx[face[i][2]], _vtx[face[i][3]], _fillColor);
+		}
+	}
+	return true;
+}
+
 //______________________________________________________________________________
 void box::glDrawEnd()
 {
@@ -76,6 +76,7 @@ class box: public filled
 			void glDraw();		//!< Draws the GP on the current GLContext.
 			void glDrawSel();	//!< Draws the GP in selection mode.
 			void glDrawEnd();	//!< Closes the GP drawing. Mandatory call!
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
 		#endif
 };
 
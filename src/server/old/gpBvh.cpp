@@ -0,0 +1,384 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives bounding volume hierarchy							  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpBvh.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application components.
+#include "gpBvh.h"
+
+// Standard library.
+#include <algorithm>
+#include <limits>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+
+// *****************************************************************************
+// **								Special members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+bvh::bvh()
+{
+	/*! bvh ctor, starts empty. */
+	clear();
+}
+
+//______________________________________________________________________________
+bvh::~bvh()
+{
+	/*! Releases all allocated resources. */
+}
+
+
+// *****************************************************************************
+// **								Private members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+int32_t bvh::build(const size_t& b, const size_t& e, const int32_t& parent)
+{
+	/* Builds the subtree of the GPs _hnd[b, e), splitting them at the median
+	 * of their centers along the longest axis. Returns the subtree root.
+	 */
+	const int32_t idx = (int32_t)_node.size();
+	_node.push_back(node());
+	_node[idx].parent = parent;
+	_node[idx].left = _node[idx].right = -1;
+	_node[idx].hnd = 0;
+
+	// Leaf.
+	if (e - b == 1) {
+		const GPHnd h = _hnd[b];
+		for (auto a = 0; a < 3; a++) {
+			_node[idx].lo[a] = _box[h * 6 + a];
+			_node[idx].hi[a] = _box[h * 6 + 3 + a];
+		}
+		_node[idx].hnd = h;
+		_leaf[h] = idx;
+		return idx;
+	}
+
+	// Split axis from the centers spread.
+	float clo[3], chi[3];
+	for (auto a = 0; a < 3; a++) {
+		clo[a] = std::numeric_limits<float>::max();
+		chi[a] = -std::numeric_limits<float>::max();
+	}
+	for (size_t i = b; i < e; i++) {
+		const float* bx = &_box[_hnd[i] * 6];
+		for (auto a = 0; a < 3; a++) {
+			const float c = bx[a] + bx[3 + a];
+			clo[a] = std::min(clo[a], c);
+			chi[a] = std::max(chi[a], c);
+		}
+	}
+	int axis = 0;
+	for (auto a = 1; a < 3; a++) if (chi[a] - clo[a] > chi[axis] - clo[axis]) axis = a;
+	const size_t mid = (b + e) / 2;
+	std::nth_element(_hnd.begin() + b, _hnd.begin() + mid, _hnd.begin() + e,
+		[this, axis](const GPHnd& x, const GPHnd& y) {
+			return _box[x * 6 + axis] + _box[x * 6 + 3 + axis] < _box[y * 6 + axis] + _box[y * 6 + 3 + axis];
+		});
+
+	// Children, then the bounds.
+	const int32_t l = build(b, mid, idx);
+	const int32_t r = build(mid, e, idx);
+	_node[idx].left = l;
+	_node[idx].right = r;
+	for (auto a = 0; a < 3; a++) {
+		_node[idx].lo[a] = std::min(_node[l].lo[a], _node[r].lo[a]);
+		_node[idx].hi[a] = std::max(_node[l].hi[a], _node[r].hi[a]);
+	}
+	return idx;
+}
+
+//______________________________________________________________________________
+void bvh::refit(int32_t n)
+{
+	/* Refits the node \c n and its ancestors to their children bounds,
+	 * stopping as soon as a node does not change.
+	 */
+	while (n >= 0) {
+		node& k = _node[n];
+		const node& l = _node[k.left];
+		const node& r = _node[k.right];
+		bool same = true;
+		for (auto a = 0; a < 3; a++) {
+			const float lo = std::min(l.lo[a], r.lo[a]);
+			const float hi = std::max(l.hi[a], r.hi[a]);
+			if (lo != k.lo[a] || hi != k.hi[a]) same = false;
+			k.lo[a] = lo;
+			k.hi[a] = hi;
+		}
+		if (same) return;
+		n = k.parent;
+	}
+}
+
+//______________________________________________________________________________
+void bvh::update()
+{
+	/* Rebuilds the tree if GPs have been added or removed. */
+	if (!_rebuild) return;
+	_hnd.clear();
+	const size_t n = _box.size() / 6;
+	for (size_t h = 0; h < n; h++) if (_box[h * 6] <= _box[h * 6 + 3]) _hnd.push_back(h);
+	_leaf.assign(n, -1);
+	_node.clear();
+	_node.reserve(2 * _hnd.size());
+	_root = _hnd.empty() ? -1 : build(0, _hnd.size(), -1);
+	_rebuild = false;
+}
+
+
+// *****************************************************************************
+// **								Public members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void bvh::clear()
+{
+	/*! Drops all the GPs. */
+	_node.clear();
+	_leaf.clear();
+	_box.clear();
+	_hnd.clear();
+	_root = -1;
+	_count = 0;
+	_rebuild = false;
+}
+
+//______________________________________________________________________________
+void bvh::set(const GPHnd& hnd, const float* lo, const float* hi)
+{
+	/*! Sets the scene bounds \c lo, \c hi of the GP \c hnd. A GP already in
+	 *	the tree is refitted, a new one is added by the next rebuild.
+	 */
+	// New handles start without bounds (lo > hi).
+	const size_t n = _box.size() / 6;
+	if (hnd >= n) {
+		_box.resize((hnd + 1) * 6, 0);
+		_leaf.resize(hnd + 1, -1);
+		for (size_t h = n; h <= hnd; h++) {
+			_box[h * 6] = 1;
+			_box[h * 6 + 3] = 0;
+		}
+	}
+	const bool had = has(hnd);
+	for (auto a = 0; a < 3; a++) {
+		_box[hnd * 6 + a] = lo[a];
+		_box[hnd * 6 + 3 + a] = hi[a];
+	}
+	if (had != has(hnd)) {
+		if (had) _count--;
+		else _count++;
+	}
+	if (had && !_rebuild && _leaf[hnd] >= 0) {
+		node& k = _node[_leaf[hnd]];
+		for (auto a = 0; a < 3; a++) {
+			k.lo[a] = lo[a];
+			k.hi[a] = hi[a];
+		}
+		refit(k.parent);
+	} else {
+		_rebuild = true;
+	}
+}
+
+//______________________________________________________________________________
+void bvh::remove(const GPHnd& hnd)
+{
+	/*! Removes the GP \c hnd from the tree. */
+	if (!has(hnd)) return;
+	_box[hnd * 6] = 1;
+	_box[hnd * 6 + 3] = 0;
+	_count--;
+	_rebuild = true;
+}
+
+//______________________________________________________________________________
+bool bvh::has(const GPHnd& hnd) const
+{
+	/*! Returns true if the GP \c hnd has bounds in the tree. */
+	return hnd < _box.size() / 6 && _box[hnd * 6] <= _box[hnd * 6 + 3];
+}
+
+//______________________________________________________________________________
+bool bvh::box(const GPHnd& hnd, float* lo, float* hi) const
+{
+	/*! Copies the bounds of the GP \c hnd into \c lo, \c hi. Returns false
+	 *	if the GP has no bounds in the tree.
+	 */
+	if (!has(hnd)) return false;
+	for (auto a = 0; a < 3; a++) {
+		lo[a] = _box[hnd * 6 + a];
+		hi[a] = _box[hnd * 6 + 3 + a];
+	}
+	return true;
+}
+
+//______________________________________________________________________________
+size_t bvh::size() const
+{
+	/*! Returns the number of GPs in the tree. */
+	return _count;
+}
+
+//______________________________________________________________________________
+size_t bvh::cull(const float* mvp, std::vector<uint8_t>& vis)
+{
+	/*! Sets vis[h] = 1 for every GP h whose bounds are (at least partly)
+	 *	inside the frustum of the column-major projection * modelview matrix
+	 *	\c mvp, 0 for the others. Returns the number of flagged GPs. Subtrees
+	 *	fully inside the frustum are flagged without testing their children.
+	 */
+	update();
+	vis.assign(_box.size() / 6, 0);
+	if (_root < 0) return 0;
+
+	// Frustum planes (left, right, bottom, top, near, far) from the rows.
+	float pl[6][4];
+	for (auto p = 0; p < 6; p++) {
+		const int row = p / 2;
+		const float sgn = (p % 2) ? -1.0f : 1.0f;
+		for (auto c = 0; c < 4; c++) pl[p][c] = mvp[c * 4 + 3] + sgn * mvp[c * 4 + row];
+	}
+
+	// Traversal. The mask keeps the planes still to be tested.
+	size_t count = 0;
+	std::vector<std::pair<int32_t, uint8_t>> stack;
+	stack.push_back({ _root, 0x3F });
+	while (!stack.empty()) {
+		const int32_t n = stack.back().first;
+		uint8_t mask = stack.back().second;
+		stack.pop_back();
+		const node& k = _node[n];
+		if (k.lo[0] > k.hi[0]) continue;
+
+		// Plane tests: outside if the farthest corner along the plane normal
+		// is behind it, inside if the nearest one is in front.
+		bool out = false;
+		for (auto p = 0; p < 6 && !out; p++) {
+			if (!(mask & (1 << p))) continue;
+			float far = pl[p][3], near = pl[p][3];
+			for (auto a = 0; a < 3; a++) {
+				far += pl[p][a] * (pl[p][a] >= 0 ? k.hi[a] : k.lo[a]);
+				near += pl[p][a] * (pl[p][a] >= 0 ? k.lo[a] : k.hi[a]);
+			}
+			if (far < 0) out = true;
+			else if (near >= 0) mask &= ~(1 << p);
+		}
+		if (out) continue;
+
+		// Leaf, or inner node to be opened.
+		if (k.left < 0) {
+			vis[k.hnd] = 1;
+			count++;
+		} else {
+			stack.push_back({ k.left, mask });
+			stack.push_back({ k.right, mask });
+		}
+	}
+	return count;
+}
+
+//______________________________________________________________________________
+GPHnd bvh::ray(const float* o, const float* d, const float* m, float& t,
+			   const std::function<bool(const GPHnd&, float&)>& test)
+{
+	/*! Casts the ray o + s * d, 0 <= s <= \c t, and returns the GP with the
+	 *	nearest hit (0 if none), setting \c t to it. The boxes are widened by
+	 *	the margin m[0] + m[1] * s, so that thin GPs (lines, points) can be
+	 *	hit within some pixels. \c test(h, s) is called for the GPs whose
+	 *	box is crossed, nearest box first: it must return true if the GP \c h
+	 *	is actually hit before \c s, setting \c s to the hit. Subtrees beyond
+	 *	the nearest hit are skipped.
+	 */
+	update();
+	if (_root < 0) return 0;
+
+	// Entry along the ray into the node box, widened by the margin at the
+	// farthest useful distance: first the current limit, then the box exit.
+	auto enter = [&](const node& k, float& s) {
+		float lo = 0, hi = t;
+		for (auto pass = 0; pass < 2; pass++) {
+			const float w = m[0] + m[1] * hi;
+			float s0 = 0, s1 = t;
+			for (auto a = 0; a < 3; a++) {
+				const float bl = k.lo[a] - w, bh = k.hi[a] + w;
+				if (d[a] == 0) {
+					if (o[a] < bl || o[a] > bh) return false;
+					continue;
+				}
+				float ta = (bl - o[a]) / d[a], tb = (bh - o[a]) / d[a];
+				if (ta > tb) std::swap(ta, tb);
+				s0 = std::max(s0, ta);
+				s1 = std::min(s1, tb);
+				if (s0 > s1) return false;
+			}
+			lo = s0;
+			hi = s1;
+		}
+		s = lo;
+		return true;
+	};
+
+	// Traversal, nearest child on top of the stack.
+	GPHnd best = 0;
+	float s = 0;
+	std::vector<std::pair<int32_t, float>> stack;
+	if (enter(_node[_root], s)) stack.push_back({ _root, s });
+	while (!stack.empty()) {
+		const int32_t n = stack.back().first;
+		const float sn = stack.back().second;
+		stack.pop_back();
+		if (sn > t) continue;
+		const node& k = _node[n];
+		if (k.lo[0] > k.hi[0]) continue;
+
+		// Leaf: exact test.
+		if (k.left < 0) {
+			float sh = t;
+			if (test(k.hnd, sh) && sh <= t) {
+				t = sh;
+				best = k.hnd;
+			}
+			continue;
+		}
+
+		// Children.
+		float sl = 0, sr = 0;
+		const bool l = enter(_node[k.left], sl);
+		const bool r = enter(_node[k.right], sr);
+		if (l && r) {
+			if (sl <= sr) {
+				stack.push_back({ k.right, sr });
+				stack.push_back({ k.left, sl });
+			} else {
+				stack.push_back({ k.left, sl });
+				stack.push_back({ k.right, sr });
+			}
+		} else if (l) {
+			stack.push_back({ k.left, sl });
+		} else if (r) {
+			stack.push_back({ k.right, sr });
+		}
+	}
+	return best;
+}
+
+// #############################################################################
+}} // Close namespace
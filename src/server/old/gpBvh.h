@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives bounding volume hierarchy							  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpBvh.h"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"c++"
+//______________________________________________________________________________
+
+// Overloading check
+#if !defined gpBvh_H
+#define gpBvh_H
+
+// Application components.
+#include "gp.h"
+
+// Standard library.
+#include <functional>
+#include <vector>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+//! GP bounding volume hierarchy
+/*! A cat::gp::bvh is a binary tree of axis aligned boxes over the scene
+ *	coordinates bounds of the GPs, its leaves indexed by GP handle. Moving a
+ *	GP refits the boxes of its leaf ancestors only; adding or removing GPs
+ *	marks the tree for a full (median split) rebuild, done lazily by the next
+ *	query. The frustum culling flags the GPs which may be visible through a
+ *	projection * modelview matrix, skipping whole subtrees outside it. The
+ *	ray casting visits the leaves along a ray nearest first, leaving the
+ *	exact test of every GP to the caller, and skips the subtrees beyond the
+ *	nearest hit found so far.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+class bvh
+{
+	private:
+
+		// A tree node. Leaves have no children and a GP handle.
+		struct node {
+			float lo[3], hi[3];					// Bounds.
+			int32_t left, right;				// Children (-1 = leaf).
+			int32_t parent;						// Parent (-1 = root).
+			GPHnd hnd;							// Leaf GP.
+		};
+
+		// Storage.
+		std::vector<node> _node;				// The tree nodes.
+		std::vector<int32_t> _leaf;				// Leaf node by GP handle (-1 = none).
+		std::vector<float> _box;				// GP bounds by handle (6 floats).
+		std::vector<GPHnd> _hnd;				// Build scratch.
+		int32_t _root;							// Root node (-1 = empty).
+		size_t _count;							// GPs with bounds.
+		bool _rebuild;							// Tree to be rebuilt.
+
+		// Support functions.
+		int32_t build(const size_t&, const size_t&, const int32_t&);
+		void refit(int32_t);
+		void update();
+
+	public:
+
+		// Special members.
+		bvh();									//!< Default ctor.
+		~bvh();									//!< Dtor.
+
+		// Content.
+		void clear();							//!< Drops all the GPs.
+		void set(const GPHnd&, const float* lo, const float* hi);	//!< Adds or moves a GP.
+		void remove(const GPHnd&);				//!< Removes a GP.
+		bool has(const GPHnd&) const;			//!< Whether a GP is in the tree.
+		bool box(const GPHnd&, float* lo, float* hi) const;	//!< Retrieves a GP bounds.
+		size_t size() const;					//!< Number of GPs.
+
+		// Queries.
+		size_t cull(const float* mvp, std::vector<uint8_t>& vis);	//!< Flags the GPs inside a frustum.
+		GPHnd ray(const float* o, const float* d, const float* m, float& t,
+				  const std::function<bool(const GPHnd&, float&)>& test);	//!< Nearest GP along a ray.
+};
+
+// #############################################################################
+}} // Close namespace
+
+// Overloading check
+#endif
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives depth ordering									  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpDepth.cpp"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"C++"
+//______________________________________________________________________________
+
+
+// Application components.
+#include "gpDepth.h"
+
+// Standard library.
+#include <algorithm>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+
+// *****************************************************************************
+// **								Special members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+depth::depth()
+{
+	/*! depth ctor, starts empty. */
+	clear();
+}
+
+//______________________________________________________________________________
+depth::~depth()
+{
+	/*! Releases all allocated resources. */
+}
+
+
+// *****************************************************************************
+// **								Public members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void depth::clear()
+{
+	/*! Drops all the GPs and their order. */
+	_order.clear();
+	_added.clear();
+	_dist.clear();
+	_stamp.clear();
+	_listed.clear();
+	_frame = 0;
+	_moves = 0;
+	_full = false;
+}
+
+//______________________________________________________________________________
+void depth::begin()
+{
+	/*! Starts a new frame: the GPs to be sorted must be given again through
+	 *	set(), the ones not given are dropped by end().
+	 */
+	_frame++;
+	_added.clear();
+}
+
+//______________________________________________________________________________
+void depth::set(const GPHnd& hnd, const float& dist)
+{
+	/*! Gives the GP \c hnd for the current frame, at the view distance
+	 *	\c dist (larger is farther).
+	 */
+	if (hnd >= _dist.size()) {
+		_dist.resize(hnd + 1, 0);
+		_stamp.resize(hnd + 1, 0);
+		_listed.resize(hnd + 1, 0);
+	}
+	if (_stamp[hnd] != _frame && !_listed[hnd]) _added.push_back(hnd);
+	_dist[hnd] = dist;
+	_stamp[hnd] = _frame;
+}
+
+//______________________________________________________________________________
+const std::vector<GPHnd>& depth::end()
+{
+	/*! Sorts the GPs given in the current frame back to front, starting from
+	 *	the previous frame order, and returns them. The new GPs are appended
+	 *	before sorting, the ones not given anymore dropped.
+	 */
+	// Previous order, without the dropped GPs, then the new ones.
+	size_t n = 0;
+	for (size_t i = 0; i < _order.size(); i++) {
+		const GPHnd h = _order[i];
+		if (_stamp[h] == _frame) _order[n++] = h;
+		else _listed[h] = 0;
+	}
+	_order.resize(n);
+	for (auto h : _added) {
+		_order.push_back(h);
+		_listed[h] = 1;
+	}
+	_added.clear();
+
+	// Insertion sort, farthest first, within a linear moves budget.
+	const size_t budget = 8 * _order.size() + 64;
+	_moves = 0;
+	_full = false;
+	for (size_t i = 1; i < _order.size() && !_full; i++) {
+		const GPHnd h = _order[i];
+		const float d = _dist[h];
+		size_t j = i;
+		while (j > 0 && _dist[_order[j - 1]] < d) {
+			_order[j] = _order[j - 1];
+			j--;
+			if (++_moves > budget) {
+				_full = true;
+				break;
+			}
+		}
+		_order[j] = h;
+	}
+
+	// Too scrambled: full sort.
+	if (_full) {
+		std::stable_sort(_order.begin(), _order.end(),
+			[this](const GPHnd& a, const GPHnd& b) { return _dist[a] > _dist[b]; });
+	}
+	return _order;
+}
+
+//______________________________________________________________________________
+const std::vector<GPHnd>& depth::order() const
+{
+	/*! Returns the GPs as sorted by the last end(). */
+	return _order;
+}
+
+//______________________________________________________________________________
+size_t depth::moves() const
+{
+	/*! Returns the number of moves done by the last insertion sort. */
+	return _moves;
+}
+
+//______________________________________________________________________________
+bool depth::full() const
+{
+	/*! Returns true if the last end() had to do a full sort. */
+	return _full;
+}
+
+// #############################################################################
+}} // Close namespace
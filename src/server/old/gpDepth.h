@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// CAT Graphic Primitives depth ordering									  --
+// (C) Piero Giubilato 2011-2026, Padova University							  --
+//------------------------------------------------------------------------------
+
+//______________________________________________________________________________
+// [File name]		"gpDepth.h"
+// [Author]			"Piero Giubilato"
+// [Version]		"1.0"
+// [Modified by]	"Piero Giubilato"
+// [Date]			"19 Oct 2026"
+// [Language]		"c++"
+//______________________________________________________________________________
+
+// Overloading check
+#if !defined gpDepth_H
+#define gpDepth_H
+
+// Application components.
+#include "gp.h"
+
+// Standard library.
+#include <vector>
+
+
+// #############################################################################
+namespace cat { namespace gp {
+
+//! GP depth ordering
+/*! A cat::gp::depth keeps a set of GPs sorted back to front, for the drawing
+ *	of the transparent ones. The order persists between frames: every frame
+ *	the GPs are given again with their current view distance, and the
+ *	previous order is fixed by an insertion sort, which is about linear when
+ *	the view moved just a little. Should the order be scrambled (a big view
+ *	change), the insertion sort gives up after a linear number of moves and a
+ *	full sort is done instead.
+ *
+ *	\author Piero Giubilato
+ *	\version 1.0
+ *	\date 19 Oct 2026
+ */
+class depth
+{
+	private:
+
+		// Storage.
+		std::vector<GPHnd> _order;				// The GPs, back to front.
+		std::vector<GPHnd> _added;				// GPs new in this frame.
+		std::vector<float> _dist;				// Distance by GP handle.
+		std::vector<uint32_t> _stamp;			// Last frame by GP handle.
+		std::vector<uint8_t> _listed;			// Whether in _order, by GP handle.
+		uint32_t _frame;						// Frame counter.
+		size_t _moves;							// Last sorting moves.
+		bool _full;								// Last sorting was a full one.
+
+	public:
+
+		// Special members.
+		depth();								//!< Default ctor.
+		~depth();								//!< Dtor.
+
+		// Ordering.
+		void clear();							//!< Drops all the GPs.
+		void begin();							//!< Starts a new frame.
+		void set(const GPHnd&, const float& dist);	//!< Gives a GP of the frame.
+		const std::vector<GPHnd>& end();		//!< Sorts the frame GPs, back to front.
+		const std::vector<GPHnd>& order() const;	//!< The last sorted GPs.
+
+		// Statistics.
+		size_t moves() const;					//!< Moves done by the last sorting.
+		bool full() const;						//!< Whether the last sorting was a full one.
+};
+
+// #############################################################################
+}} // Close namespace
+
+// Overloading check
+#endif
@@ -20,6 +20,9 @@
 // #############################################################################
 namespace cat { namespace gp {
 
+// Last reference version given out.
+uint64_t frame::_trsfLast = 0;
+
 
 // *****************************************************************************
 // **								Special members							  **
@@ -35,6 +38,7 @@ frame::frame()
 	
 	// Reset the reference.
 	_ref;
+	trsfTouch();
 }
 
 //______________________________________________________________________________
@@ -46,6 +50,7 @@ frame::frame(const ge::point& p0, const ge::vector& a0)
 	// Set inner reference.
 	_ref.p0(p0);
 	_ref.a0(a0); 
+	trsfTouch();
 }
 
 //______________________________________________________________________________
@@ -57,6 +62,7 @@ frame::frame(const ge::point& p0, const ge::vector& v0, const double& a)
 	// Set inner reference.
 	_ref.p0(p0);
 	_ref.v0(v0, a); 
+	trsfTouch();
 }
 
 	
@@ -124,6 +130,7 @@ bool frame::stream(std::stringstream& o, const bool& read)
 		
 	// Streams the vertexes
 	_ref.stream(o, read);
+	if (read) trsfTouch();
 	
 	// Everything fine.
 	return false;
@@ -136,6 +143,7 @@ frame& frame::trsf(const ge::ref& rf, const bool& inv)
 	 *	if inv = false, and by applying the inverse transformation if inv = true. 
 	 */
 	//for (auto i = 0; i < 8; i++) rf.trsf(_vtx[i], inv);
+	trsfTouch();
 	
 	return *this;
 }	
@@ -152,6 +160,30 @@ ge::ref frame::ref() const
 	return _ref;
 }
 
+//______________________________________________________________________________
+uint64_t frame::trsfVersion() const
+{
+	/*! Returns the reference version. It changes, and only grows, whenever
+	 *	the reference is set, so that the users of the frame can tell whether
+	 *	it has moved since they last looked at it.
+	 */
+	return _trsfVer;
+}
+
+
+// *****************************************************************************
+// **								Private members							  **
+// *****************************************************************************
+
+//______________________________________________________________________________
+void frame::trsfTouch()
+{
+	/* Gives the reference a new version, larger than all the previous ones
+	 * of every frame.
+	 */
+	_trsfVer = ++_trsfLast;
+}
+
 
 
 // *****************************************************************************
@@ -211,6 +243,17 @@ void frame::glTrsfReset()
 	GP::glTrsfReset();
 }
 
+//______________________________________________________________________________
+void frame::glWorld(ge::point& p)
+{
+	/*! The batched counterpart of glTrsfApply: moves the point \c p from the
+	 *	frame reference to the parent one, then lets the family chain carry it
+	 *	up to the scene.
+	 */
+	p = _ref.toXYZ(p);
+	GP::glWorld(p);
+}
+
 //______________________________________________________________________________
 void frame::glDrawSel()
 {
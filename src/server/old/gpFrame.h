@@ -40,6 +40,11 @@ class frame: public GP
 	
 		// The reference.
 		ge::ref _ref;
+
+		// Reference version, to spot the moved frames.
+		uint64_t _trsfVer;
+		static uint64_t _trsfLast;
+		void trsfTouch();
 	      
 	protected:
 	
@@ -69,6 +74,7 @@ class frame: public GP
 
 		// Provide Access to the internal Reference Components.
 		ge::ref ref() const;	// Returns the internal reference.
+		uint64_t trsfVersion() const;	//!< Changes whenever the reference changes.
 
 		// Drawing functions are ONLY defined for the SERVER side!
 		#ifdef CAT_SERVER
@@ -77,6 +83,7 @@ class frame: public GP
 			void glDrawEnd();		//!< Closes the GP drawing. Mandatory call!
 			void glTrsfApply();		//!< Apply (push) the gp Ref (hierarchical) transformation.
 			void glTrsfReset();		//!< Reset (pop) the gp Ref (hierarchical) transformation.
+			void glWorld(ge::point&);	//!< Moves a point through the (hierarchical) transformations.
 		#endif
 };
 
@@ -19,6 +19,8 @@
 #ifdef CAT_SERVER
 	#include "acMain.h"
 	#include "afFont.h"	
+	#include "gpBatch.h"
+	#include <cmath>
 #endif
 
 
@@ -53,11 +55,10 @@ label::label()
 	_rotation = 0;
 	_view2D = true;
 
-	// The generated pixMap.
+	// The text layout.
 	#ifdef CAT_SERVER
-		_pxmData = 0;
-		_pxmWidth = 0;
-		_pxmHeight = 0;
+		_lytGen = 0;
+		_lytSize[0] = _lytSize[1] = 0;
 	#endif
 }
 
@@ -88,11 +89,10 @@ label::label(const std::string& text,
 	_rotation = static_cast<float>(rotation);
 	_view2D = view2D;
 
-	// The generated pixMap.
+	// The text layout.
 	#ifdef CAT_SERVER
-		_pxmData = 0;
-		_pxmWidth = 0;
-		_pxmHeight = 0;
+		_lytGen = 0;
+		_lytSize[0] = _lytSize[1] = 0;
 	#endif
 }
 
@@ -100,11 +100,6 @@ label::label(const std::string& text,
 label::~label()
 {
 	/*! Destructor	*/
-	
-	// The generated pixMap.
-	#ifdef CAT_SERVER
-		delete[] _pxmData;
-	#endif	
 } 
 	
 // *****************************************************************************
@@ -144,7 +139,7 @@ size_t label::size(const bool& dynamic) const
 	// Get dynamically allocated size.
 	size_t tSize = stroked::size(true);
 	#ifdef CAT_SERVER
-		tSize += sizeof(*_pxmData)* _pxmWidth *_pxmHeight;	// Pixmap size.
+		tSize += sizeof(quad) * _lyt.capacity() + _lytKey.capacity();	// Layout size.
 	#endif
 	
 	// Returns.
@@ -170,30 +165,11 @@ void label::dump(const int& ind) const
 		<< "Rotation: " << CLW << _rotation << CD << ", "
 		<< "View 2D: " << CLW << _view2D << CD << "]\n";
 
-	// Display a map of the label if on SERVER side.
+	// Display the layout of the label if on SERVER side.
 	#ifdef CAT_SERVER
-
-		// Check if a map is available.
-		if (!_pxmData) return;
-
-		// Assign pivots.
-		unsigned int max = 255;
-		unsigned char symbol[7] = {250, 58, 176, 177, 178, 219, 232};	
-		char brush = ' ';
-		//std::cout << pad3 << "[" << COL(LWHITE) << "Map" << COL(DEFAULT) << "]\n";
-		
-		// Loop over all the data point of the pivot layer.
-		for (auto r = 0; r < _pxmHeight; r++) {
-			std::cout << pad3 << COL(BLACK + BG * WHITE);
-			for (auto c = 0; c < _pxmWidth; c++) {
-				auto p = _pxmData[((_pxmHeight - r - 1) * _pxmWidth + c) * 4 + 3];
-				p ? brush = (symbol[(unsigned int)((float)p / max * 5)]) : brush = ' ';
-				std::cout << brush;
-			}
-			std::cout << COL(DEFAULT + BG * BLACK) << "\n";
-		}
-				
-	// Server side IF.
+		std::cout << pad3 << "Layout ["
+			<< "Glyphs: " << CLW << _lyt.size() << CD << ", "
+			<< "Size: " << CLW << _lytSize[0] << " x " << _lytSize[1] << CD << "]\n";
 	#endif
 
 	// Clear definitions.
@@ -262,8 +238,8 @@ ge::point label::vtx(const int& idx) const
 //______________________________________________________________________________
 double label::glAlpha()
 {
-	/*! Overloaded from GP. As a label is actually a pixmap, it is always a 
-	 *	item, so fix this output to true.
+	/*! Overloaded from GP. The label glyphs are blended by the batch text
+	 *	pass anyway, so fix this output to 0.
 	 */
 	return 0;
 }
@@ -281,20 +257,15 @@ void label::glDrawSel()
 }
 
 //______________________________________________________________________________
-void label::glDraw()
+void label::layout(atlas& a)
 {
-	/*!	Draws a label object. */
-		
-	// Common drawing properties are handled by the parent.
-	stroked::glDraw(); 
+	/*	Lays the text out into glyph quads of the atlas \c a, aligned and
+	 *	rotated around the anchor. Nothing is done if neither the text and its
+	 *	properties nor the atlas generation changed since the last layout. If
+	 *	the atlas moves its glyphs while laying out, the text is laid out once
+	 *	more.
+	 */
 
-	// If not visible, bye bye.
-	if (!modeVisible()) return;
-		
-	// Get a string for the text, and a pointer to an array of color.
-	std::string text = _text;	// The string with all control sequences.
-	std::vector<uint32_t> color;	// The array containing the char color.
-	
 	// Get the starting color for the text.
 	uint32_t defaultCol = 0;
 	defaultCol = ((uint32_t)(_strkColor[0] * 255)) << 24;		// Red.
@@ -302,42 +273,104 @@ void label::glDraw()
 	defaultCol += ((uint32_t)(_strkColor[2] * 255)) << 8;		// Blue.
 	defaultCol += ((uint32_t)(_strkColor[3] * 255)) << 0;		// Alpha.
 
+	// Already laid out?
+	const std::string key = _text + '\n' + _fontFamily + '\n' + _fontStyle + '\n'
+		+ std::to_string(_fontSize) + ' ' + std::to_string(defaultCol) + ' '
+		+ std::to_string(_alignment) + ' ' + std::to_string(_rotation);
+	if (key == _lytKey && a.generation() == _lytGen) return;
+	_lytKey = key;
+
 	// Analyze label text to search for special control sequences ('//' style),
-	// Assigning the per-character color array.	
-	cat::af::_font->textParse(text, color, defaultCol);
-
-	// Prepares the text pixmap. The text routines sets the size for the map.
-	cat::af::_font->textFont(_fontFamily, _fontStyle, _fontSize, _rotation);  
-	cat::af::_font->textDraw(text, color, _pxmWidth, _pxmHeight, _pxmData);  
-
-	// Stroke outline.
-	if (_strkEnable) {
-			
-		// Set data alignment at 64 bit.
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
-		
-		// Set label position, 2D style respect the center.
-		if (_view2D) {
-//			glRasterPos3f(0, 0, 0);
-//			glBitmap(0, 0, 0, 0, _vtx[0].X(), _vtx[0].Y(), NULL); 
-			
-		// Set label position, 3D derived from the anchor point.
-		} else {
-//			glRasterPos3f(_vtx[0].X(), _vtx[0].Y(), _vtx[0].Z());
+	// Assigning the per-character color array.
+	std::string text = _text;
+	std::vector<uint32_t> color;
+	if (cat::af::_font) cat::af::_font->textParse(text, color, defaultCol);
+
+	// Lay the glyphs along the baseline, a line down for every line feed.
+	float lo[2] = { 0, 0 }, hi[2] = { 0, 0 };
+	for (auto pass = 0; pass < 2; pass++) {
+		_lytGen = a.generation();
+		const uint32_t face = a.face(_fontFamily, _fontStyle, _fontSize);
+		float pen[2] = { 0, 0 };
+		bool any = false;
+		_lyt.clear();
+		for (size_t i = 0; i < text.size(); i++) {
+			const uint8_t c = (uint8_t)text[i];
+			if (c == 10) {
+				pen[0] = 0;
+				pen[1] -= a.lineHeight(face);
+				continue;
+			}
+			if (c < 32) continue;
+			const atlas::glyph& g = a.get(face, c);
+			if (g.width && g.height) {
+				const float x0 = pen[0] + g.left, y1 = pen[1] + g.top;
+				const float x1 = x0 + g.width, y0 = y1 - g.height;
+				const uint32_t cc = i < color.size() ? color[i] : defaultCol;
+				const float col[4] = { (cc >> 24) / 255.0f, ((cc >> 16) & 255) / 255.0f,
+									   ((cc >> 8) & 255) / 255.0f, (cc & 255) / 255.0f };
+				quad q = { { x0, y0, x1, y0, x1, y1, x0, y1 },
+						   { g.uv[0], g.uv[1], g.uv[2], g.uv[3] }, mesh::rgba(col) };
+				_lyt.push_back(q);
+				lo[0] = any ? std::min(lo[0], x0) : x0;
+				lo[1] = any ? std::min(lo[1], y0) : y0;
+				hi[0] = any ? std::max(hi[0], x1) : x1;
+				hi[1] = any ? std::max(hi[1], y1) : y1;
+				any = true;
+			}
+			pen[0] += g.advance;
 		}
+		if (a.generation() == _lytGen) break;
+	}
 
-		// Adds the offset to correctly align the label to the anchor point.
-		cat::gp::GPDim dim;
-		dim.x = (float)_pxmWidth;
-		dim.y = (float)_pxmHeight;
-		GPPos off = offset(dim, _alignment);
-//		glBitmap(0, 0, 0, 0, off.x, -off.y, NULL); 
-
-		// Actually draw the label pixmap.
-//		glDrawPixels(_pxmWidth, _pxmHeight, GL_RGBA, GL_UNSIGNED_BYTE, _pxmData);
+	// Adds the offset to correctly align the label to the anchor point, then
+	// rotates it around the anchor.
+	cat::gp::GPDim dim;
+	dim.x = _lytSize[0] = hi[0] - lo[0];
+	dim.y = _lytSize[1] = hi[1] - lo[1];
+	dim.z = 0;
+	GPPos off = offset(dim, _alignment);
+	const float dx = off.x - lo[0], dy = -off.y - lo[1];
+	const float cs = std::cos(_rotation), sn = std::sin(_rotation);
+	for (auto& q : _lyt) {
+		for (auto k = 0; k < 4; k++) {
+			const float x = q.xy[2 * k] + dx, y = q.xy[2 * k + 1] + dy;
+			q.xy[2 * k] = x * cs - y * sn;
+			q.xy[2 * k + 1] = x * sn + y * cs;
+		}
 	}
 }
 
+//______________________________________________________________________________
+bool label::glMesh(mesh& m)
+{
+	/*!	Writes the label text into the batch mesh \c m, as glyph quads of the
+	 *	batch atlas anchored to the first vertex, or to the viewport pixels if
+	 *	the label is 2D. The text keeps its pixel size whatever the view. The
+	 *	layout is cached, so an unchanged label costs just the copy of its
+	 *	quads.
+	 */
+
+	// If not visible, nothing to write.
+	if (!modeVisible() || !_strkEnable || !m.font) return true;
+
+	// The glyph quads.
+	layout(*m.font);
+	for (auto& q : _lyt) m.glyph(_vtx[0], _view2D, q.xy, q.uv, q.rgba);
+	return true;
+}
+
+//______________________________________________________________________________
+void label::glDraw()
+{
+	/*!	Draws a label object. The text itself is drawn by the batch, with all
+	 *	the other labels, from the glyph atlas (see glMesh()).
+	 */
+		
+	// Common drawing properties are handled by the parent.
+	stroked::glDraw(); 
+}
+
 //______________________________________________________________________________
 void label::glDrawEnd()
 {
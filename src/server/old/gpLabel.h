@@ -43,11 +43,18 @@ class label: public fonted
 		// The plain text.
 		std::string _text;			// Text contained into the label.
 		
-		// The generated pixMap.
+		// The text layout, as glyph quads of the batch atlas.
 		#ifdef CAT_SERVER
-			uint8_t* _pxmData;		// The actual data (an RGBA array).
-			uint32_t _pxmWidth;		// Width of the array (pixels).
-			uint32_t _pxmHeight;	// Height of the array (pixels).
+			struct quad {
+				float xy[8];		// Corners offsets from the anchor (pixels).
+				float uv[4];		// Atlas box.
+				uint32_t rgba;		// Packed color.
+			};
+			std::vector<quad> _lyt;	// The glyph quads.
+			std::string _lytKey;	// Text, font, color, alignment and rotation laid out.
+			uint64_t _lytGen;		// Atlas generation of the layout.
+			float _lytSize[2];		// Layout width and height (pixels).
+			void layout(atlas&);	// Lays out the text.
 		#endif
 
 	protected:
@@ -94,6 +101,7 @@ class label: public fonted
 			void glDrawSel();	//!< Highlight the GP.
 			void glDrawEnd();	//!< Close the GP drawing. Mandatory call!
 			double glAlpha();	//!< Overloaded from GP.
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
 
 			// UI interaction.	
 //			void uiBarLoad(ui::Bar&);			//!< Load the GP properties bar.
@@ -15,6 +15,7 @@
 
 // Application components.
 #include "gpLine.h"
+#include "gpBatch.h"
 
 
 // #############################################################################
@@ -136,6 +137,7 @@ line& line::trsf(const ge::ref& rf, const bool& inv)
 	 */
 	rf.trsf(_vtx[0], inv);
 	rf.trsf(_vtx[1], inv);
+	modeNeedRedraw(true);
 	return *this;
 }
 
@@ -219,6 +221,14 @@ void line::glDraw()
 	}
 }
 
+//______________________________________________________________________________
+bool line::glMesh(mesh& m)
+{
+	/*!	Writes the line segment into the batch mesh \c m. */
+	if (modeVisible() && _strkEnable) m.segment(_vtx[0], _vtx[1], _strkColor);
+	return true;
+}
+
 //______________________________________________________________________________
 void line::glDrawEnd()
 {
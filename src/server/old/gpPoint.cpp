@@ -15,6 +15,7 @@
 
 // Application components.
 #include "gpPoint.h"
+#include "gpBatch.h"
 
 
 // #############################################################################
@@ -131,6 +132,7 @@ point& point::trsf(const ge::ref& rf, const bool& inv)
 	 *	if inv = false, and by applying the inverse transformation if inv = true. 
 	 */
 	rf.trsf(_vtx, inv);
+	modeNeedRedraw(true);
 	return *this;
 }
 
@@ -218,6 +220,18 @@ void point::glDraw()
 	glLightRestore();
 }
 
+//______________________________________________________________________________
+bool point::glMesh(mesh& m)
+{
+	/*!	Writes the point into the batch mesh \c m, as an instance of the
+	 *	dot shape sized by the stroke width (in pixels).
+	 */
+	if (!modeVisible() || !_strkEnable) return true;
+	const double ax[9] = { _strkWidth, 0, 0, 0, 0, 0, 0, 0, 0 };
+	m.shaped(mesh::kShape::dot, _Vtx, ax, _strkColor);
+	return true;
+}
+
 //______________________________________________________________________________
 void point::glDrawEnd()
 {
@@ -73,6 +73,7 @@ class point: public stroked
 			void glDraw();		//!< Draws the GP.
 			void glDrawSel();	//!< Highlight the GP.
 			void glDrawEnd();	//!< Close the GP drawing. Mandatory call!
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
 		#endif
 };
 
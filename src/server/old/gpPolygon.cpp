@@ -15,6 +15,7 @@
 
 // Application components.
 #include "gpPolygon.h"
+#include "gpBatch.h"
 
 
 // #############################################################################
@@ -149,6 +150,7 @@ polygon& polygon::trsf(const ge::ref& rf, const bool& inv)
 	 *	if inv = false, and by applying the inverse transformation if inv = true. 
 	 */
 	for (unsigned int i = 0; i < _vtx.size(); i++) rf.trsf(_vtx[i], inv);
+	modeNeedRedraw(true);
 	return *this;
 }
 
@@ -237,6 +239,14 @@ void polygon::glDraw()
 	}
 }
 
+//______________________________________________________________________________
+bool polygon::glMesh(mesh& m)
+{
+	/*!	Writes the polygon outline into the batch mesh \c m. */
+	if (modeVisible() && _strkEnable) m.strip(_vtx, _closed, _strkColor);
+	return true;
+}
+
 //______________________________________________________________________________
 void polygon::glDrawEnd()
 {
@@ -75,6 +75,7 @@ class polygon: public stroked
 			void glDraw();		//!< Draws the GP.
 			void glDrawSel();	//!< Highlight the GP.
 			void glDrawEnd();	//!< Close the GP drawing. Mandatory call!
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
 		#endif
 };
 
@@ -15,6 +15,7 @@
 
 // Application components.
 #include "gpSphere.h"
+#include "gpBatch.h"
 
 
 // #############################################################################
@@ -217,6 +218,20 @@ void sphere::glDraw()
 	}
 }
 
+//______________________________________________________________________________
+bool sphere::glMesh(mesh& m)
+{
+	/*!	Writes the sphere filling into the batch mesh \c m, as an instance of
+	 *	the unit sphere with the same tessellation, reduced by the level of
+	 *	detail. The sphere is centered in the origin of its (parent) reference.
+	 */
+	if (!modeVisible() || !_fillEnable) return true;
+	const double ax[9] = { _radius, 0, 0, 0, _radius, 0, 0, 0, _radius };
+	m.material = _fillMaterial;
+	m.shaped(mesh::kShape::ball, ge::point(0, 0, 0), ax, _fillColor, m.lod(_slices, 6), m.lod(_stacks, 4));
+	return true;
+}
+
 //______________________________________________________________________________
 void sphere::glDrawEnd()
 {
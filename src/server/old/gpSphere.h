@@ -70,6 +70,7 @@ class sphere: public filled
 			void glDraw();		//!< Draws the GP on the current GLcontext.
 			void glDrawSel();	//!< Draws the GP in selection mode.
 			void glDrawEnd();	//!< Closes the GP drawing. MAndatory call!
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
 			
 		#endif
 };
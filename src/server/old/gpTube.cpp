@@ -15,6 +15,7 @@
 
 // Application components.
 #include "gpTube.h"
+#include "gpBatch.h"
 
 
 // #############################################################################
@@ -293,6 +294,24 @@ void tube::glDraw()
 	}
 }
 
+//______________________________________________________________________________
+bool tube::glMesh(mesh& m)
+{
+	/*!	Writes the tube filling into the batch mesh \c m, as an instance of
+	 *	the unit tube (along z, from 0 to 1) scaled to the largest outer radius
+	 *	and the height. The radii ratios select the shared unit mesh, and the
+	 *	slices and stacks are reduced by the level of detail.
+	 */
+	if (!modeVisible() || !_fillEnable) return true;
+	const double r = _roBase > _roTop ? _roBase : _roTop;
+	if (r <= 0 || _height == 0) return true;
+	const double ax[9] = { r, 0, 0, 0, r, 0, 0, 0, _height };
+	const float par[4] = { (float)(_riBase / r), (float)(_roBase / r), (float)(_riTop / r), (float)(_roTop / r) };
+	m.material = _fillMaterial;
+	m.shaped(mesh::kShape::pipe, ge::point(0, 0, 0), ax, _fillColor, m.lod(_slices, 6), m.lod(_stacks, 1), par);
+	return true;
+}
+
 //______________________________________________________________________________
 void tube::glDrawEnd()
 {
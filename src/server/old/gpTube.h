@@ -85,6 +85,7 @@ class tube: public filled
 			void glDraw();		//!< Draws the GP on the current GLcontext.
 			void glDrawSel();	//!< Draws the GP in selection mode.
 			void glDrawEnd();	//!< Closes the GP drawing. MAndatory call!
+			bool glMesh(mesh&);	//!< Writes the GP into a batch mesh.
 		#endif
 };
 
@@ -85,7 +85,8 @@ namespace cat { namespace rc {
 		close,
 		wait,
 		dummy,
-		exit
+		exit,
+		patch
 	};
 
 	//! Connection status constants.
@@ -29,6 +29,7 @@
 #include "gpTube.h"
 #include "gpSphere.h"
 #include "gpLabel.h"
+#include "gpArray.h"
 
 
 //##############################################################################
@@ -1051,6 +1052,88 @@ gp::GPHnd DCs::dcBox(const double& cX, const double& cY, const double& cZ,
 }
 
 
+// ********************************** Array ************************************
+
+//______________________________________________________________________________
+gp::GPHnd DCs::dcArray(const gp::GPHnd& parent, const double* data,
+					  const uint32_t& cols, const uint32_t& rows,
+					  const double& colSize, const double& rowSize,
+					  const double& height, const char* name)
+{
+	/*! Draws a 2D array as a lego-style heightmap. Returns the handle to that
+	 *	object if successful, NULL otherwise. \c parent is the parent for the
+	 *	object, \c data points to \c cols x \c rows values arranged by rows,
+	 *	\c colSize and \c rowSize are the cells dimensions along X and Y and
+	 *	\c height is the Z size of the highest cell. The whole array is a single
+	 *	GP, whatever its size. Array appearance and inheritance are defined by
+	 *	the current settings of the drawing fill and inheritance mode.
+	 */
+	
+	// Checks if a scene is currently selected.
+	if (sceneStatus()) return 0;
+	if (!data || !cols || !rows) return 0;
+
+	// Adds the GP to the scene.
+	gp::GPHnd newGP = _scene[_select]->gpAdd(new gp::array(data, cols, rows, 
+														colSize, rowSize, height), parent);
+	gp::GP* gp = _scene[_select]->gpGet(newGP);
+																		
+	// Sets GP specific properties.
+	gp->name(name);
+	gp->info("");
+	
+	// Sets GP drawing properties.
+	gpLoadInherit(gp);
+	gpLoadBrush(gp);
+	gpLoadFill(gp);
+	gpLoadTrsf(gp);
+
+	// Return the handle to that GP.
+	return newGP;
+}
+
+//______________________________________________________________________________
+gp::GPHnd DCs::dcArray(const double* data, const uint32_t& cols, const uint32_t& rows,
+					  const double& colSize, const double& rowSize,
+					  const double& height, const char* name)
+{
+	/*! Draw a 2D array. Parentless overload. */
+	return dcArray((gp::GPHnd)0, data, cols, rows, colSize, rowSize, height, name); 
+}
+
+//______________________________________________________________________________
+bool DCs::dcArrayTile(const gp::GPHnd& hnd, const uint32_t& x, const uint32_t& y,
+					  const uint32_t& w, const uint32_t& h, const double* data)
+{
+	/*! Replaces the values of the tile starting at cell (\c x, \c y) and
+	 *	spanning \c w columns and \c h rows of the array \c hnd with \c data,
+	 *	arranged by rows. If the array was already flushed to the server, only
+	 *	the tile is sent, as a patch record, instead of the whole array.
+	 *	Returns true if \c hnd is not an array or the tile does not fit it.
+	 */
+	
+	// Checks if a scene is currently selected and the GP is an array.
+	if (sceneStatus()) return true;
+	gp::GP* gp = _scene[_select]->gpGet(hnd);
+	if (!gp || gp->type() != CO::oType::gpArray) return true;
+	gp::array* arr = static_cast<gp::array*>(gp);
+	
+	// Updates the local copy.
+	if (arr->tile(x, y, w, h, data)) return true;
+
+	// Not yet on the server, the next flush will carry the whole array.
+	if (hnd >= _flush[_select]) return false;
+	
+	// Sends the tile record only.
+	std::stringstream command(std::ios::binary | std::ios::out | std::ios::in);
+	std::stringstream buffer(std::ios::binary | std::ios::out | std::ios::in);
+	arr->tileStream(buffer, x, y, w, h);
+	streamCmd(command, kCmd::patch, _select, hnd, buffer.str().size());
+	if (streamSend(command)) return true;
+	return streamSend(buffer);
+}
+
+
 //// ********************************** Tube *************************************
 //
 ////______________________________________________________________________________
@@ -293,6 +293,24 @@ class DCs: public core
 		CAT_API gp::GPHnd CAT_CALL dcBox(const double& cX, const double& cY, const double& cZ,
 										const double& sX, const double& sY, const double& sZ,										
 										const char* name = "");
+
+		//! 2D array (lego heightmap) with parent.
+		CAT_API gp::GPHnd CAT_CALL dcArray(const gp::GPHnd& parent, const double* data,
+										const uint32_t& cols, const uint32_t& rows,
+										const double& colSize = 0.1, const double& rowSize = 0.1,
+										const double& height = 1, const char* name = "");
+
+		//! 2D array (lego heightmap) with no parent.
+		CAT_API gp::GPHnd CAT_CALL dcArray(const double* data,
+										const uint32_t& cols, const uint32_t& rows,
+										const double& colSize = 0.1, const double& rowSize = 0.1,
+										const double& height = 1, const char* name = "");
+
+		//! Replaces a (x, y, w, h) tile of an existing 2D array.
+		CAT_API bool CAT_CALL dcArrayTile(const gp::GPHnd& array, 
+										const uint32_t& x, const uint32_t& y,
+										const uint32_t& w, const uint32_t& h,
+										const double* data);
 	/*
 		//! Tube with parent.
 		CAT_API gp::GPHnd CAT_CALL dcTube(const gp::GPHnd& parent,
@@ -123,39 +123,11 @@ class macros: public DCs
 										const double& height = 1,
 										const char* name = "")
 	{
-		/* Represents a 2D array via a lego-style 3D plot. */
-		//GPHnd array2D = dcFrame(parent, 0, 0, 0, 0, 0, 0, "Array2D");
-		gp::GPHnd array2D = dcEmpty(parent, "Array2D");
-
-		// Parses the array for max and min.
-		double pMax = data[0];
-		double pMin = data[0];
-		for (unsigned int i = 1; i < rows * cols; i++) {
-			if (data[i] > pMax) pMax = data[i];
-			if (data[i] < pMin) pMin = data[i];			
-		}
-		
-		// Sets the zero and the scale factor.
-		double pScale =	height / (pMax - pMin);
-		double pZero = -pMin * pScale;
-
-		// Builds the lego.
-		double bOffX = colSize / 2;
-		double bOffY = rowSize / 2;
-		double bSizeX = colSize * 0.9;
-		double bSizeY = rowSize * 0.9;
-		
-		for (unsigned int y = 0; y < rows; y++) {
-			for (unsigned int x = 0; x < cols; x++) {
-				double bH = data[y * cols + x] * pScale + pZero;
-				double bX = x * colSize + bOffX;
-				double bY = y * rowSize + bOffY;
-				dcBox(array2D, bX, bY, 0, bSizeX, bSizeY, bH);	
-			}
-		}
-		
-		// Return the object handle.
-		return array2D;
+		/* Represents a 2D array via a lego-style 3D plot. The whole array is
+		   a single gp::array primitive (one payload, one draw), rather than
+		   one box per cell. */
+		return dcArray(parent, data, cols, rows, colSize, rowSize, height,
+					   (name && name[0]) ? name : "Array2D");
 	}
 
 	//! Array2D with no parent.
@@ -91,6 +91,20 @@ void mouseBall::posWorldGet(glm::vec3& wXYZ) const
 	wXYZ.z = static_cast<float>(_posWorld[0]);
 }
 
+//______________________________________________________________________________
+void mouseBall::posSet(const double* vXYZ, const double* wXYZ)
+{
+	/*! Sets the mouse position in viewport and world coordinates, as found
+	 *	by picking (see ui::pad::pick()) after begin().
+	 */
+
+	// Store positions.
+	for (auto i = 0; i < 3; i++) {
+		_posView[i] = vXYZ[i];
+		_posWorld[i] = wXYZ[i];
+	}
+}
+
 //______________________________________________________________________________
 void mouseBall::begin(const int& x, const int& y, const int& mb, const bool& zp, const view* view)
 {
@@ -101,6 +101,7 @@ class mouseBall  //: public UI
 		void posViewGet(uint32_t* vXYZ) const;		//!< Retrieve mouse View position (UInt32*).
 		void posWorldGet(double* wXYZ) const;		//!< Retrieve mouse World position (double*).
 		void posWorldGet(glm::vec3& wXYZ) const;	//!< Retrieve mouse World position (glm::vec3&).
+		void posSet(const double* vXYZ, const double* wXYZ);	//!< Set mouse View and World position.
 		
 		//! Set current window size (for computing position vector). 
 		void setViewportSize(const int& width, const int& height);
@@ -17,6 +17,9 @@
 #include "uiPad.h"
 #include "uiSplash.h"
 
+// Standard library.
+#include <cmath>
+
 
 // #############################################################################
 namespace cat { namespace ui { 
@@ -64,6 +67,10 @@ pad::pad(const uint64_t& idx, const char* title, const bool& r): _idx(idx)
 
 	// Selection status.
 	_selForceRedraw = false;
+
+	// Drawing status: the first frame is always drawn.
+	_redraw = true;
+	_idleWait = 20;
 	
 	// Init the window which hosts the pad.
 	if (initWindow(title, r)) throw std::runtime_error("Window initialization failed.");
@@ -74,6 +81,7 @@ pad::pad(const uint64_t& idx, const char* title, const bool& r): _idx(idx)
 	// Init the pad modules.
 	_GUI = new padGUI(this);
 	_GL = new padGL(this);
+	_batch = new gp::batch();
 
 	// Show startup info if requested.
 	if (ag::_stupShowInfo) initInfo();
@@ -93,7 +101,9 @@ pad::~pad()
 	}
 	_scene[0] = 0;
 	
-	// Delete the associate modules.
+	// Delete the associate modules. The batch releases its buffers, so it
+	// goes while the GL context is still alive.
+	delete _batch;
 	delete _GUI;
 	delete _GL;
 
@@ -242,14 +252,21 @@ void pad::titleDraw(const double& timing)
 bool pad::evnHandler()
 {
 	/*! Processes the SDL provided events queue. This function actually handles
-	 *	all the keyboard, system and mouse inputs to the program. 
+	 *	all the keyboard, system and mouse inputs to the program. If nothing
+	 *	has to be redrawn, it first sleeps until an event arrives or the idle
+	 *	timeout expires (so the server and the other pads are still served).
+	 *	Any event requests a redraw.
 	 */
 
 	// The current event reference.
 	SDL_Event evn;
 
-	// Scan through the event queue.
-	while(SDL_PollEvent(&evn)) {
+	// Scan through the event queue, waiting for the first event if idle.
+	bool got = needRedraw() ? SDL_PollEvent(&evn) : SDL_WaitEventTimeout(&evn, (Sint32)_idleWait);
+	for (; got; got = SDL_PollEvent(&evn)) {
+		
+		// The view, the GUI or the window may change.
+		_redraw = true;
 			
 		// Tweak Bar.
 //		if (GUI->evnBar(evn)) continue;
@@ -429,6 +446,8 @@ void pad::sceneSel(const int& sIdx)
 		_scene[0] = _scene[sIdx];
 //		_view[0] = _view[sIdx];
 		_sceneIdx = sIdx;
+		_batch->clear();
+		_redraw = true;
 	}
 
 	// Reset current selection.
@@ -490,15 +509,21 @@ void pad::run(const bool& openLoop)
 	// While an explicit quit is called.
 	while(!evnHandler()) {
 		
-		// Redraw the Scene.
-		if(glDraw()) break;
-		
-		// Repaint the GUI. GUI is painted on the front buffer, so the back
-		// color buffer always old the "clean" scene picture.
-		if(_GUI->glDraw()) break;
-		
-		// Show updated graphic in Pad window.
-		_window->swap();
+		// Draw only if anything changed, the window keeps the last frame
+		// otherwise.
+		if (needRedraw()) {
+
+			// Redraw the Scene.
+			if(glDraw()) break;
+			
+			// Repaint the GUI. GUI is painted on the front buffer, so the back
+			// color buffer always old the "clean" scene picture.
+			if(_GUI->glDraw()) break;
+			
+			// Show updated graphic in Pad window.
+			_window->swap();
+			_redraw = false;
+		}
 		
 		// It not continuous, just exit for this time.
 		if (openLoop) break;
@@ -523,6 +548,25 @@ void pad::refresh()
 //	GUI->updateBars();
 }
 
+//______________________________________________________________________________
+void pad::invalidate()
+{
+	/*! Requests a redraw of the pad at the next run() loop. */
+	_redraw = true;
+}
+
+//______________________________________________________________________________
+bool pad::needRedraw() const
+{
+	/*! Returns true if the pad has to be redrawn: an event arrived (the view,
+	 *	the GUI or the window may have changed), the scene changed (new data
+	 *	or modified GPs), the selection changed, or a picking is in progress.
+	 */
+	if (_redraw) return true;
+	if (_GUI->mousePick().statusGet() != ui::mousePicker::kPk::null) return true;
+	return _sceneIdx && _scene[0] && _scene[0]->modeNeedRedraw();
+}
+
 //______________________________________________________________________________
 void pad::info() const
 {
@@ -553,6 +597,7 @@ void pad::selClear()
 	// Now clear the selection vector.
 	_selGPHnd.clear();
 	_selForceRedraw = false;
+	_redraw = true;
 
 	// Updates the interface.
 	//_GUI->evnSelect(_selGPHnd);   ?????????????????????????????????????????????????
@@ -570,6 +615,7 @@ void pad::selAdd(const cat::gp::GPHnd& gpHnd)
 
 	// Add.
 	_selGPHnd.push_back(gpHnd);
+	_redraw = true;
 }
 
 //______________________________________________________________________________
@@ -588,6 +634,7 @@ void pad::selAdd(const std::vector<gp::GPHnd>& sel)
 			_scene[0]->gpGet(sel[i])->modeSelected(true);
 		}
 	}
+	_redraw = true;
 }
 
 //______________________________________________________________________________
@@ -611,6 +658,51 @@ void pad::selShow()
 	// _GUI->evnSelect(_selGPHnd); ?????????????????????????????????????????????????????
 }
 
+//______________________________________________________________________________
+gp::GPHnd pad::pick(const int& x, const int& y, double* vXYZ, double* wXYZ, std::vector<gp::GPHnd>* all)
+{
+	/*! Returns the nearest GP under the viewport point (\c 'x', \c 'y'), 0
+	 *	if none, casting a ray through the batched scene from the near to the
+	 *	far plane of the last drawn view. \c 'vXYZ' and \c 'wXYZ' are loaded
+	 *	with the viewport (Z being the depth) and world coordinates of the hit,
+	 *	or of the far plane point if nothing has been hit. If \c 'all' is
+	 *	provided, all the GPs along the ray are appended to it.
+	 */
+
+	// The ray, and the world size of a pixel at its ends.
+	const view* view = _view[0];
+	double v[3] = { (double)x, (double)y, 0 };
+	double o[3], e[3], o1[3], e1[3];
+	vXYZ[0] = x;
+	vXYZ[1] = y;
+	vXYZ[2] = 1;
+	if (!view || !_scene[0] || view->glViewToWorld(v, o)) return 0;
+	v[2] = 1;
+	view->glViewToWorld(v, e);
+	v[0] += 1;
+	view->glViewToWorld(v, e1);
+	v[2] = 0;
+	view->glViewToWorld(v, o1);
+	double d[3], px[2] = { 0, 0 };
+	for (auto i = 0; i < 3; i++) {
+		d[i] = e[i] - o[i];
+		px[0] += (o1[i] - o[i]) * (o1[i] - o[i]);
+		px[1] += (e1[i] - e[i]) * (e1[i] - e[i]);
+		wXYZ[i] = e[i];
+	}
+	px[0] = std::sqrt(px[0]);
+	px[1] = std::sqrt(px[1]);
+
+	// Cast it.
+	double t = 1;
+	const gp::GPHnd hnd = _batch->pick(o, d, px, t, all);
+	if (hnd) {
+		for (auto i = 0; i < 3; i++) wXYZ[i] = o[i] + t * d[i];
+		view->glWorldToView(wXYZ, vXYZ);
+	}
+	return hnd;
+}
+
 
 // *****************************************************************************
 // **						  Private drawing members						  **
@@ -648,28 +740,15 @@ bool pad::glDraw()
 		_GUI->mousePick().statusStep();
 //	}
 
-	// Sets the view. Perform a selection rendering if picking is active.
+	// Sets the view. Picking needs no special rendering, the hits are found
+	// by glHits() casting a ray through the batched scene.
 	if (_GUI->mousePick().statusGet() == ui::mousePicker::kPk::started) {
-
 		_GUI->mousePick().statusStep();	// Updates current picking status.
-//		glSelectBuffer(_selBufferSize, _selBuffer);	// Init selection buffer.
-		
-		// Initializes selection mode. 	
-//		glRenderMode(GL_SELECT);
-//		glInitNames();
-//		glPushName(0);
-
-		// Set the special picking view.
-		view->glSet(_GUI->mouseBall(), true);  
-		view->needRedraw(true);		
-
-	// Otherwise is a normal rendering.
-	} else {
-		view->glSet(_GUI->mouseBall());
 	}
+	view->glSet(_GUI->mouseBall());
 		
-	// Do the actual redraw. Always if no GL_3.0, when needed otherwise.
-//	if (!GLEW_VERSION_3_0 || view->needRedraw() || _scene[0]->modeNeedRedraw() || _selForceRedraw) {
+	// Do the actual redraw. The run() loop calls glDraw() only when needed,
+	// see needRedraw().
 		
 		// Start redraw timing.
 		glTime();
@@ -677,31 +756,30 @@ bool pad::glDraw()
 		// Anyway clears the screen and the depth buffer.
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		
-		// Renders non transparent objects first. 
+		// Brings the batched geometry in sync with the scene. Only the GPs
+		// changed since the last frame are written again.
+		_batch->update(_scene[0]);
+
+		// Renders non transparent objects first: the batched ones with a
+		// few draw calls, the others one by one.
+		_batch->glDraw(view->_matrix.modelview, view->_matrix.projection, false);
 		for (auto i = 1; i < _scene[0]->gpSize(); i++) {
 			gp::GP* gp = _scene[0]->gpGet(i); 
-			if (gp) if (!(gp->glAlpha())) gp->glDisplay();
+			if (gp && !_batch->batched(i)) if (!(gp->glAlpha())) gp->glDisplay();
 		}
 			
-		// Renders transparent objects then.
-		for (auto i = 1; i < _scene[0]->gpSize(); i++) {
-			gp::GP* gp = _scene[0]->gpGet(i); 
-			if (gp) if ((gp->glAlpha())) gp->glDisplay();
-		}
+		// Renders transparent objects then, all of them back to front, the
+		// not batched ones too. The order is kept from the last frame.
+		_batch->glDraw(view->_matrix.modelview, view->_matrix.projection, true);
 
 		// Reset the scene redrawing necessity.
 		_scene[0]->modeNeedRedraw(false); 
 		
 		// Stop timing.
 		glTime();
-//	}
 	
 	// Reset the stack matrixes. VERY important!
 	view->glReset(); 
-
-	// Returns always to render mode. Stores anyway 
-	// the size of the selection buffer in _SelHits.
-//	_selHits = glRenderMode(GL_RENDER);
 		
 	// Copy the auxiliary framebuffer into the window one.
 //	if (GLEW_VERSION_3_0) {
@@ -760,16 +838,13 @@ void pad::glTime()
 		}
 		_tmrTimer.start();
 	}
-
-	// Reset
-	_selHits = 0;
 }
 
 //______________________________________________________________________________
 size_t pad::glHits(double& minZ, const bool& add, const bool& all)
 {
-	/*! Parses the selection buffer and retrieves which object/s has/have been 
-	 *	selected. Selected objects will be loaded to the _SelGPHnd vector, adding
+	/*! Picks the GPs under the mouse picking point and retrieves which
+	 *	object/s has/have been selected. Selected objects will be loaded to the _SelGPHnd vector, adding
 	 *	them to the existent records if \c 'add' is set to true, or filling the
 	 *	vector from scratch if \c 'add' is set to false (default).
 	 *	The \c 'all' switch tells whether to include in the selection vector only
@@ -784,47 +859,14 @@ size_t pad::glHits(double& minZ, const bool& add, const bool& all)
 	std::vector<gp::GPHnd> oldGPHnd = _selGPHnd;
 	std::vector<gp::GPHnd> newGPHnd;
 
-	// Prepare to search Buffer 
-	int hitHnd = 0;				// 'Picked' GP handle.
-	GLuint* ptr = _selBuffer;	// Pointer to buffer element.
-	float gMin = 0;				// Global minimum for the selection.	
-
-	// Search! Loop over each hit, and every element in the hit buffer.
-	for (size_t i = 0; i < _selHits; i++) {
-			
-		// How many names for this hits.
-		GLuint names = *ptr; ptr++;
-			
-		// Minimum Z (orthogonal to the screen plane).
-		float zMin = (float) *ptr/0x7fffffff; ptr++;
-			
-		// Maximum Z (orthogonal to the screen plane).
-		/* No need to store the maximum */; ptr++;
-			
-		// Retrieves all the names for this hit.
-		unsigned int name = 0;
-		for (auto j = 0; j < names; j++) {
-			name = *ptr; ptr++;
-			//std::cout << "Hit: " << i << ", name: " << name << ", zMin: " << zMin << "\n";
-		}
-
-		// "All what it's in view" pick mode, store every hit found.
-		if (all) newGPHnd.push_back(name);  
-				 
-		// Single pick mode, search for the topmost primitive.
-		else {
-			if(i == 0 || zMin < gMin) {
-				gMin = zMin;	// Set global minimum. 
-				hitHnd = name;	// Store GP handle.
-			}
-		}		
-	}
-
-	// Store the gMin hit in case of single selection.
+	// Casts the picking ray. "All what it's along the ray" pick mode stores
+	// every hit found, single pick mode the topmost primitive only.
+	double vXYZ[3], wXYZ[3];
+	const gp::GPHnd hitHnd = pick(_GUI->mousePick().x(), _GUI->mousePick().y(), vXYZ, wXYZ, all ? &newGPHnd : 0);
 	if (!all && hitHnd > 0) newGPHnd.push_back(hitHnd);
 
 	// Anyway, store the minimum Z.
-	minZ = gMin;
+	minZ = hitHnd ? vXYZ[2] : 0;
 	
 	// Now, compare new and hold vector, and remove from the
 	// new vector any GPs already present in the old one, so
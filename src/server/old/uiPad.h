@@ -26,6 +26,7 @@
 //#include "ui.h"
 #include "uiWindow.h"
 #include "gpScene.h"
+#include "gpBatch.h"
 #include "uiPadGUI.h"
 #include "uiPadGL.h"
 #include "uiView.h"
@@ -85,6 +86,7 @@ class pad
 		// Modules
 		padGUI* _GUI;							//!< Pad's personal user interface.
 		padGL* _GL;								//!< Pad's personal raster drawing primitives.
+		gp::batch* _batch;						//!< Batched geometry of the displayed scene.
 
 		// Status and properties
 		uint64_t _idx;							// Main loop assigned identifier.
@@ -100,11 +102,10 @@ class pad
 		uint64_t _GPsSize;						// Total size of the GPs in the currently selected scene.
 	
 		// Drawing/Selection status
-		static const int _selBufferSize = 1024;	// Selection buffer size.
-		GLuint _selBuffer[_selBufferSize];	// Selection buffer.
-		unsigned int _selHits;					// Selection hits.
 		std::vector<cat::gp::GPHnd> _selGPHnd;	// The select primitive/s handle/s.
 		bool _selForceRedraw;					// Force redraw due to selection.
+		bool _redraw;							// Something changed since the last frame.
+		uint32_t _idleWait;						// Longest idle wait for events (ms).
 
 		// Special members
 		pad(const uint64_t& Idx, const char* title, const bool& resizable = true);
@@ -121,6 +122,8 @@ class pad
 		void selAdd(const gp::GPHnd&);				//!< Add a GP to the selection.
 		void selAdd(const std::vector<gp::GPHnd>&);	//!< Add a list of GPs to the selection.
 		void selShow();								//!< Highlight the GPS in the selection vector.
+		gp::GPHnd pick(const int& x, const int& y, double* vXYZ, double* wXYZ, 
+					   std::vector<gp::GPHnd>* all = 0);	//!< The GP under a viewport point.
 
 		// Scene(s) management.
 		Uint64 sceneCount();						//!< The number of hosted scenes.
@@ -132,6 +135,8 @@ class pad
 		// Pad management.
 		void run(const bool& openLoop = false);		//!< Runs the pad.
 		void refresh();								//!< Refresh the pad.
+		void invalidate();							//!< Requests a redraw.
+		bool needRedraw() const;					//!< Whether a redraw is due.
 		size_t size();								//!< Returns the Pad total allocated memory (bytes).
 		int idx() const;							//!< Returns the pad Idx.
 		void idx(const int&);						//!< Resets the pad Idx.
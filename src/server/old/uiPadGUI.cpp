@@ -783,6 +783,7 @@ bool padGUI::evnMouse(SDL_Event evn)
   	
 	// TEMPORARY
 	bool zp = false; // Use right button for pan insted of scale.
+	double v[3], w[3]; // Mouse position in viewport and world space.
 
 	// Handle different event types.
 	switch (evn.type) {
@@ -799,8 +800,10 @@ bool padGUI::evnMouse(SDL_Event evn)
 				// In any case, hide the popup view bar.
 				updateBarSpot(false);
 
-				// Begin mouse rotation. 									
-				_mArcBall.begin(evn.button.x, evn.button.y, 0, zp, _owner->_view[0]);
+				// Begin mouse rotation, at the depth of the GP under the mouse.
+				_mArcBall.begin(evn.button.x, evn.button.y, 0, zp);
+				_owner->pick(evn.button.x, evn.button.y, v, w);
+				_mArcBall.posSet(v, w);
 
 				// Switch picking status anyway. If movement will follow, picking info
 				// will actually serve only to help optimizing zooming/rotating actions.
@@ -809,7 +812,9 @@ bool padGUI::evnMouse(SDL_Event evn)
 			
 			// Right button: starts scaling/panning.
 			if (evn.button.button == SDL_BUTTON_RIGHT) {			
-				_mArcBall.begin(evn.button.x, evn.button.y, 1, zp, _owner->_view[0]);
+				_mArcBall.begin(evn.button.x, evn.button.y, 1, zp);
+				_owner->pick(evn.button.x, evn.button.y, v, w);
+				_mArcBall.posSet(v, w);
 			}
 			
 			// Event intercepted.
@@ -597,6 +597,15 @@ uint32_t mPosView[3]; mb.posViewGet(mPosView);
 //	glLoadMatrixf(glm::value_ptr(prjMtx));
 //	glMatrixMode(GL_MODELVIEW);
 
+	// Keeps the matrixes for the shader based drawing (the batched GPs) and
+	// the viewport<->world transformations.
+	const float* mdlPtr = glm::value_ptr(mdlMtx);
+	const float* prjPtr = glm::value_ptr(prjMtx);
+	for (auto i = 0; i < 16; i++) {
+		_matrix.modelview[i] = mdlPtr[i];
+		_matrix.projection[i] = prjPtr[i];
+	}
+
 
 	// In case of selection, narrows the view down to few pixels around the mouse 
 	// cursor point (x, y) and extending two pixels in the vertical and horizontal 
@@ -710,8 +719,18 @@ bool view::glViewToWorld(const double* vXYZ, double* wXYZ) const
 	 *	[0 - 1]: Setting it to 0 means scratching the screen. 
 	 */
 
-	// Retrieve the transformed coordinates.
-//	gluUnProject(vXYZ[0], _matrix.viewport[3] - vXYZ[1], vXYZ[2], _matrix.modelview, _matrix.projection, _matrix.viewport, &wXYZ[0], &wXYZ[1], &wXYZ[2]);
+	// Back from the normalized device coordinates through the inverse of
+	// the projection * modelview (the gluUnProject() way).
+	const glm::dmat4 pm = glm::make_mat4(_matrix.projection) * glm::make_mat4(_matrix.modelview);
+	if (glm::determinant(pm) == 0 || !_matrix.viewport[2] || !_matrix.viewport[3]) return true;
+	const glm::dvec4 n(2 * (vXYZ[0] - _matrix.viewport[0]) / _matrix.viewport[2] - 1,
+					   2 * (_matrix.viewport[3] - vXYZ[1] - _matrix.viewport[1]) / _matrix.viewport[3] - 1,
+					   2 * vXYZ[2] - 1, 1);
+	const glm::dvec4 w = glm::inverse(pm) * n;
+	if (w.w == 0) return true;
+	wXYZ[0] = w.x / w.w;
+	wXYZ[1] = w.y / w.w;
+	wXYZ[2] = w.z / w.w;
 
 	// Everything fine.
 	return false;
@@ -726,8 +745,14 @@ bool view::glWorldToView(const double* wXYZ, double* vXYZ) const
 	 *	[0 - 1]: 0 means scratching the screen, 1 being at infinite. 
 	 */
 
-	// Retrieve the transformed coordinates.
-//	gluProject(wXYZ[0], wXYZ[1], wXYZ[2], _Matrix.Modelview, _Matrix.Projection, _Matrix.Viewport, &vXYZ[0], &vXYZ[1], &vXYZ[2]);
+	// Through the projection * modelview to the normalized device
+	// coordinates, then to the viewport (the gluProject() way).
+	const glm::dvec4 c = glm::make_mat4(_matrix.projection) * glm::make_mat4(_matrix.modelview)
+					   * glm::dvec4(wXYZ[0], wXYZ[1], wXYZ[2], 1);
+	if (c.w == 0) return true;
+	vXYZ[0] = _matrix.viewport[0] + _matrix.viewport[2] * (c.x / c.w + 1) / 2;
+	vXYZ[1] = _matrix.viewport[3] - (_matrix.viewport[1] + _matrix.viewport[3] * (c.y / c.w + 1) / 2);
+	vXYZ[2] = (c.z / c.w + 1) / 2;
 
 	// Everything fine.
 	return false;
@@ -16,6 +16,7 @@
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <stdexcept>
 
 
 // SFML system/windowing library.
@@ -76,9 +77,8 @@ int main(int argc, char* argv[]) {
     //! CAT Server entry point. The main entry point simply executes initialization
     //! then hands over control to the 'srvLoop' main application loop.
 std::cout << "[1]\n";
-    // Set up the application context data structure. Doing that, actually 
-    // initializes the system/windows management as well through the class
-    // ctor, which creates a SFML window.
+    // Set up the application context data structure. The main window is
+    // opened later by appInit(), unless running headless.
     cat::context ctx;
 std::cout << "[2]\n";
 
@@ -145,6 +145,11 @@ int appCmd(cat::context& ctx, int argc, char* argv[])
     // Set the options.
     ctx.cmd.addOpt("port", "server port", false, true);
     ctx.cmd.addOpt("v", "verbosity level", false, false);
+    ctx.cmd.addOpt("headless", "run without window (no display needed)", false, false);
+    ctx.cmd.addOpt("snapshot", "monitoring images folder (PNG export)", false, true);
+    ctx.cmd.addOpt("period", "monitoring images period [s]", false, true);
+    ctx.cmd.addOpt("sensor", "monitored sensor size (<cols>x<rows>)", false, true);
+    ctx.cmd.addOpt("idle", "longest idle sleep [ms] (also the worst input lag)", false, true);
     
     // Parse the command line. Return 0 if everything ok, -1 for unknown/wrong
     // options or arguments.
@@ -162,11 +167,45 @@ int appInit (cat::context& ctx)
     //! event management, graphics API libraries, network libraries.
     
 
-    // Starts the windows and event management.
-    //ctx.window.create(sf::VideoMode(ctx.winWidth, ctx.winHeight), ctx.winTitle);
+    // Starts the windows and event management. Headless, no window is
+    // created: the monitoring images are exported offscreen, as PNG files,
+    // by a cat::snapshot exporter (data/snapshot.hpp).
+    const bool headless = ctx.cmd.isOptionPresent("headless");
+    if (ctx._window.open(headless) != 0) return -1;
+    ctx._window.idleWait(std::stoi(ctx.cmd.getOptionValue("idle", "250")));
+
+    // Monitored sensor occupancy map.
+    const std::string sensor = ctx.cmd.getOptionValue("sensor", "1024x512");
+    const std::size_t x = sensor.find('x');
+    try {
+        ctx._hitmap.reset(new cat::hitmap(std::stoi(sensor.substr(0, x)),
+            x == std::string::npos ? 1 : std::stoi(sensor.substr(x + 1))));
+    } catch (const std::exception& e) {
+        std::cout << cat::cl::error() << "Error"
+            << cat::cl::reset() << ": invalid sensor size '" << sensor << "'\n";
+        return -1;
+    }
+
+    // Monitoring images exporter: always on when headless, as it is the
+    // only output, on request otherwise. It paints and saves from its own
+    // thread; the hitmap painter only swaps out the snapshots published by
+    // the main loop merges (see appLoop()), so it never touches the fill.
+    if (headless || ctx.cmd.isOptionPresent("snapshot")) {
+        try {
+            ctx._snapshot.reset(new cat::snapshot(
+                ctx.cmd.getOptionValue("snapshot", "."),
+                std::stod(ctx.cmd.getOptionValue("period", "10"))));
+            ctx._snapshot->add("hitmap", *ctx._hitmap);
+            ctx._snapshot->start();
+        } catch (const std::exception& e) {
+            std::cout << cat::cl::error() << "Error"
+                << cat::cl::reset() << ": " << e.what() << "\n";
+            return -1;
+        }
+    }
 
-    // Frame rate limit, to avoid system overload when not necessary.
-    //ctx.window.setFramerateLimit(60);
+    // No frame rate limit: the window draws on demand, and sleeps in its
+    // event() when idle.
     
    
     // Graphics APIs management.
@@ -219,8 +258,9 @@ int srvInit(cat::context& ctx)
         return -1;
     }
      
-    // Set the sockets functions as non-blocking.
-    //ctx.server.setBlocking(false);
+    // Set the sockets functions as non-blocking: the main loop sleeps in
+    // the window event(), not in accept().
+    ctx.server.setBlocking(false);
 
     // Connection info.
     std::cout << "Server started. " 
@@ -289,8 +329,36 @@ int srvListen(cat::context& ctx)
     
 
 
-    // Listen to all connected clients.
-    //for (auto i : ctx.client) {}
+    // Listen to all connected clients. No client request is served yet, so
+    // their data is drained (pending data would otherwise wake the idle
+    // wait of the main loop at once, forever), reporting every dropped
+    // packet at debug verbosity, and the disconnected ones are dropped.
+    for (auto it = ctx.client.begin(); it != ctx.client.end(); ) {
+        sf::Packet in;
+        sf::Socket::Status st;
+        while ((st = (*it)->receive(in)) == sf::Socket::Done) {
+            if (cat::cl::verb::show(cat::cl::verb::debug)) {
+                uint32_t code = 0;
+                sf::Packet peek(in);
+                peek >> code;
+                std::cout << cat::cl::white("Client packet dropped (no dispatcher yet): ")
+                    << (*it)->getRemoteAddress() << ", command " << code
+                    << ", " << in.getDataSize() << " bytes\n";
+            }
+            in.clear();
+        }
+        if (st == sf::Socket::Disconnected || st == sf::Socket::Error) {
+            if (cat::cl::verb::show(cat::cl::verb::message)) {
+                std::cout << cat::cl::white("Client disconnected: ")
+                    << cat::cl::uline() << (*it)->getRemoteAddress() 
+                    << "\n";
+            }
+            delete *it;
+            it = ctx.client.erase(it);
+        } else {
+            it++;
+        }
+    }
     
        
     // Look for a new client trying to connect.
@@ -320,6 +388,9 @@ int srvListen(cat::context& ctx)
             // Test message.
             pkt << uint32_t(cat::tcp::open);
             ctx.client.back()->send(pkt);
+
+            // From now on, polled by the main loop.
+            ctx.client.back()->setBlocking(false);
             
             break;
         
@@ -348,26 +419,31 @@ int appLoop(cat::context& ctx)
     //! This is the main application loop, which handles events from the user,
     //! calls from/to the clients, and display the outputs.
     
+    // Hitmap merge cadence (the exporter period).
+    sf::Clock mergeClock;
 
-    /*
     // Main loop.
     while (ctx.state == cat::context::runState::ongoing) {
         
         // Listen the server connections.
         srvListen(ctx);
 
-
-
-        // Retrieve events from the user/system.
-        //ctx._gui->event(ctx);
-        
-        // Draw interface and scene(s).
-        //ctx._gui->draw(ctx);
+        // Retrieve events from the user/system (sleeps if idle).
+        ctx._window.event(ctx);
         
-
-
+        // Draw interface and scene(s), only if anything changed.
+        if (ctx._window.needRedraw()) {
+            ctx._window.draw(ctx);
+            ctx._window.drawn();
+        }
+
+        // Publish a hitmap snapshot for the exporter thread, when due. The
+        // main loop is the only one merging the hitmap.
+        if (ctx._snapshot && mergeClock.getElapsedTime().asSeconds() >= ctx._snapshot->period()) {
+            mergeClock.restart();
+            ctx._hitmap->merge();
+        }
     }
-    */
 
     // Everything fine.
     return 0;
@@ -561,6 +637,8 @@ int appClose(cat::context& ctx)
     //! Stop the application, close the windows/event managers, shut down the
     //! graphics APIs.
    
+    // Stop the monitoring images exporter.
+    if (ctx._snapshot) ctx._snapshot->stop();
     
     // Everything fine.
     return 0;
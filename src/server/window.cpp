@@ -35,19 +35,45 @@
 
 
 //______________________________________________________________________________
-cat::window::window() : _winWidth(800), _winHeight(600), _winTitle("CAT")
+cat::window::window() : _winWidth(800), _winHeight(600), _winTitle("CAT"),
+    _headless(false), _redraw(2), _idleWait(sf::milliseconds(250))
 {
-    //! Start a new (and the only one) instance of the class.
+    //! Start a new (and the only one) instance of the class. The actual
+    //! window is created by open(), once the command line is known.
+}
+
+
+//______________________________________________________________________________
+int cat::window::open(const bool& headless)
+{
+    //! Creates the main window and its GUI, unless \c headless: then no
+    //! display is touched at all, so the server runs on nodes without any
+    //! X server.
+    
+    // Headless: nothing to open.
+    _headless = headless;
+    if (_headless) return 0;
 
     // Starts the windows and event management.
     //sf::Window _window(sf::VideoMode(_winWidth, _winHeight), _winTitle);
     _window.create(sf::VideoMode(_winWidth, _winHeight), _winTitle);
 
-    // Frame rate limit, to avoid system overload when not necessary.
-    _window.setFramerateLimit(60);
+    // No frame rate limit: frames are drawn only when something changed,
+    // and event() sleeps otherwise (see needRedraw()).
 
     // Create the GUI interface.
     ImGui::SFML::Init(_window);
+
+    // Everything fine.
+    return 0;
+}
+
+
+//______________________________________________________________________________
+bool cat::window::headless() const
+{
+    //! Returns true if running without a window.
+    return _headless;
 }
 
 
@@ -55,7 +81,7 @@ cat::window::window() : _winWidth(800), _winHeight(600), _winTitle("CAT")
 cat::window::~window()
 {
     // CLose main SFML window.
-    _window.close();
+    if (_window.isOpen()) _window.close();
 
     // Close ImGui.
     //    ImGui::SFML::Shutdown();
@@ -65,14 +91,30 @@ cat::window::~window()
 //______________________________________________________________________________
 int cat::window::event(cat::context& ctx)
 {
-    //! Retrieves and parse events from the user and the system
+    //! Retrieves and parse events from the user and the system. When there
+    //! is nothing to redraw, sleeps until the first network activity (new
+    //! client or data) or the idle timeout (see idleWait()), so an idle
+    //! window costs next to no CPU.
+    //! Any event, as well as any network activity, requests a redraw.
     
+    // Idle: wait on the sockets. SFML has no window event wait with timeout,
+    // so the window events queued meanwhile are served at the wake up.
+    // Headless, there is never anything to redraw on screen.
+    if (_headless || !needRedraw()) {
+        sf::SocketSelector selector;
+        selector.add(ctx.server);
+        for (auto c : ctx.client) selector.add(*c);
+        if (selector.wait(_idleWait)) invalidate();
+    }
 
     // Retrieve events from the user/system.
     sf::Event event;
 
     // Retrieve all the queued events from the user/system.
-    while (_window.pollEvent(event)) {
+    while (!_headless && _window.pollEvent(event)) {
+
+        // Input, resize, focus... GUI widgets and views may change.
+        invalidate();
 
         // First, pass the event to the GUI.
         // ---------------------------------
@@ -94,12 +136,48 @@ int cat::window::event(cat::context& ctx)
     return 0;
 }
 
-/*
+
+//______________________________________________________________________________
+void cat::window::invalidate(const int& frames)
+{
+    //! Requests the redraw of the next \c frames frames. The GUI needs a
+    //! couple of them to settle after an input.
+    if (frames > _redraw) _redraw = frames;
+}
+
+
+//______________________________________________________________________________
+bool cat::window::needRedraw() const
+{
+    //! Returns true if the window has to be redrawn (never, headless).
+    return !_headless && _redraw > 0;
+}
+
+
+//______________________________________________________________________________
+void cat::window::drawn()
+{
+    //! Marks a frame as drawn, to be called after every redraw.
+    if (_redraw > 0) _redraw--;
+}
+
+//______________________________________________________________________________
+void cat::window::idleWait(const int& ms)
+{
+    //! Sets the longest idle sleep, in ms (at least 1). It is also the
+    //! worst case lag of the first window input after idling.
+    _idleWait = sf::milliseconds(ms > 0 ? ms : 1);
+}
+
 //______________________________________________________________________________
 int cat::window::draw(cat::context& ctx)
 {
-    //! Draw the scene(s) and other interface 3D world elements.
+    //! Draw the scene(s) and other interface 3D world elements. Called by
+    //! the main loop only when needRedraw() says so.
     
+    // Headless, nothing to show.
+    if (_headless) return 0;
+
     //// Update the GUI.
     //ImGui::SFML::Update(_window, _clock.restart());
 
@@ -111,14 +189,12 @@ int cat::window::draw(cat::context& ctx)
     //// ImGui demo.
     //ImGui::ShowDemoWindow();
 
-    //// Scene drawing.
-
-    //_window.clear();
-    ////app.window.draw(shape);
+    // Scene drawing.
+    _window.clear();
+    //app.window.draw(shape);
     //ImGui::SFML::Render(_window);
-    //_window.display();
+    _window.display();
 
     // Everything fine.
     return 0;
 }
-*/
\ No newline at end of file
@@ -66,8 +66,35 @@ namespace cat {
         //! is an already defined assign operator)
         window& operator=(window&&) = delete;
 
-        //! Parse the window events.
+        //! Opens the main window, or runs without any (headless) on nodes
+        //! with no display: no window events, the images being exported
+        //! offscreen instead (see data/snapshot.hpp).
+        int open(const bool& headless = false);
+
+        //! Whether the application runs without a window.
+        bool headless() const;
+
+        //! Parse the window events. If nothing has to be redrawn, first
+        //! sleeps until an event or new network data, or the idle timeout.
         int event(cat::context&);
+
+        //! Requests the redraw of the next \c frames frames.
+        void invalidate(const int& frames = 2);
+
+        //! Whether the window has to be redrawn.
+        bool needRedraw() const;
+
+        //! Marks a frame as drawn.
+        void drawn();
+
+        //! Sets the longest idle sleep, in ms. Network activity ends the
+        //! sleep at once, but window input is not part of the wait: after
+        //! idling, the first input may lag up to this long. Longer waits
+        //! cost less CPU when idle, shorter ones make the window snappier.
+        void idleWait(const int& ms);
+
+        //! Draws the interface and the scene(s).
+        int draw(cat::context&);
         
     private:
         
@@ -88,6 +115,16 @@ namespace cat {
         
         //! Main window startup height.
         int _winHeight;
+
+        //! No window, no display needed.
+        bool _headless;
+
+        //! Frames still to be redrawn (0 = idle).
+        int _redraw;
+
+        //! Longest idle sleep, between two checks of the application state
+        //! (250 ms by default, see idleWait()).
+        sf::Time _idleWait;
             
     };
 